@@ -300,7 +300,10 @@ private:
     void annotate_(const std::vector<AccurateMassSearchResult>&, BaseFeature&) const;
 
     /// Extract query results from feature
-    std::vector<AccurateMassSearchResult> extractQueryResults_(const Feature& feature, const Size& feature_index, const String& ion_mode_internal, Size& dummy_count) const;
+    std::vector<AccurateMassSearchResult> extractQueryResults_(const Feature& feature, const Size& feature_index, const String& ion_mode_internal) const;
+
+    /// Query all features of @p fmap (in parallel, if OpenMP is enabled); the result contains one (possibly empty) entry per feature
+    std::vector<std::vector<AccurateMassSearchResult> > extractQueryResults_(const FeatureMap& fmap, const String& ion_mode_internal) const;
 
     /// Add resulting matches to IdentificationData
     void addMatchesToID_(
@@ -328,11 +331,22 @@ private:
     typedef std::vector<std::vector<String> > MassIDMapping;
     typedef std::map<String, std::vector<String> > HMDBPropsMapping;
 
+    /// Compact element composition of a formula, sorted by element
+    typedef std::vector<std::pair<const Element*, SignedSize> > ElementCounts_;
+
+    /// Element composition of @p ef as ElementCounts_
+    static ElementCounts_ toElementCounts_(const EmpiricalFormula& ef);
+
+    /// Same as EmpiricalFormula::contains(), i.e. true if @p formula has at least as many atoms of each element as @p required
+    static bool containsElements_(const ElementCounts_& formula, const ElementCounts_& required);
+
     struct MappingEntry_
     {
       double mass;
       std::vector<String> massIDs;
       String formula;
+      ElementCounts_ element_counts; ///< parsed @p formula (only valid if has_element_counts is true)
+      bool has_element_counts = false; ///< false if @p formula could not be parsed at load time
     };
     std::vector<MappingEntry_> mass_mappings_;
 
@@ -377,6 +391,10 @@ private:
     std::vector<AdductInfo> pos_adducts_;
     std::vector<AdductInfo> neg_adducts_;
 
+    /// Atoms a DB entry needs to have to be compatible with the adduct at the same position in pos_adducts_/neg_adducts_ (see AdductInfo::isCompatible())
+    std::vector<ElementCounts_> pos_adducts_required_;
+    std::vector<ElementCounts_> neg_adducts_required_;
+
     String database_name_;
     String database_version_;
     String database_location_;
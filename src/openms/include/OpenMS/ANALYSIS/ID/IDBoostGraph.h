@@ -537,6 +537,9 @@ namespace OpenMS
     //vertex_t addVertexWithLookup_(IDPointerConst& ptr, std::unordered_map<IDPointerConst, vertex_t, boost::hash<IDPointerConst>>& vertex_map);
 
 
+    /// indices of the connected components, ordered by decreasing estimated cost of processing them (edges + vertices)
+    std::vector<Size> getCCsOrderedByCost_() const;
+
     /// internal function to annotate the underlying ID structures based on the given Graph
     void annotateIndistProteins_(const Graph& fg, bool addSingletons);
     void calculateAndAnnotateIndistProteins_(const Graph& fg, bool addSingletons);
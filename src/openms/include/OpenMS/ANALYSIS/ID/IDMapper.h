@@ -136,6 +136,10 @@ public:
       If several consensus features lie inside the allowed deviation, the peptide identifications
       are mapped to all the consensus features.
 
+      Candidate consensus features are looked up in an RT x m/z grid of the centroids (or
+      subelements), and the peptide identifications are matched in parallel. The result does
+      not depend on the number of threads.
+
       @param map ConsensusMap to receive the identifications
       @param ids PeptideIdentification for the ConsensusFeatures
       @param protein_ids ProteinIdentification for the ConsensusMap
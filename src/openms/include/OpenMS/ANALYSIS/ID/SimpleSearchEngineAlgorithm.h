@@ -36,6 +36,7 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
 #include <OpenMS/CHEMISTRY/ModifiedPeptideGenerator.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/DATASTRUCTURES/StringView.h>
 
@@ -43,6 +44,7 @@
 
 namespace OpenMS
 {
+class ProteaseDigestion;
 
 class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
   public DefaultParamHandler,
@@ -90,6 +92,60 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
       }
     };
 
+    /// Modified peptide in the fragment index (the AASequence is only recreated for the candidates of a spectrum)
+    struct IndexedPeptide_
+    {
+      UInt32 sequence_index; ///< index of the unmodified peptide in FragmentIndex_::sequences
+      UInt32 peptide_mod_index; ///< enumeration index of the peptide modification
+      double mass; ///< monoisotopic mass of the modified peptide
+    };
+
+    /// Fragment ion in the fragment index
+    struct IndexedFragment_
+    {
+      float mz; ///< m/z of the singly charged fragment
+      UInt32 peptide_index; ///< index of the peptide in FragmentIndex_::peptides
+    };
+
+    /**
+      @brief Fragment ion index of all (modified) candidate peptides of the database
+
+      The peptides are sorted by mass and partitioned into consecutive slices
+      of fragment_index_slice_size_ peptides. The fragments of each slice are
+      sorted by m/z, so the fragments of all peptides in a precursor mass window
+      are found by one binary search per slice and observed peak.
+    */
+    struct FragmentIndex_
+    {
+      std::vector<StringView> sequences; ///< unique unmodified peptides of the database (sorted)
+      std::vector<IndexedPeptide_> peptides; ///< sorted by mass
+      std::vector<IndexedFragment_> fragments; ///< sorted by m/z within each slice
+      std::vector<Size> slice_begin; ///< first fragment of each slice (the last entry is the end of the last slice)
+    };
+
+    /// @brief digest the database into its unique peptide sequences (skipping peptides with ambiguous amino acids or without the peptide motif)
+    /// @return the number of digested peptides before removing duplicates
+    Size digestDatabase_(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const ProteaseDigestion& digestor,
+      std::vector<StringView>& peptides) const;
+
+    /// @brief keep only the @p top_hits best hits per spectrum in @p hits (pairs of scan index and hit, sorted by scan index afterwards)
+    static void keepTopHitsPerSpectrum_(std::vector<std::pair<Size, AnnotatedHit_> >& hits, Size top_hits);
+
+    /// @brief digest and modify the database and build the fragment index of the resulting peptides
+    void buildFragmentIndex_(const std::vector<FASTAFile::FASTAEntry>& fasta_db,
+      const ProteaseDigestion& digestor,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      FragmentIndex_& index) const;
+
+    /// @brief score the peptides with the most matching fragments in the index against each spectrum
+    void searchFragmentIndex_(const FragmentIndex_& index,
+      const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+      const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+      const PeakMap& spectra,
+      std::vector<std::vector<AnnotatedHit_> >& annotated_hits) const;
+
     /// @brief filter, deisotope, decharge spectra
     static void preprocessSpectra_(PeakMap& exp, double fragment_mass_tolerance, bool fragment_mass_tolerance_unit_ppm);
 
@@ -146,6 +202,13 @@ class OPENMS_DLLAPI SimpleSearchEngineAlgorithm :
     String peptide_motif_;
 
     Size report_top_hits_;
+
+    bool fragment_index_;
+    Size fragment_index_min_matched_peaks_;
+    Size fragment_index_candidates_;
+
+    /// Number of peptides per slice of the fragment index
+    static constexpr Size fragment_index_slice_size_ = 1024;
 };
 
 } // namespace
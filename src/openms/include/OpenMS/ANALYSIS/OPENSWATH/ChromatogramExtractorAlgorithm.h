@@ -99,6 +99,17 @@ public:
      * @param im_extraction_window Full window width (i.e. twice the tolerance) for IM extraction. Must be positive.
      * @param filter Which function to apply in m/z space (currently "tophat" only)
      *
+     * @note Coordinates with an RT window are only visited for spectra inside
+     * that window (an active set is swept along RT), so the cost per spectrum
+     * scales with the number of coordinates actually extracted. This works
+     * best if the spectra are sorted by RT; unsorted input is still handled
+     * correctly.
+     *
+     * @note If called outside of a parallel region and OpenMP is enabled, the
+     * spectra are split into consecutive blocks which are extracted in
+     * parallel (each thread uses a lightClone() of @p input). The result is
+     * identical to the serial extraction.
+     *
     */
     void extractChromatograms(const OpenSwath::SpectrumAccessPtr input,
         std::vector< OpenSwath::ChromatogramPtr >& output,
@@ -183,8 +194,41 @@ public:
 
 private:
 
+    /// A single extracted data point of the chromatogram of a coordinate
+    struct ExtractedPoint_
+    {
+      Size coordinate; ///< index of the extraction coordinate
+      double rt;
+      double intensity;
+    };
+
+    /**
+     * @brief Extract all coordinates from the spectra [scan_begin, scan_end) of @p input.
+     *
+     * The extracted data points are either appended to @p output directly (if
+     * @p buffer is a null pointer) or to @p buffer in the order in which they
+     * would have been appended to @p output. Progress is only reported if
+     * @p progress_factor is positive (the scan index is multiplied by it).
+    */
+    void extractSpectrumRange_(OpenSwath::ISpectrumAccess& input,
+                               const Size scan_begin,
+                               const Size scan_end,
+                               std::vector< OpenSwath::ChromatogramPtr >& output,
+                               std::vector<ExtractedPoint_>* buffer,
+                               const std::vector<ExtractionCoordinates>& extraction_coordinates,
+                               const std::vector<Size>& unbounded_coordinates,
+                               const std::vector<Size>& coordinates_by_rt_start,
+                               const double mz_extraction_window,
+                               const bool ppm,
+                               const double im_extraction_window,
+                               const int used_filter,
+                               const int progress_factor);
+
     int getFilterNr_(const String& filter);
 
+    /// Minimal number of spectra a thread extracts from (fewer spectra are not worth the overhead of a separate block)
+    static constexpr Size min_spectra_per_thread_ = 50;
+
   };
 
 }
@@ -55,10 +55,13 @@ namespace OpenMS
     (ISpectrumAccess) using the CachedmzML class which is able to read and
     write a cached mzML file.
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    @note If the cached file is memory-mapped (see CachedmzML::isMemoryMapped),
+    data items are copied directly from the mapping and concurrent access from
+    multiple threads is safe; lightClone() then shares the mapping instead of
+    opening the file again. Otherwise, this implementation is @a not
+    thread-safe since it keeps internally a single file access pointer which
+    it moves when accessing a specific data item. The caller is responsible to
+    ensure that access is performed atomically (e.g. by using lightClone()).
 
   */
   class OPENMS_DLLAPI SpectrumAccessOpenMSCached :
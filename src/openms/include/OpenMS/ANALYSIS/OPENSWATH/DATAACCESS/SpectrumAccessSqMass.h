@@ -80,6 +80,17 @@ namespace OpenMS
    *   swath_maps[k].sptr = sptr;
    * @endcode
    *
+   * Alternatively, the spectra of a retention time range and/or precursor
+   * isolation window can be selected directly by the database:
+   *
+   * @code
+   *   OpenMS::Internal::MzMLSqliteHandler handler(file, 0);
+   *   std::vector<int> indices = handler.getSpectraIndicesByRange(rt_start, rt_end, 2, swath_lower, swath_upper);
+   *   OpenSwath::SpectrumAccessPtr sptr(new OpenMS::SpectrumAccessSqMass(handler, indices));
+   * @endcode
+   *
+   * getAllSpectra() reads and decompresses the spectra in parallel.
+   *
    *
   */
   class OPENMS_DLLAPI SpectrumAccessSqMass :
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <OpenMS/ANALYSIS/OPENSWATH/DIAPrescoring.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 
@@ -76,6 +77,13 @@ namespace OpenMS
     interface. Transitions are expected to be in the light transition format
     (defined in OPENSWATHALGO/DATAACCESS/TransitionExperiment.h).
 
+    When many peak groups of the same transitions are scored (e.g. all peak
+    groups of a transition group), the transitions can be converted once into
+    a flat TransitionData object using prepareTransitionData(). This holds the
+    transitions indexed by their position together with their theoretical
+    isotope patterns, which then do not need to be recomputed for every peak
+    group.
+
   @htmlinclude OpenMS_DIAScoring.parameters
 
   */
@@ -92,6 +100,25 @@ namespace OpenMS
 
 public:
 
+    /**
+      @brief Flat (struct-of-arrays) representation of a set of transitions
+
+      All arrays are indexed by the position of the transition in the vector
+      passed to prepareTransitionData(). The isotope patterns are the
+      averagine isotope distributions of the fragments, scaled to a maximum
+      of 1, with nr_isotopes consecutive entries per transition.
+
+      The data depends on the parameters of the DIAScoring object that
+      prepared it and must only be used with the same transitions.
+    */
+    struct TransitionData
+    {
+      std::vector<double> product_mz; ///< product m/z of each transition
+      std::vector<int> fragment_charge; ///< fragment charge of each transition (1 if not annotated)
+      std::vector<double> isotope_patterns; ///< theoretical isotope pattern of transition k at [k * nr_isotopes, (k + 1) * nr_isotopes)
+      Size nr_isotopes = 0; ///< number of isotopes per pattern
+    };
+
     ///@name Constructors and Destructor
     //@{
     /// Default constructor
@@ -113,6 +140,22 @@ public:
                             double& isotope_corr,
                             double& isotope_overlap) const;
 
+    /**
+      @brief Isotope scores using precomputed transition data
+
+      Computes the same scores as the overload above, but uses the isotope
+      patterns of @p transition_data instead of computing them for each call.
+
+      @param transitions The transitions (only used to retrieve the transition intensities from @p mrmfeature)
+      @param transition_data Flat data of @p transitions, see prepareTransitionData()
+    */
+    void dia_isotope_scores(const std::vector<TransitionType>& transitions,
+                            const TransitionData& transition_data,
+                            SpectrumPtrType spectrum,
+                            OpenSwath::IMRMFeature* mrmfeature,
+                            double& isotope_corr,
+                            double& isotope_overlap) const;
+
     /// Massdiff scores, see class description
     void dia_massdiff_score(const std::vector<TransitionType>& transitions,
                             SpectrumPtrType spectrum,
@@ -150,6 +193,10 @@ public:
                              double& manhattan) const;
     //@}
 
+    /// Convert @p transitions into flat, index-based data (including their theoretical isotope patterns)
+    void prepareTransitionData(const std::vector<TransitionType>& transitions,
+                               TransitionData& transition_data) const;
+
 private:
 
     /// Copy constructor (algorithm class)
@@ -162,17 +209,17 @@ private:
     void updateMembers_() override;
 
     /// Subfunction of dia_isotope_scores
-    void diaIsotopeScoresSub_(const std::vector<TransitionType>& transitions,
+    void diaIsotopeScoresSub_(const TransitionData& transition_data,
                               SpectrumPtrType spectrum,
-                              std::map<std::string, double>& intensities,
+                              const std::vector<double>& intensities,
                               double& isotope_corr,
                               double& isotope_overlap) const;
 
     /// retrieves intensities from MRMFeature
-    /// computes a vector of relative intensities for each feature (output to intensities)
+    /// computes a vector of relative intensities for each feature (output to intensities, in the order of @p transitions)
     void getFirstIsotopeRelativeIntensities_(const std::vector<TransitionType>& transitions,
                                             OpenSwath::IMRMFeature* mrmfeature,
-                                            std::map<std::string, double>& intensities //experimental intensities of transitions
+                                            std::vector<double>& intensities //experimental intensities of transitions
                                             ) const;
 
 private:
@@ -194,18 +241,6 @@ private:
     */
     void largePeaksBeforeFirstIsotope_(SpectrumPtrType spectrum, double mono_mz, double mono_int, int& nr_occurrences, double& max_ratio) const;
 
-    /**
-      @brief Compare an experimental isotope pattern to a theoretical one
-
-      This function will take an array of isotope intensities @p isotopes_int and compare them
-      (by order only; no m/z matching) to the theoretically expected ones for the given @p product_mz using an averagine
-      model. The returned value is a Pearson correlation between the
-      experimental and theoretical pattern.
-    */
-    double scoreIsotopePattern_(const std::vector<double>& isotopes_int,
-                                double product_mz,
-                                int putative_fragment_charge) const;
-
     /**
     @brief Compare an experimental isotope pattern to a theoretical one
 
@@ -226,6 +261,19 @@ private:
     double scoreIsotopePattern_(const std::vector<double>& isotopes_int,
                                 const IsotopeDistribution& isotope_dist) const;
 
+    /**
+    @brief Compare an experimental isotope pattern to a theoretical one
+
+    Same as above, but the theoretical pattern (scaled to a maximum of 1 and
+    of the same length as @p isotopes_int) starts at @p theoretical_int.
+    */
+    double scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                std::vector<double>::const_iterator theoretical_int) const;
+
+    /// Append the intensities of @p isotope_dist, scaled to a maximum of 1, to @p intensities (padded with zeros or truncated to dia_nr_isotopes + 1 entries)
+    void appendScaledIsotopePattern_(const IsotopeDistribution& isotope_dist,
+                                     std::vector<double>& intensities) const;
+
     /// Get the intensities of isotopes around @p precursor_mz in experimental @p spectrum
     /// and fill @p isotopes_int.
     void getIsotopeIntysFromExpSpec_(double precursor_mz, SpectrumPtrType spectrum,
@@ -243,6 +291,9 @@ private:
     bool dia_centroided_;
 
     TheoreticalSpectrumGenerator * generator;
+
+    /// Scoring with the theoretical spectrum (see score_with_isotopes), kept to avoid setting it up for each call
+    DiaPrescore prescore_;
   };
 }
 
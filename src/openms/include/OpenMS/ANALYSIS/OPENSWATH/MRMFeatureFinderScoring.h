@@ -314,6 +314,8 @@ private:
 
     // data
     OpenSwath::SpectrumAccessPtr ms1_map_;
+    /// Added-up spectra, shared by all peak groups (and threads) scored by this object
+    boost::shared_ptr<OpenSwathSpectrumCache> spectrum_cache_;
 
   };
 }
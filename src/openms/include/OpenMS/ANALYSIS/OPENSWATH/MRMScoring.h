@@ -90,7 +90,15 @@ namespace OpenSwath
 
         /** @name Accessors */
         //@{
-        /// non-mutable access to the cross-correlation matrix
+        /**
+           @brief Non-mutable access to the cross-correlation matrix
+
+           Only the upper triangle (including the diagonal) is filled. The
+           matrix is assembled from the internal flat representation on first
+           access after initializeXCorrMatrix(), scoring does not need it.
+           Assembling the matrix is synchronized, so the method may be called
+           concurrently on the same object.
+        */
         const XCorrMatrixType& getXCorrMatrix() const;
         //@}
 
@@ -273,10 +281,29 @@ namespace OpenSwath
         //@}
 
     private:
+        /**
+           @brief Computes the cross-correlations of all pairs of traces for the cross-correlation matrix
+
+           The @p n_traces traces of length @p trace_length are stored
+           consecutively in @p traces and need to be standardized. Fills
+           xcorr_flat_, xcorr_matrix_max_peak_ and xcorr_matrix_max_peak_sec_
+           with the same values as Scoring::normalizedCrossCorrelationPost()
+           would produce.
+        */
+        void computeXCorrMatrix_(const std::vector<double>& traces, std::size_t n_traces, std::size_t trace_length);
+
         /** @name Members */
         //@{
-        /// the precomputed cross correlation matrix
-        XCorrMatrixType xcorr_matrix_;
+        /// the precomputed cross correlation matrix (assembled from xcorr_flat_ on request)
+        mutable XCorrMatrixType xcorr_matrix_;
+        /// whether xcorr_matrix_ reflects xcorr_flat_
+        mutable bool xcorr_matrix_valid_ = true;
+
+        /// cross-correlations of all pairs (i <= j) of traces, one block of 2 * trace length + 1 lags per pair
+        std::vector<double> xcorr_flat_;
+        /// number of traces and trace length in xcorr_flat_
+        std::size_t xcorr_flat_traces_ = 0;
+        std::size_t xcorr_flat_length_ = 0;
 
         /// contains max Peaks from xcorr_matrix_
         OpenMS::Matrix<int> xcorr_matrix_max_peak_;
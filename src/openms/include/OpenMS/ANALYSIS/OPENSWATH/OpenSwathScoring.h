@@ -34,6 +34,8 @@
 
 #pragma once
 
+#include <OpenMS/CONCEPT/Types.h>
+
 // data access
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/DataStructures.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
@@ -45,12 +47,84 @@
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathScores.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
 
 namespace OpenMS
 {
+  /** @brief A thread-safe LRU cache of added-up (summed / resampled) spectra
+   *
+   * Adding up spectra around a feature apex is one of the most expensive
+   * steps of DIA scoring, and peak groups eluting close to each other in the
+   * same SWATH map request the very same spectra. This cache stores the
+   * result of an addition, keyed by the map, the index of the spectrum
+   * closest to the apex, the number of spectra added and the drift time
+   * window, so it can be reused across peak groups and scoring threads.
+   *
+   * Cached spectra are shared between all callers and must not be modified.
+   * The cache does not know how spectra were added up, so it should only be
+   * shared between OpenSwathScoring objects initialized with the same
+   * spectrum addition settings.
+   *
+   * Entries only hold a weak reference to their map: entries of a map that
+   * has been destroyed are never returned.
+  */
+  class OPENMS_DLLAPI OpenSwathSpectrumCache
+  {
+  public:
+
+    /// Constructor, @p capacity is the maximal number of spectra kept in the cache
+    explicit OpenSwathSpectrumCache(Size capacity = 128);
+
+    /**
+     * @brief Look up an added-up spectrum
+     *
+     * @return The cached spectrum (which is marked as most recently used) or a null pointer if none is present
+    */
+    OpenSwath::SpectrumPtr get(const OpenSwath::SpectrumAccessPtr& swath_map,
+                               int spectrum_idx,
+                               int nr_spectra_to_add,
+                               double drift_lower,
+                               double drift_upper);
+
+    /// Store an added-up spectrum, evicting the least recently used one if the cache is full
+    void insert(const OpenSwath::SpectrumAccessPtr& swath_map,
+                int spectrum_idx,
+                int nr_spectra_to_add,
+                double drift_lower,
+                double drift_upper,
+                const OpenSwath::SpectrumPtr& spectrum);
+
+    /// Number of spectra currently in the cache
+    Size size() const;
+
+    /// Remove all spectra from the cache
+    void clear();
+
+  private:
+
+    typedef std::tuple<const void*, int, int, double, double> Key_;
+
+    struct Entry_
+    {
+      Key_ key;
+      boost::weak_ptr<OpenSwath::ISpectrumAccess> swath_map;
+      OpenSwath::SpectrumPtr spectrum;
+    };
+
+    Size capacity_;
+    /// Entries ordered from most to least recently used
+    std::list<Entry_> entries_;
+    std::map<Key_, std::list<Entry_>::iterator> index_;
+    mutable std::mutex mutex_;
+  };
+
   /** @brief A class that calls the scoring routines
    *
    * Use this class to invoke the individual OpenSWATH scoring routines.
@@ -67,6 +141,7 @@ namespace OpenMS
     std::string spectra_addition_method_;
     double im_drift_extra_pcnt_;
     OpenSwath_Scores_Usage su_;
+    boost::shared_ptr<OpenSwathSpectrumCache> spectrum_cache_;
 
   public:
 
@@ -94,6 +169,14 @@ namespace OpenMS
                     const OpenSwath_Scores_Usage & su,
                     const std::string& spectrum_addition_method);
 
+    /** @brief Set a cache for added-up spectra (may be shared between scoring objects and threads)
+     *
+     * All scoring objects using the same cache need to be initialized with
+     * the same spectrum addition settings. Pass a null pointer to disable
+     * caching (the default).
+    */
+    void setSpectrumCache(boost::shared_ptr<OpenSwathSpectrumCache> cache);
+
     /** @brief Score a single peakgroup in a chromatogram using only chromatographic properties.
      *
      * This function only uses the chromatographic properties (coelution,
@@ -178,6 +261,8 @@ namespace OpenMS
      * @param mzerror_ppm m/z and mass error (in ppm) for all transitions
      * @param drift_lower Drift time lower extraction boundary
      * @param drift_upper Drift time upper extraction boundary
+     * @param drift_target Drift time target
+     * @param transition_data Flat data of @p transitions prepared by @p diascoring (optional, computed on the fly if NULL)
      *
     */
     void calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature,
@@ -190,7 +275,8 @@ namespace OpenMS
                             std::vector<double>& mzerror_ppm,
                             const double drift_lower,
                             const double drift_upper,
-                            const double drift_target);
+                            const double drift_target,
+                            const DIAScoring::TransitionData* transition_data = nullptr);
 
     /** @brief Score a single chromatographic feature using the precursor map.
      *
@@ -262,7 +348,7 @@ namespace OpenMS
      * @return Added up spectrum
      *
     */
-    OpenSwath::SpectrumPtr fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
+    OpenSwath::SpectrumPtr fetchSpectrumSwath(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                               double RT,
                                               int nr_spectra_to_add,
                                               const double drift_lower,
@@ -40,6 +40,7 @@
 #include <OpenMS/FORMAT/FASTAFile.h>
 #include <OpenMS/CHEMISTRY/EnzymaticDigestion.h>
 #include <OpenMS/CHEMISTRY/ModifiedPeptideGenerator.h>
+#include <functional>
 #include <numeric>
 
 namespace OpenMS
@@ -111,6 +112,28 @@ namespace OpenMS
        */
       static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>&  peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, std::vector< int >& precursor_correction_positions, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm);
 
+      /**
+       * @brief Enumerates precursor masses for all candidates in an XL-MS search and passes them on in batches
+
+          Enumerates the same candidates as the other overload, for each precursor mass in the order: loop-links, mono-links
+          (for each mono-link mass), cross-links (ordered by alpha, then beta peptide). Beta peptides of cross-links are found by
+          binary search for the masses compatible with the precursor mass, and the candidate pairs are generated in parallel.
+          Only one batch of candidates is kept in memory at a time, so the memory use does not depend on the total number of candidates.
+
+       * @param peptides The peptides with precomputed masses from the digestDatabase function
+       * @param cross_link_mass_light Mass of the cross-linker, only the light one if a labeled linker is used
+       * @param cross_link_mass_mono_link A list of possible masses for the cross-link, if it is attached to a peptide on one side
+       * @param cross_link_residue1 A list of residues, to which the first side of the linker can react
+       * @param cross_link_residue2 A list of residues, to which the second side of the linker can react
+       * @param spectrum_precursors A vector of all MS2 precursor masses of the searched spectra. Used to filter out candidates.
+       * @param precursor_mass_tolerance The precursor mass tolerance
+       * @param precursor_mass_tolerance_unit_ppm The unit of the precursor mass tolerance ("Da" or "ppm")
+       * @param batch_size The number of candidates per batch (a batch is only larger if a single alpha peptide has more beta candidates)
+       * @param consumer Called for every batch with the candidates and the positions of the precursor masses (in @p spectrum_precursors) they fit to.
+                         The consumer may modify both vectors, they are cleared afterwards.
+       */
+      static void enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(std::vector<OPXLDataStructs::XLPrecursor>&, std::vector< int >&)>& consumer);
+
       /**
        * @brief Digests a database with the given EnzymaticDigestion settings and precomputes masses for all peptides
 
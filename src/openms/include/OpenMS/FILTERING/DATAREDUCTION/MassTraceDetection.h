@@ -40,6 +40,8 @@
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 
+#include <boost/dynamic_bitset_fwd.hpp>
+
 namespace OpenMS
 {
 
@@ -65,6 +67,13 @@ namespace OpenMS
       length as well as having the minimal sample rate criterion fulfilled) get
       added to the result.
 
+      The extension of several apices is computed in parallel (if OpenMP is
+      enabled) on a read-only snapshot of the already assigned peaks. The
+      resulting traces are accepted in order of decreasing apex intensity and a
+      trace is extended again if one of its peaks was taken by a more intense
+      trace in the meantime. Hence, the result is identical to the serial
+      extension and independent of the number of threads.
+
       @htmlinclude OpenMS_MassTraceDetection.parameters
 
       @ingroup Quantitation
@@ -106,18 +115,52 @@ namespace OpenMS
         {
           Apex(double intensity, Size scan_idx, Size peak_idx);
           double intensity;
-          Size scan_idx;
-          Size peak_idx;
+          Size scan_idx; ///< index of the spectrum
+          Size peak_idx; ///< index of the peak in the PeakView_ (not in the spectrum)
+        };
+
+        /// Flat (structure of arrays) view of all MS1 peaks above the noise threshold, spectrum by spectrum
+        struct PeakView_
+        {
+          std::vector<double> mz; ///< m/z of all peaks
+          std::vector<float> intensity; ///< intensity of all peaks
+          std::vector<float> fwhm; ///< FWHM (in ppm) of all peaks (empty if not annotated in the input)
+          std::vector<double> rt; ///< retention time of each spectrum
+          std::vector<Size> spec_offsets; ///< index of the first peak of each spectrum (plus the total number of peaks)
+
+          /// Number of spectra
+          Size numSpectra() const
+          {
+            return rt.size();
+          }
+        };
+
+        /// A mass trace extended from a single apex, before it is accepted
+        struct TraceCandidate_
+        {
+          /// (spectrum index, peak index) of the peaks gathered while moving down in RT (in order of decreasing RT)
+          std::vector<std::pair<Size, Size> > down;
+          /// (spectrum index, peak index) of the peaks gathered while moving up in RT (in order of increasing RT)
+          std::vector<std::pair<Size, Size> > up;
+          /// Does the trace fulfill the length and sample rate criteria?
+          bool valid = false;
         };
 
         /// The internal run method
         void run_(const std::vector<Apex>& chrom_apices,
-                  const Size peak_count,
-                  const PeakMap & work_exp,
-                  const std::vector<Size>& spec_offsets,
+                  const PeakView_& peaks,
                   std::vector<MassTrace> & found_masstraces,
                   const Size max_traces = 0);
 
+        /// Extends a mass trace from @p apex in both RT directions, ignoring peaks already marked in @p peak_visited
+        void extendTrace_(const Apex& apex,
+                          const PeakView_& peaks,
+                          const boost::dynamic_bitset<>& peak_visited,
+                          TraceCandidate_& trace) const;
+
+        /// Number of apices extended in one parallel batch (per thread)
+        static constexpr Size apices_per_thread_ = 16;
+
         // parameter stuff
         double mass_error_ppm_;
         double noise_threshold_int_;
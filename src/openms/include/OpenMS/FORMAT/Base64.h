@@ -48,6 +48,8 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
 #include <QByteArray>
@@ -166,7 +168,38 @@ private:
     };
 
     static const char encoder_[];
-    static const char decoder_[];
+
+    /**
+        @brief Encodes @p size bytes to Base64 (including padding), replaces the content of @p out
+
+        Uses SSSE3 or AVX2 if supported by the CPU (checked at runtime), otherwise a scalar implementation.
+    */
+    static void encodeBytes_(const Byte* in, Size size, String& out);
+
+    /// Returns the number of bytes encoded in the Base64 string @p in of length @p size (i.e. without padding)
+    static Size decodedSize_(const char* in, Size size);
+
+    /**
+        @brief Decodes the Base64 string @p in of length @p size and writes at most @p out_size bytes to @p out
+
+        Padding characters are decoded as zero bits, i.e. 3 bytes are written for each group
+        of 4 characters. Uses SSSE3 or AVX2 if supported by the CPU (checked at runtime),
+        otherwise a scalar implementation.
+
+        Input which contains characters outside of the Base64 alphabet (e.g. line breaks) or
+        incomplete groups is decoded by Qt instead, which skips these characters.
+
+        @return The number of bytes written
+    */
+    static Size decodeBytes_(const char* in, Size size, Byte* out, Size out_size);
+
+    /// Decodes a zlib compressed Base64 string and decompresses it (throws Exception::ConversionError on failure)
+    static QByteArray uncompressBase64_(const String& in);
+
+    /// Swaps the byte order of all @p count elements (of 4 or 8 bytes) in @p data
+    template <typename T>
+    static void endianizeInPlace_(T* data, Size count);
+
     /// Decodes a Base64 string to a vector of floating point numbers
     template <typename ToType>
     static void decodeUncompressed_(const String & in, ByteOrder from_byte_order, std::vector<ToType> & out);
@@ -217,8 +250,6 @@ private:
     const Size element_size = sizeof(FromType);
     const Size input_bytes = element_size * in.size();
     String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
@@ -277,60 +308,13 @@ private:
         throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
       }
 
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<const Byte *>(compressed.data()), compressed_length, out);
     }
     //encode without compression
     else
     {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
-    }
-
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      encodeBytes_(reinterpret_cast<const Byte *>(in.data()), input_bytes, out);
     }
-
-    out.resize(written);         //no more space is needed
   }
 
   template <typename ToType>
@@ -354,55 +338,23 @@ private:
 
     const Size element_size = sizeof(ToType);
 
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-
-    if (base64_uncompressed.isEmpty())
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-    }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
+    QByteArray base64_uncompressed = uncompressBase64_(in);
 
-    void* byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    Size buffer_size = decompressed.size();
-
-    const ToType * float_buffer = reinterpret_cast<const ToType *>(byte_buffer);
+    const Size buffer_size = base64_uncompressed.size();
     if (buffer_size % element_size != 0)
     {
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bad BufferCount?");
     }
-    
-    Size float_count = buffer_size / element_size;
-    
+
+    // copy values
+    out.resize(buffer_size / element_size);
+    std::memcpy(out.data(), base64_uncompressed.constData(), buffer_size);
+
     // change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      if (element_size == 4) // 32 bit
-      {
-        UInt32 * p = reinterpret_cast<UInt32 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize32);
-      }
-      else // 64 bit
-      {
-        UInt64 * p = reinterpret_cast<UInt64 *>(byte_buffer);
-        std::transform(p, p + float_count, p, endianize64);
-      }
+      endianizeInPlace_(out.data(), out.size());
     }
-
-    // copy values
-    out.assign(float_buffer, float_buffer + float_count);
   }
 
   template <typename ToType>
@@ -421,103 +373,22 @@ private:
       throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Malformed base64 input, length is not a multiple of 4.");
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
     const Size element_size = sizeof(ToType);
 
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    // Parse little endian data in big endian OpenMS (or other way round)
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || 
-       (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
-    {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
+    // decode directly into the output vector (padding is decoded as zero
+    // bytes, trailing bytes of an incomplete element are dropped)
+    out.resize(in.size() / 4 * 3 / element_size);
+    if (out.empty())
     {
-      offset = 0;
-      inc = 1;
+      return;
     }
+    out.resize(decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(out.data()), out.size() * element_size) / element_size);
 
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
+    // Parse little endian data in big endian OpenMS (or other way round)
+    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) ||
+       (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
-      {
-        b = 0;
-      }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
-      {
-        a = 0;
-      }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
-      {
-        b = 0;
-      }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
-      {
-        ToType * to_type = reinterpret_cast<ToType *>(&element[0]);
-        out.push_back((*to_type));
-        strcpy(element, "");
-      }
+      endianizeInPlace_(out.data(), out.size());
     }
   }
 
@@ -532,8 +403,6 @@ private:
     const Size element_size = sizeof(FromType);
     const Size input_bytes = element_size * in.size();
     String compressed;
-    Byte * it;
-    Byte * end;
     //Change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && to_byte_order == Base64::BYTEORDER_BIGENDIAN))
     {
@@ -572,60 +441,13 @@ private:
       }
 
 
-      String(compressed).swap(compressed);
-      it = reinterpret_cast<Byte *>(&compressed[0]);
-      end = it + compressed_length;
-      out.resize((Size)ceil(compressed_length / 3.) * 4);     //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<const Byte *>(compressed.data()), compressed_length, out);
     }
     //encode without compression
     else
     {
-      out.resize((Size)ceil(input_bytes / 3.) * 4);     //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte *>(&in[0]);
-      end = it + input_bytes;
-    }
-
-    Byte * to = reinterpret_cast<Byte *>(&out[0]);
-
-
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-        to[3] = '=';
-      if (padding_count > 1)
-        to[2] = '=';
-
-      to += 4;
-      written += 4;
+      encodeBytes_(reinterpret_cast<const Byte *>(in.data()), input_bytes, out);
     }
-
-    out.resize(written);         //no more space is needed
   }
 
   template <typename ToType>
@@ -652,28 +474,10 @@ private:
     Size buffer_size;
     const Size element_size = sizeof(ToType);
 
-    String decompressed;
-
-    QByteArray qt_byte_array = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    QByteArray bazip = QByteArray::fromBase64(qt_byte_array);
-    QByteArray czip;
-    czip.resize(4);
-    czip[0] = (bazip.size() & 0xff000000) >> 24;
-    czip[1] = (bazip.size() & 0x00ff0000) >> 16;
-    czip[2] = (bazip.size() & 0x0000ff00) >> 8;
-    czip[3] = (bazip.size() & 0x000000ff);
-    czip += bazip;
-    QByteArray base64_uncompressed = qUncompress(czip);
-    if (base64_uncompressed.isEmpty())
-    {
-      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-    }
-    decompressed.resize(base64_uncompressed.size());
-
-    std::copy(base64_uncompressed.begin(), base64_uncompressed.end(), decompressed.begin());
+    QByteArray base64_uncompressed = uncompressBase64_(in);
 
-    byte_buffer = reinterpret_cast<void *>(&decompressed[0]);
-    buffer_size = decompressed.size();
+    byte_buffer = reinterpret_cast<void *>(base64_uncompressed.data());
+    buffer_size = base64_uncompressed.size();
 
     //change endianness if necessary
     if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
@@ -765,132 +569,70 @@ private:
       return;
     }
 
-    Size src_size = in.size();
-    // last one or two '=' are skipped if contained
-    int padding = 0;
-    if (in[src_size - 1] == '=') padding++;
-    if (in[src_size - 2] == '=') padding++;
-
-    src_size -= padding;
-
-    UInt a;
-    UInt b;
-
-    UInt offset = 0;
-    int inc = 1;
-    UInt written = 0;
-
     const Size element_size = sizeof(ToType);
-
-    // enough for either float or double
-    char element[8] = "\x00\x00\x00\x00\x00\x00\x00";
-
-    if ((OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) || (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN))
+    const bool swap_bytes = (OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_LITTLEENDIAN) ||
+                            (!OPENMS_IS_BIG_ENDIAN && from_byte_order == Base64::BYTEORDER_BIGENDIAN);
+    const Size count = in.size() / 4 * 3 / element_size;
+    if (count == 0)
     {
-      offset = (element_size - 1);              // other endian
-      inc = -1;
-    }
-    else
-    {
-      offset = 0;
-      inc = 1;
+      return;
     }
 
-    //reserve enough space in the output vector
-    out.reserve((UInt)(std::ceil((4.0 * src_size) / 3.0) + 6.0));
-
-    // sort all read bytes correctly into a char[4] (double) or
-    // char[8] (float) and push_back when necessary.
-    for (Size i = 0; i < src_size; i += 4)
+    // integers of the same size can be decoded directly into the output vector
+    if (std::is_integral<ToType>::value)
     {
-
-      // decode 4 Base64-Chars to 3 Byte
-      // -------------------------------
-
-      // decode the first two chars
-      a = decoder_[(int)in[i] - 43] - 62;
-      b = decoder_[(int)in[i + 1] - 43] - 62;
-      if (i + 1 >= src_size)
+      out.resize(count);
+      out.resize(decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(out.data()), count * element_size) / element_size);
+      if (swap_bytes)
       {
-        b = 0;
+        endianizeInPlace_(out.data(), out.size());
       }
-      // write first byte (6 bits from a and 2 highest bits from b)
-      element[offset] = (unsigned char) ((a << 2) | (b >> 4));
-      written++;
-      offset = (offset + inc) % element_size;
+      return;
+    }
 
-      if (written % element_size == 0)
+    // otherwise decode to 32 or 64 bit integers and convert them
+    if (element_size == 4)
+    {
+      std::vector<Int32> values(count);
+      values.resize(decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(values.data()), count * element_size) / element_size);
+      if (swap_bytes)
       {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
+        endianizeInPlace_(values.data(), values.size());
       }
-
-      // decode the third char
-      a = decoder_[(int)in[i + 2] - 43] - 62;
-      if (i + 2 >= src_size)
+      out.reserve(values.size());
+      for (const Int32 value : values)
       {
-        a = 0;
+        out.push_back((ToType) value);
       }
-      // write second byte (4 lowest bits from b and 4 highest bits from a)
-      element[offset] = (unsigned char) (((b & 15) << 4) | (a >> 2));
-      written++;
-      offset = (offset + inc) % element_size;
-
-      if (written % element_size == 0)
+    }
+    else
+    {
+      std::vector<Int64> values(count);
+      values.resize(decodeBytes_(in.c_str(), in.size(), reinterpret_cast<Byte *>(values.data()), count * element_size) / element_size);
+      if (swap_bytes)
       {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
+        endianizeInPlace_(values.data(), values.size());
       }
-
-      // decode the fourth char
-      b = decoder_[(int)in[i + 3] - 43] - 62;
-      if (i + 3 >= src_size)
+      out.reserve(values.size());
+      for (const Int64 value : values)
       {
-        b = 0;
+        out.push_back((ToType) value);
       }
-      // write third byte (2 lowest bits from a and 6 bits from b)
-      element[offset] = (unsigned char) (((a & 3) << 6) | b);
-      written++;
-      offset = (offset + inc) % element_size;
+    }
+  }
 
-      if (written % element_size == 0)
-      {
-        ToType float_value;
-        if (element_size == 4)
-        {
-          Int32 * value = reinterpret_cast<Int32 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        else
-        {
-          Int64 * value = reinterpret_cast<Int64 *>(&element[0]);
-          float_value = (ToType) * value;
-        }
-        out.push_back(float_value);
-        strcpy(element, "");
-      }
+  template <typename T>
+  void Base64::endianizeInPlace_(T* data, Size count)
+  {
+    if (sizeof(T) == 4)
+    {
+      UInt32 * p = reinterpret_cast<UInt32 *>(data);
+      std::transform(p, p + count, p, endianize32);
+    }
+    else
+    {
+      UInt64 * p = reinterpret_cast<UInt64 *>(data);
+      std::transform(p, p + count, p, endianize64);
     }
   }
 
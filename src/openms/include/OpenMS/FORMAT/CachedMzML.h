@@ -37,6 +37,15 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 
 #include <fstream>
+#include <memory>
+
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
 
 namespace OpenMS
 {
@@ -49,6 +58,11 @@ namespace OpenMS
     be very fast and done in random order (once the in-memory index is built
     for the file).
 
+    If possible, the cached file is memory-mapped and data items are copied
+    directly from the mapping (which is shared between copies of the object).
+    Otherwise, a file stream is used which is moved to the position of the
+    requested data item.
+
   */
   class OPENMS_DLLAPI CachedmzML
   {
@@ -83,6 +97,12 @@ public:
       return meta_ms_experiment_;
     }
 
+    /// Whether the data is read from a memory-mapped file (otherwise from a file stream)
+    bool isMemoryMapped() const
+    {
+      return mapped_file_ != nullptr;
+    }
+
     /**
       @brief Stores a map in a cached MzML file.
 
@@ -108,12 +128,18 @@ protected:
 
     void load_(const String& filename);
 
+    /// Returns the start of the data item at position @p pos in the mapped file and the number of bytes following it
+    const char* getMappedData_(std::streampos pos, Size& available) const;
+
     /// Meta data
     MSExperiment meta_ms_experiment_;
 
-    /// Internal filestream 
+    /// Internal filestream (only used if the file could not be memory-mapped)
     std::ifstream ifs_;
 
+    /// Memory-mapped cached file (shared between copies, null if the file could not be mapped)
+    std::shared_ptr<const boost::iostreams::mapped_file_source> mapped_file_;
+
     /// Name of the mzML file
     String filename_;
 
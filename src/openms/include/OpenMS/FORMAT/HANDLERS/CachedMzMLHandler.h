@@ -183,6 +183,28 @@ public:
       @throws Exception::ParseError is thrown if the chromatogram size cannot be read
     */
     static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(std::ifstream& ifs);
+
+    /**
+      @brief Fast access to a spectrum stored in memory (e.g. in a memory-mapped cached file)
+
+      @param data Start of the spectrum (i.e. start of the file plus the position from the spectra index)
+      @param data_size Number of bytes which can be read from @p data onwards
+      @param ms_level Output parameter to store the MS level of the spectrum (1, 2, 3 ...)
+      @param rt Output parameter to store the retention time of the spectrum
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read (e.g. it exceeds @p data_size)
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* data, Size data_size, int& ms_level, double& rt);
+
+    /**
+      @brief Fast access to a chromatogram stored in memory (e.g. in a memory-mapped cached file)
+
+      @param data Start of the chromatogram (i.e. start of the file plus the position from the chromatogram index)
+      @param data_size Number of bytes which can be read from @p data onwards
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read (e.g. it exceeds @p data_size)
+    */
+    static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* data, Size data_size);
     //@}
 
     /**
@@ -205,6 +227,28 @@ public:
     */
     static void readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs);
 
+    /**
+      @brief Read a single spectrum stored in memory directly into an OpenMS MSSpectrum
+
+      @param spectrum Output spectrum
+      @param data Start of the spectrum (i.e. start of the file plus the position from the spectra index)
+      @param data_size Number of bytes which can be read from @p data onwards
+
+      @throws Exception::ParseError is thrown if the spectrum cannot be read
+    */
+    static void readSpectrum(SpectrumType& spectrum, const char* data, Size data_size);
+
+    /**
+      @brief Read a single chromatogram stored in memory directly into an OpenMS MSChromatogram
+
+      @param chromatogram Output chromatogram
+      @param data Start of the chromatogram (i.e. start of the file plus the position from the chromatogram index)
+      @param data_size Number of bytes which can be read from @p data onwards
+
+      @throws Exception::ParseError is thrown if the chromatogram cannot be read
+    */
+    static void readChromatogram(ChromatogramType& chromatogram, const char* data, Size data_size);
+
 protected:
 
     /// write a single spectrum to filestream
@@ -217,6 +261,12 @@ protected:
     static inline void readDataFast_(std::ifstream& ifs, std::vector<OpenSwath::BinaryDataArrayPtr>& data, const Size& data_size, 
       const Size& nr_float_arrays);
 
+    /// helper method to copy the data arrays of a spectrum (as returned by readSpectrumFast) into an MSSpectrum
+    static void fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt);
+
+    /// helper method to copy the data arrays of a chromatogram (as returned by readChromatogramFast) into an MSChromatogram
+    static void fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data);
+
     /// Members
     std::vector<std::streampos> spectra_index_;
     std::vector<std::streampos> chrom_index_;
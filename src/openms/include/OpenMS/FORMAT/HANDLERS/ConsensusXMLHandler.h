@@ -43,6 +43,7 @@
 #include <OpenMS/METADATA/PeptideIdentification.h>
 #include <unordered_map>
 #include <map>
+#include <vector>
 
 namespace OpenMS
 {
@@ -83,8 +84,26 @@ public:
     /// Docu in base class XMLHandler::writeTo
     void writeTo(std::ostream& os) override;
 
+    /// Parsing state needed for the consensus elements of a block of a split document (see XMLFile::SplitDocument)
+    struct SplitContext
+    {
+      /// Map from file xs:id to identification run identifier
+      std::map<String, String> id_identifier;
+      /// Map from protein id to accession
+      std::map<String, String> proteinid_to_accession;
+    };
+
+    /// Returns the parsing states recorded for the blocks of a split document (indexed by block)
+    const std::vector<SplitContext>& getSplitContexts() const;
+
+    /// Sets the parsing state before a chunk of a split document is parsed
+    void setSplitContext(const SplitContext& context);
+
 protected:
 
+    // Docu in base class
+    void splitBlock_(Size block) override;
+
     // Docu in base class
     void endElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname) override;
 
@@ -143,6 +162,9 @@ protected:
     ProteinIdentification::SearchParameters search_param_;
 
     UInt progress_;
+
+    /// Parsing states of the blocks of a split document
+    std::vector<SplitContext> split_contexts_;
   };
 } // namespace Internal
 } // namespace OpenMS
@@ -45,6 +45,7 @@
 
 #include <iosfwd>
 #include <map>
+#include <vector>
 
 namespace OpenMS
 {
@@ -107,8 +108,26 @@ public:
       return expected_size_;
     }
 
+    /// Parsing state needed for the features of a block of a split document (see XMLFile::SplitDocument)
+    struct SplitContext
+    {
+      /// Map from file xs:id to identification run identifier
+      std::map<String, String> id_identifier;
+      /// Map from protein id to accession
+      std::map<String, String> proteinid_to_accession;
+    };
+
+    /// Returns the parsing states recorded for the blocks of a split document (indexed by block)
+    const std::vector<SplitContext>& getSplitContexts() const;
+
+    /// Sets the parsing state before a chunk of a split document is parsed
+    void setSplitContext(const SplitContext& context);
+
 protected:
 
+    // Docu in base class
+    void splitBlock_(Size block) override;
+
     // restore default state for next load/store operation
     void resetMembers_();
 
@@ -190,6 +209,8 @@ protected:
     /// Temporary search parameters file
     ProteinIdentification::SearchParameters search_param_;
 
+    /// Parsing states of the blocks of a split document
+    std::vector<SplitContext> split_contexts_;
   };
 
 } // namespace Internal
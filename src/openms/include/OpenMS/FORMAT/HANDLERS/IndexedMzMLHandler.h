@@ -44,8 +44,17 @@
 
 #include <string>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 
+namespace boost
+{
+  namespace iostreams
+  {
+    class mapped_file_source;
+  }
+}
+
 namespace OpenMS
 {
 
@@ -70,10 +79,17 @@ namespace Internal
     extracting all the offsets of the <chromatogram> and <spectrum> tags. These
     offsets are stored as members of this class as well as the offset to the <indexList> element
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. The caller is responsible to ensure that access is performed
-    atomically.
+    If possible, the file is memory-mapped and the data items are read
+    directly from the mapping, which is shared between copies of this
+    object. In that case, retrieving spectra and chromatograms does not modify
+    any internal state and concurrent access from multiple threads is safe
+    (see isMemoryMapped()).
+
+    @note If the file could not be memory-mapped, this implementation is @a
+    not thread-safe since it keeps internally a single file access pointer
+    which it moves when accessing a specific data item. The caller is
+    responsible to ensure that access is performed atomically (e.g. by
+    providing a separate copy to each thread).
 
   */
   class OPENMS_DLLAPI IndexedMzMLHandler
@@ -92,8 +108,10 @@ namespace Internal
     std::streampos index_offset_;
     /// Whether spectra are written before chromatograms in this file
     bool spectra_before_chroms_;
-    /// The current filestream (opened by openFile)
+    /// The current filestream (opened by openFile, only used if the file could not be memory-mapped)
     std::ifstream filestream_;
+    /// The memory-mapped file (opened by openFile, shared between copies, null if the file could not be mapped)
+    std::shared_ptr<const boost::iostreams::mapped_file_source> mapped_file_;
     /// Whether parsing the indexedmzML file was successful
     bool parsing_success_;
     /// Whether to skip XML checks
@@ -113,6 +131,9 @@ namespace Internal
 
     std::string getSpectrumById_helper_(int id);
 
+    /// Read the text between the two file offsets (from the memory-mapped file if available)
+    std::string readText_(std::streampos startidx, std::streampos endidx);
+
     public:
 
     /**
@@ -151,6 +172,14 @@ namespace Internal
     */
     bool getParsingSuccess() const;
 
+    /**
+      @brief Returns whether the file is memory-mapped
+
+      If true, all functions retrieving spectra or chromatograms can be called
+      concurrently from multiple threads (on the same object or its copies).
+    */
+    bool isMemoryMapped() const;
+
     /// Returns the number of spectra available
     size_t getNrSpectra() const;
 
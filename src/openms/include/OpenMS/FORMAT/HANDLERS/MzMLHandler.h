@@ -49,6 +49,7 @@
 #include <OpenMS/FORMAT/ControlledVocabulary.h>
 #include <OpenMS/FORMAT/VALIDATORS/SemanticValidator.h>
 
+#include <future>
 #include <map>
 
 
@@ -175,6 +176,19 @@ public:
       /// Get the spectra and chromatogram counts of a file
       void getCounts(Size& spectra_counts, Size& chromatogram_counts);
 
+      /**
+          @brief Waits for the spectra and chromatograms which are decoded in the background (if any) and discards them
+
+          Needs to be called if parsing was aborted (e.g. by an exception), since the
+          remaining data is then never appended to the result. Errors of the background
+          decoding are re-thrown, those of the spectra first. The background batches
+          precede the current parsing position in the file, so these errors take
+          precedence over the one which aborted the parsing.
+
+          @exception Exception::ParseError if the binary data could not be decoded
+      */
+      void waitForDecoding();
+
       /**@name IMSDataConsumer setter
          @anchor consumer_a
 
@@ -220,18 +234,43 @@ protected:
           @brief Populate all spectra on the stack with data from input
 
           Will populate all spectra on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          multiple threads if available) and append them to the result. A batch
+          which is still decoded in the background is appended first.
       */
       void populateSpectraWithData_();
 
+      /**
+          @brief Populate all spectra on the stack with data from input in the background
+
+          Appends the previous background batch (if any) to the result and
+          hands the current work stack to a background task which decodes it
+          (using multiple threads if available) while XML parsing continues.
+          Thus, at most two batches of spectra are held in memory and the
+          order in which spectra are appended to the result is preserved.
+      */
+      void populateSpectraWithDataAsync_();
+
+      /// Wait for the spectra decoded in the background (if any), report their warnings and append them to the result
+      void finishSpectraDecoding_();
+
       /**
           @brief Populate all chromatograms on the stack with data from input
 
           Will populate all chromatograms on the current work stack with data (using
-          multiple threads if available) and append them to the result.
+          multiple threads if available) and append them to the result. A batch
+          which is still decoded in the background is appended first.
       */
       void populateChromatogramsWithData_();
 
+      /// Same as populateSpectraWithDataAsync_() for chromatograms
+      void populateChromatogramsWithDataAsync_();
+
+      /// Wait for the chromatograms decoded in the background (if any), report their warnings and append them to the result
+      void finishChromatogramsDecoding_();
+
+      /// Reports the warnings collected while decoding binary data (on the parsing thread, see warning())
+      void reportWarnings_(const std::vector<String>& warnings) const;
+
       /**
           @brief Add extra data arrays to a spectrum
 
@@ -254,12 +293,15 @@ protected:
           @param length The input data length (number of data points)
           @param peak_file_options Will be used if only part of the data should be copied (RT, mz or intensity range)
           @param spectrum The output spectrum
+          @param warnings Warnings about the data are appended here (to be reported by the caller)
 
+          @exception Exception::ParseError if the data is invalid
       */
       void populateSpectraWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                     Size& length,
                                     const PeakFileOptions& peak_file_options,
-                                    SpectrumType& spectrum);
+                                    SpectrumType& spectrum,
+                                    std::vector<String>& warnings) const;
 
       /**
           @brief Fill a single chromatogram with data from input
@@ -271,12 +313,15 @@ protected:
           @param length The input data length (number of data points)
           @param peak_file_options Will be used if only part of the data should be copied (RT, mz or intensity range)
           @param chromatogram The output chromatogram
+          @param warnings Warnings about the data are appended here (to be reported by the caller)
 
+          @exception Exception::ParseError if the data is invalid
       */
       void populateChromatogramsWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                           Size& length,
                                           const PeakFileOptions& peak_file_options,
-                                          ChromatogramType& chromatogram);
+                                          ChromatogramType& chromatogram,
+                                          std::vector<String>& warnings) const;
 
       /// Fills the current chromatogram with data points and meta data
       void fillChromatogramData_();
@@ -465,6 +510,12 @@ protected:
       /// Vector of spectrum data stored for later parallel processing
       std::vector<SpectrumData> spectrum_data_;
 
+      /// Decode the binary data of all spectra in @p spectrum_data (in parallel, no internal state is modified), returns the warnings in the order of the spectra
+      std::vector<String> decodeSpectra_(std::vector<SpectrumData>& spectrum_data) const;
+
+      /// Append all spectra in @p spectrum_data to the consumer / experiment and clear it
+      void appendSpectra_(std::vector<SpectrumData>& spectrum_data);
+
       /**
           @brief Data necessary to generate a single chromatogram
 
@@ -482,6 +533,21 @@ protected:
       /// Vector of chromatogram data stored for later parallel processing
       std::vector<ChromatogramData> chromatogram_data_;
 
+      /// Decode the binary data of all chromatograms in @p chromatogram_data (in parallel, no internal state is modified), returns the warnings in the order of the chromatograms
+      std::vector<String> decodeChromatograms_(std::vector<ChromatogramData>& chromatogram_data) const;
+
+      /// Append all chromatograms in @p chromatogram_data to the consumer / experiment and clear it
+      void appendChromatograms_(std::vector<ChromatogramData>& chromatogram_data);
+
+      /// Batch of spectra which is currently decoded in the background
+      std::vector<SpectrumData> spectrum_data_decoding_;
+      /// Batch of chromatograms which is currently decoded in the background
+      std::vector<ChromatogramData> chromatogram_data_decoding_;
+      /// Background decoding of spectrum_data_decoding_, returns its warnings (declared after the data so it is waited for before the data is destroyed)
+      std::future<std::vector<String> > spectrum_decoding_;
+      /// Background decoding of chromatogram_data_decoding_, returns its warnings
+      std::future<std::vector<String> > chromatogram_decoding_;
+
       //@}
       
       /**@name temporary data structures to hold written data
@@ -145,14 +145,16 @@ public:
           @param write_full_meta Whether to write a complete mzML meta data structure into the RUN_EXTRA field (allows complete recovery of the input file)
           @param use_lossy_compression Whether to use lossy compression (ms numpress)
           @param linear_abs_mass_acc Accepted loss in mass accuracy (absolute m/z, in Th)
-          @param sql_batch_size Batch size of SQL insert statements
+          @param sql_batch_size Number of spectra / chromatograms that are compressed (in parallel) before they are inserted into the database
+          @param durable_write Whether SQLite should make sure the data is on disk after each write (if false, the file may be corrupted by a crash during writing, but writing is faster)
       */
-      void setConfig(bool write_full_meta, bool use_lossy_compression, double linear_abs_mass_acc, int sql_batch_size = 500) 
+      void setConfig(bool write_full_meta, bool use_lossy_compression, double linear_abs_mass_acc, int sql_batch_size = 500, bool durable_write = true) 
       {
         write_full_meta_ = write_full_meta;
         use_lossy_compression_ = use_lossy_compression;
         linear_abs_mass_acc_ = linear_abs_mass_acc; 
         sql_batch_size_ = sql_batch_size; 
+        durable_write_ = durable_write;
       }
 
       /**
@@ -165,15 +167,42 @@ public:
       */
       std::vector<size_t> getSpectraIndicesbyRT(double RT, double deltaRT, const std::vector<int> & indices) const;
 
+      /**
+          @brief Get the indices of all spectra within a retention time range and/or precursor isolation window
+
+          The predicates are evaluated by the database on indexed columns
+          (retention time, MS level and precursor isolation target), so only
+          the matching spectra need to be read afterwards, e.g. with
+          readSpectra(). This allows to load a single RT slice or SWATH window
+          of a file.
+
+          @param rt_start Start of the retention time range
+          @param rt_end End of the retention time range (if smaller than @p rt_start, retention time is not restricted)
+          @param ms_level Only consider spectra of this MS level (if zero, all spectra are considered)
+          @param precursor_mz_start Lower bound for the precursor isolation target
+          @param precursor_mz_end Upper bound for the precursor isolation target (if smaller than @p precursor_mz_start, the precursor is not restricted)
+          @return The indices of the matching spectra in ascending order
+      */
+      std::vector<int> getSpectraIndicesByRange(double rt_start, double rt_end, int ms_level = 0,
+                                                double precursor_mz_start = 0.0, double precursor_mz_end = -1.0) const;
+
 protected:
 
-      void populateChromatogramsWithData_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms) const;
+      /**
+          @brief Fill chromatograms with their data
 
-      void populateChromatogramsWithData_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms, const std::vector<int> & indices) const;
+          The data is read and decompressed in parallel (using one read-only
+          connection per thread) if called outside of a parallel region.
 
-      void populateSpectraWithData_(sqlite3 *db, std::vector<MSSpectrum>& spectra) const;
+          @param db Connection to use for serial reading
+          @param chromatograms The chromatograms to fill
+          @param sql_ids The SQL id of each chromatogram
+          @param all_rows Whether @p sql_ids contains all chromatograms of the file
+      */
+      void populateChromatogramsWithData_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms, const std::vector<int> & sql_ids, bool all_rows = false) const;
 
-      void populateSpectraWithData_(sqlite3 *db, std::vector<MSSpectrum>& spectra, const std::vector<int> & indices) const;
+      /// Fill spectra with their data (see populateChromatogramsWithData_)
+      void populateSpectraWithData_(sqlite3 *db, std::vector<MSSpectrum>& spectra, const std::vector<int> & sql_ids, bool all_rows = false) const;
 
       void prepareChroms_(sqlite3 *db, std::vector<MSChromatogram>& chromatograms, const std::vector<int> & indices = {}) const;
 
@@ -255,6 +284,7 @@ protected:
       double linear_abs_mass_acc_; 
       double write_full_meta_; 
       int sql_batch_size_; 
+      bool durable_write_;
     };
 
 
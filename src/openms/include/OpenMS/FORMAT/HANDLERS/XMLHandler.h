@@ -385,6 +385,8 @@ public:
       void startElement(const XMLCh * const uri, const XMLCh * const localname, const XMLCh * const qname, const xercesc::Attributes & attrs) override;
       /// Parsing method for closing tags
       void endElement(const XMLCh * const uri, const XMLCh * const localname, const XMLCh * const qname) override;
+      /// Parsing method for processing instructions (forwards the block markers of split documents to splitBlock_())
+      void processingInstruction(const XMLCh * const target, const XMLCh * const data) override;
 
       /// Writes the contents to a stream.
       virtual void writeTo(std::ostream & /*os*/);
@@ -446,6 +448,14 @@ protected:
       LOADDETAIL load_detail_; 
 
 
+      /**
+        @brief Called at the position of a block of entries that was cut out of a document which is parsed in parts (see XMLFile::splitDocument_())
+
+        Handlers that support parallel loading store the parsing state that is needed to parse
+        the entries of block @p block separately. The default implementation does nothing.
+      */
+      virtual void splitBlock_(Size block);
+
       /// Returns if two Xerces strings are equal
       inline bool equal_(const XMLCh * a, const XMLCh * b) const
       {
@@ -118,6 +118,9 @@ protected:
     // Docu in base class
     void startElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname, const xercesc::Attributes& attributes) override;
 
+    // Docu in base class
+    void splitBlock_(Size block) override;
+
     /// Add data from ProteinGroups to a MetaInfoInterface
     /// Since it can be used during load and store, it needs to take a param for the current mode (LOAD/STORE)
     /// to throw appropriate warnings/errors
@@ -184,6 +187,16 @@ protected:
     String* document_id_;
     /// true if a prot id is contained in the current run
     bool prot_id_in_run_;
+    /// Parsing state needed for the peptide identifications of a block of a split document (see XMLFile::SplitDocument)
+    struct SplitContext_
+    {
+      /// Identifier of the identification run the block belongs to
+      String identifier;
+      /// Map from protein id to accession
+      std::unordered_map<std::string, String> proteinid_to_accession;
+    };
+    /// Parsing states of the blocks of a split document
+    std::vector<SplitContext_> split_contexts_;
     //@}
   };
 
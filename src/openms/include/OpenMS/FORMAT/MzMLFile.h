@@ -47,6 +47,11 @@
 
 namespace OpenMS
 {
+  namespace Internal
+  {
+    class MzMLHandler;
+  }
+
   /**
     @brief File adapter for MzML files
 
@@ -209,8 +214,8 @@ protected:
     /// Perform first pass through the file and retrieve the meta-data to initialize the consumer
     void transformFirstPass_(const String& filename_in, Interfaces::IMSDataConsumer * consumer, bool skip_full_count);
 
-    /// Safe parse that catches exceptions and handles them accordingly
-    void safeParse_(const String & filename, Internal::XMLHandler * handler);
+    /// Safe parse that catches exceptions and handles them accordingly (waits for the background decoding of @p handler in any case)
+    void safeParse_(const String & filename, Internal::MzMLHandler * handler);
 
 private:
 
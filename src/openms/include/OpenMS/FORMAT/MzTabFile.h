@@ -41,6 +41,8 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
+#include <exception>
+#include <ostream>
 #include <vector>
 
 namespace OpenMS
@@ -157,15 +159,86 @@ namespace OpenMS
     /// Generate an mzTab section comprising multiple rows of the same type and perform sanity check
     template <typename SectionRow> void generateMzTabSection_(const std::vector<SectionRow>& rows, const std::vector<String>& optional_columns, const MzTabMetaData& meta, StringList& output, size_t n_header_columns) const
     {
-      output.reserve(output.size() + rows.size() + 1);
-      for (const auto& row : rows)
+      generateMzTabSection_(rows.begin(), rows.end(), optional_columns, meta, output, n_header_columns);
+    }
+
+    /**
+      @brief Generate the lines of the section rows [@p begin, @p end) and append them to @p output (in the order of the rows)
+
+      The rows are formatted in parallel if OpenMP is enabled. If a row cannot be formatted or does
+      not match the number of header columns, the error of the first such row is thrown.
+    */
+    template <typename SectionRowIterator> void generateMzTabSection_(SectionRowIterator begin, SectionRowIterator end, const std::vector<String>& optional_columns, const MzTabMetaData& meta, StringList& output, size_t n_header_columns) const
+    {
+      const Size offset = output.size();
+      const SignedSize n_rows = std::distance(begin, end);
+      output.resize(offset + n_rows);
+      std::vector<std::exception_ptr> errors(n_rows);
+#pragma omp parallel for schedule(dynamic, 64) if (n_rows >= SignedSize(min_rows_parallel_))
+      for (SignedSize i = 0; i < n_rows; ++i)
+      {
+        try
+        {
+          size_t n_section_columns = 0;
+          output[offset + i] = generateMzTabSectionRow_(*(begin + i), optional_columns, meta, n_section_columns);
+          if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Header and content differs in columns. Please report this bug to the OpenMS developers.");
+        }
+        catch (...)
+        {
+          errors[i] = std::current_exception();
+        }
+      }
+      for (const std::exception_ptr& e : errors)
+      {
+        if (e) std::rethrow_exception(e);
+      }
+    }
+
+    /**
+      @brief Write the section rows provided by @p next_row to @p os
+
+      The rows are pulled from @p next_row (a callable <tt>bool(SectionRow&)</tt> that returns false once
+      the section is exhausted) in blocks of row_block_size_ rows. Each block is formatted (in parallel
+      if OpenMP is enabled) and written in order, so at most one block is held in memory.
+      @p write_header is called with the first row, has to write the section header and returns its
+      number of columns. Nothing is written for an empty section.
+    */
+    template <typename SectionRow, typename NextRow, typename WriteHeader> void writeMzTabSection_(NextRow next_row, WriteHeader write_header, const std::vector<String>& optional_columns, const MzTabMetaData& meta, std::ostream& os) const
+    {
+      std::vector<SectionRow> rows;
+      StringList lines;
+      SectionRow row;
+      size_t n_header_columns = 0;
+      bool first = true;
+      bool has_row = true;
+      while (has_row)
       {
-        size_t n_section_columns = 0;
-        output.push_back(generateMzTabSectionRow_(row, optional_columns, meta, n_section_columns));
-        if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Header and content differs in columns. Please report this bug to the OpenMS developers.");
+        has_row = next_row(row);
+        if (has_row)
+        {
+          if (first)
+          { // add header
+            n_header_columns = write_header(row);
+            first = false;
+          }
+          rows.push_back(std::move(row));
+        }
+        if (rows.size() == row_block_size_ || (!has_row && !rows.empty()))
+        {
+          lines.clear();
+          generateMzTabSection_(rows, optional_columns, meta, lines, n_header_columns);
+          for (const String& line : lines) { os << line << "\n"; }
+          rows.clear();
+        }
       }
     }
 
+    /// Number of section rows that are formatted together before they are written (bounds the memory used while storing)
+    static constexpr Size row_block_size_ = 16384;
+
+    /// Minimal number of section rows for which formatting is done in parallel
+    static constexpr Size min_rows_parallel_ = 256;
+
     // auxiliary functions
 
     /// Helper function for "generateMzTabSectionRow_" functions
@@ -67,6 +67,7 @@ public:
       bool write_full_meta{true}; ///< write full meta data
       bool use_lossy_numpress{false}; ///< use lossy numpress compression
       double linear_fp_mass_acc{-1}; ///< desired mass accuracy for numpress linear encoding (-1 no effect, use 0.0001 for 0.2 ppm accuracy @ 500 m/z)
+      bool durable_write{true}; ///< make sure data is on disk after each write (if false, writing is faster but a crash while writing may corrupt the file)
     };
 
     typedef MSExperiment MapType;
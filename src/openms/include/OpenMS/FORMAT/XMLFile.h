@@ -38,6 +38,11 @@
 #include <OpenMS/CONCEPT/Types.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace OpenMS
 {
   namespace Internal
@@ -73,6 +78,38 @@ public:
       ///return the version of the schema
       const String& getVersion() const;
 
+      /**
+        @brief A document that is parsed in parts (see splitDocument_())
+
+        The entries of the document are cut out in blocks of consecutive siblings and split into
+        chunks. The remaining document (the skeleton) has to be parsed first; at the position of
+        each block it contains the processing instruction <tt>&lt;?openms-split-block N?&gt;</tt>
+        (N being the index of the block), which XMLHandler forwards to XMLHandler::splitBlock_().
+        Afterwards, the chunks can be parsed independently (and in parallel) with handlers that
+        were given the parsing state of the respective block.
+      */
+      struct OPENMS_DLLAPI SplitDocument
+      {
+        /// Target of the processing instruction that marks a block in the skeleton
+        static constexpr const char* block_marker = "openms-split-block";
+
+        /// Content of the file
+        std::string buffer;
+        /// The document without the entries
+        std::string skeleton;
+        /// XML declaration of the document (empty if there is none)
+        std::string declaration;
+        /// Namespace declarations (@em xmlns attributes) of the root element, repeated on the element that wraps each chunk
+        std::string namespaces;
+        /// Byte ranges [begin, end) of the chunks in @p buffer (in document order)
+        std::vector<std::pair<Size, Size> > chunks;
+        /// Index of the block of each chunk
+        std::vector<Size> chunk_blocks;
+
+        /// Returns a well-formed document which contains the entries of chunk @p index, wrapped into an element that is unknown to the handlers (and declares the namespaces of the root element)
+        std::string getChunkDocument(Size index) const;
+      };
+
 protected:
       /**
         @brief Parses the XML file given by @p filename using the handler given by @p handler.
@@ -91,6 +128,47 @@ protected:
       */
       void parseBuffer_(const std::string & buffer, XMLHandler * handler);
 
+      /**
+        @brief Prepares parsing the file given by @p filename in parts
+
+        The entries are the elements named @p entry_tag which are children of an element named
+        @p parent_tag. The file is only split if OpenMP provides more than one thread, the file is not
+        compressed and its size allows at least two chunks of min_split_chunk_size_ bytes.
+
+        @return false if the file was not split, i.e. it has to be parsed with parse_() as usual
+      */
+      bool splitDocument_(const String& filename, const String& entry_tag, const String& parent_tag, SplitDocument& document) const;
+
+      /**
+        @brief Calls @p parse_chunk for the index of each chunk of @p document (in parallel if OpenMP is enabled)
+
+        If parsing fails for some chunks, the exception of the first of them is rethrown.
+      */
+      template <typename ParseChunk>
+      void parseChunks_(const SplitDocument& document, ParseChunk parse_chunk)
+      {
+        std::vector<std::exception_ptr> errors(document.chunks.size());
+#pragma omp parallel for schedule(dynamic, 1)
+        for (SignedSize i = 0; i < SignedSize(document.chunks.size()); ++i)
+        {
+          try
+          {
+            parse_chunk(Size(i));
+          }
+          catch (...)
+          {
+            errors[i] = std::current_exception();
+          }
+        }
+        for (const std::exception_ptr& error : errors)
+        {
+          if (error) std::rethrow_exception(error);
+        }
+      }
+
+      /// Minimal size (in bytes) of the chunks of a split document (see splitDocument_())
+      Size min_split_chunk_size_ = 8 * 1024 * 1024;
+
       /**
         @brief Stores the contents of the XML handler given by @p handler in the file given by @p filename.
 
@@ -54,14 +54,30 @@ namespace OpenMS
 
     @ingroup Kernel
 
-    @note This implementation is @a not thread-safe since it keeps internally a
-    single file access pointer which it moves when accessing a specific
-    data item. Please provide a separate copy to each thread, e.g. 
+    If the underlying file could be memory-mapped (see isMemoryMapped()),
+    spectra and chromatograms can be retrieved by index (getSpectrum,
+    getSpectrumById, getChromatogram, getChromatogramById) concurrently from
+    multiple threads using the same object, e.g.
+
+    @code
+    #pragma omp parallel for
+    for (SignedSize i = 0; i < (SignedSize)ondisc_map.size(); ++i)
+    {
+      MSSpectrum s = ondisc_map.getSpectrum(i);
+    }
+    @endcode
+
+    @note Otherwise, this implementation is @a not thread-safe since it keeps
+    internally a single file access pointer which it moves when accessing a
+    specific data item. Please provide a separate copy to each thread, e.g.
 
     @code
     #pragma omp parallel for firstprivate(ondisc_map) 
     @endcode
 
+    The access by native id is never thread-safe (the lookup table is created
+    on first use).
+
   */
   class OPENMS_DLLAPI OnDiscMSExperiment
   {
@@ -149,6 +165,12 @@ public:
       return getNrSpectra() == 0;
     }
 
+    /// returns whether the underlying file is memory-mapped (i.e. concurrent access by index is safe)
+    inline bool isMemoryMapped() const
+    {
+      return indexed_mzml_file_.isMemoryMapped();
+    }
+
     /// get the total number of spectra available
     inline Size getNrSpectra() const
     {
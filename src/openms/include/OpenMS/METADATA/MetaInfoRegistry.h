@@ -34,8 +34,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Types.h>
@@ -70,6 +74,13 @@ namespace OpenMS
       12 - low_quality<BR>
       13 - charge<BR>
 
+      Looking up names and indices of registered strings (getIndex(), getName()
+      and registerName() for an already registered name) does not lock and can
+      be called concurrently from many threads. Only the registration of new
+      names and the access to descriptions and units are synchronized.
+      Assignment and copy construction must not run concurrently with other
+      operations on the target registry.
+
       @ingroup Metadata
   */
   class OPENMS_DLLAPI MetaInfoRegistry
@@ -90,6 +101,11 @@ public:
     /**
         Registers a string, stores its description and unit, and returns the corresponding index.
         If the string is already registered, it returns the index of the string.
+
+        The registry has a fixed capacity of 4096 * 1024 indices (including the 1024 reserved
+        ones), i.e. at most 4,193,280 names can be registered in addition to the predefined ones.
+
+        @exception Exception::IndexOverflow is thrown if a new name is registered when the capacity is exhausted
     */
     UInt registerName(const String& name, const String& description = "", const String& unit = "");
 
@@ -161,15 +177,51 @@ public:
     String getUnit(const String& name) const;
 
 private:
+    /// A registered name (immutable once it has been published to the readers)
+    struct Entry_
+    {
+      std::string name;
+      UInt index;
+      const Entry_* next_in_bucket; ///< next entry with the same hash bucket
+    };
+
+    /// Atomic pointer to an entry
+    using EntryPtr_ = std::atomic<const Entry_*>;
+
+    /// Number of hash buckets for the lock-free name lookup
+    static constexpr Size bucket_count_ = 4096;
+    /// Number of indices per chunk of the index lookup table
+    static constexpr Size chunk_size_ = 1024;
+    /// Maximal number of chunks of the index lookup table (i.e. at most chunk_size_ * max_chunks_ indices)
+    static constexpr Size max_chunks_ = 4096;
+
+    /// Looks up the index of @p name without locking (returns UInt(-1) if not registered)
+    UInt findIndex_(const std::string& name) const;
+
+    /// Looks up the entry of @p index without locking (returns nullptr if not registered)
+    const Entry_* findEntry_(UInt index) const;
+
+    /// Stores a new entry and publishes it to the readers (the caller has to hold the lock)
+    void insert_(const std::string& name, UInt index);
+
+    /// Allocates empty lookup tables (drops all entries)
+    void clear_();
+
+    /// Copies all entries, descriptions and units from @p rhs
+    void copyFrom_(const MetaInfoRegistry& rhs);
+
     /// internal counter, that stores the next index to assign
     UInt next_index_;
-    using MapString2IndexType = std::unordered_map<std::string, UInt>;
     using MapIndex2StringType = std::unordered_map<UInt, std::string>;
-    
-    /// map from name to index
-    MapString2IndexType name_to_index_;
-    /// map from index to name
-    MapIndex2StringType index_to_name_;
+
+    /// storage of all entries (addresses are stable when appending)
+    std::deque<Entry_> entries_;
+    /// hash buckets: head of a singly linked list of entries
+    std::unique_ptr<EntryPtr_[]> buckets_;
+    /// index lookup table: pointers to chunks of chunk_size_ entry pointers (allocated on demand)
+    std::unique_ptr<std::atomic<EntryPtr_*>[]> chunks_;
+    /// storage of the allocated chunks
+    std::vector<std::unique_ptr<EntryPtr_[]> > chunk_storage_;
     /// map from index to description
     MapIndex2StringType index_to_description_;
     /// map from index to unit
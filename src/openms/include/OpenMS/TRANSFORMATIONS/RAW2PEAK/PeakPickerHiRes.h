@@ -46,6 +46,10 @@ namespace OpenMS
 {
   class MSChromatogram;
   class OnDiscMSExperiment;
+  namespace Interfaces
+  {
+    class IMSDataConsumer;
+  }
 
   /**
     @brief This class implements a fast peak-picking algorithm best suited for
@@ -76,6 +80,11 @@ namespace OpenMS
 
     @note The peaks must be sorted according to ascending m/z!
 
+    @note pickExperiment() picks the spectra and chromatograms in parallel if
+    OpenMP is enabled (for OnDiscMSExperiment input only if it is
+    memory-mapped, see OnDiscMSExperiment::isMemoryMapped()). The output is
+    identical to serial picking.
+
     @ingroup PeakPicking
   */
   class OPENMS_DLLAPI PeakPickerHiRes :
@@ -174,10 +183,47 @@ public:
     */
     void pickExperiment(/* const */ OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type = true) const;
 
+    /**
+      @brief Applies the peak-picking algorithm to a map on disc and passes
+      the picked spectra and chromatograms to a consumer (in input order).
+
+      Neither the profile nor the picked data is held in memory completely;
+      spectra are read and picked in blocks (in parallel if the input is
+      memory-mapped) and handed to @p consumer one by one, e.g. to write them
+      to disk with a PlainMSDataWritingConsumer.
+
+      @param input  input map in profile mode
+      @param consumer  consumer for the picked spectra and chromatograms
+      @param check_spectrum_type  if set, checks spectrum type and throws an exception if a centroided spectrum is passed
+    */
+    void pickExperiment(/* const */ OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& consumer, const bool check_spectrum_type = true) const;
+
 protected:
 
+    /// Buffers for the data points of a peak, reused for all peaks of a spectrum (and across spectra)
+    struct PickScratch_
+    {
+      std::vector<double> mz; ///< m/z of the data points of the current peak (at the positions of the input data points around the apex)
+      std::vector<double> intensity; ///< intensities of the data points of the current peak
+      std::vector<double> peak_mz; ///< m/z of the data points of the current peak (contiguous, for the spline)
+      std::vector<double> peak_int; ///< intensities of the data points of the current peak (contiguous, for the spline)
+    };
+
+    /// pick() using the buffers in @p scratch
+    void pickSpectrum_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, PickScratch_& scratch) const;
+
+    /// pick() using the buffers in @p scratch
+    void pickChromatogram_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, PickScratch_& scratch) const;
+
+    /**
+      @brief Picks a spectrum of an OnDiscMSExperiment (or copies it, depending on ms_levels_ and its type)
+
+      @return true if the spectrum was picked
+    */
+    bool pickOnDiscSpectrum_(/* const */ OnDiscMSExperiment& input, Size scan_idx, MSSpectrum& output, const bool check_spectrum_type, PickScratch_& scratch) const;
+
     template <typename ContainerType>
-    void pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings = true, int im_index = -1) const;
+    void pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, PickScratch_& scratch, bool check_spacings = true, int im_index = -1) const;
 
     // signal-to-noise parameter
     double signal_to_noise_;
@@ -45,6 +45,7 @@
 #include <OpenMS/METADATA/ID/IdentificationDataConverter.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <exception>
 #include <numeric>
 
 namespace OpenMS
@@ -367,15 +368,18 @@ namespace OpenMS
 
     // Depending on ion_mode_internal_, either positive or negative adducts are used
     std::vector<AdductInfo>::const_iterator it_s, it_e;
+    std::vector<ElementCounts_>::const_iterator required_it;
     if (ion_mode == "positive")
     {
       it_s = pos_adducts_.begin();
       it_e = pos_adducts_.end();
+      required_it = pos_adducts_required_.begin();
     }
     else if (ion_mode == "negative")
     {
       it_s = neg_adducts_.begin();
       it_e = neg_adducts_.end();
+      required_it = neg_adducts_required_.begin();
     }
     else
     {
@@ -383,7 +387,7 @@ namespace OpenMS
     }
 
     std::pair<Size, Size> hit_idx;
-    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it)
+    for (std::vector<AdductInfo>::const_iterator it = it_s; it != it_e; ++it, ++required_it)
     {
       if (observed_charge != 0 && (std::abs(observed_charge) != std::abs(it->getCharge())))
       { // charge of evidence and adduct must match in absolute terms (absolute, since any FeatureFinder gives only positive charges, even for negative-mode spectra)
@@ -432,8 +436,11 @@ namespace OpenMS
       // store information from query hits in AccurateMassSearchResult objects
       for (Size i = hit_idx.first; i < hit_idx.second; ++i)
       {
-        // check if DB entry is compatible to the adduct
-        if (!it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula)))
+        // check if DB entry is compatible to the adduct (formulas which could not be parsed at load time are parsed (and throw) here)
+        bool compatible = mass_mappings_[i].has_element_counts ?
+                          containsElements_(mass_mappings_[i].element_counts, *required_it) :
+                          it->isCompatible(EmpiricalFormula(mass_mappings_[i].formula));
+        if (!compatible)
         {
           // only written if TOPP tool has --debug
           OPENMS_LOG_DEBUG << "'" << mass_mappings_[i].formula << "' cannot have adduct '" << it->getName() << "'. Omitting.\n";
@@ -572,6 +579,18 @@ namespace OpenMS
     parseAdductsFile_(pos_adducts_fname_, pos_adducts_);
     parseAdductsFile_(neg_adducts_fname_, neg_adducts_);
 
+    // the atoms an adduct loses have to be present in a compatible DB entry (see AdductInfo::isCompatible())
+    pos_adducts_required_.clear();
+    for (const AdductInfo& adduct : pos_adducts_)
+    {
+      pos_adducts_required_.push_back(toElementCounts_(adduct.getEmpiricalFormula() * -1));
+    }
+    neg_adducts_required_.clear();
+    for (const AdductInfo& adduct : neg_adducts_)
+    {
+      neg_adducts_required_.push_back(toElementCounts_(adduct.getEmpiricalFormula() * -1));
+    }
+
     is_initialized_ = true;
   }
 
@@ -663,13 +682,18 @@ namespace OpenMS
     // map for storing overall results
     QueryResultsTable overall_results;
     Size dummy_count(0);
+    QueryResultsTable feature_results = extractQueryResults_(fmap, ion_mode_internal);
     for (Size i = 0; i < fmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results = extractQueryResults_(fmap[i], i, ion_mode_internal, dummy_count);
+      const std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
       if (query_results.empty())
       {
         continue;
       }
+      if (query_results[0].getMatchingIndex() == (Size) - 1)
+      {
+        ++dummy_count;
+      }
       overall_results.push_back(query_results);
 
       addMatchesToID_(id, query_results, file_ref, mass_error_ppm_score_ref, mass_error_Da_score_ref, step_ref, fmap[i]); // MztabM
@@ -728,13 +752,18 @@ namespace OpenMS
     // map for storing overall results
     QueryResultsTable overall_results;
     Size dummy_count(0);
+    QueryResultsTable feature_results = extractQueryResults_(fmap, ion_mode_internal);
     for (Size i = 0; i < fmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results = extractQueryResults_(fmap[i], i, ion_mode_internal, dummy_count);
+      const std::vector<AccurateMassSearchResult>& query_results = feature_results[i];
       if (query_results.empty())
       {
         continue;
       }
+      if (query_results[0].getMatchingIndex() == (Size) - 1)
+      {
+        ++dummy_count;
+      }
       overall_results.push_back(query_results);
 
       annotate_(query_results, fmap[i]);
@@ -905,14 +934,33 @@ namespace OpenMS
       file_locations.emplace_back(fd.second.filename);
     }
 
-    // map for storing overall results
-    QueryResultsTable overall_results;
+    // map for storing overall results; the queries are independent of each other and
+    // run in parallel, annotation of the consensus features is done in order afterwards
+    QueryResultsTable overall_results(cmap.size());
+    std::vector<std::exception_ptr> errors(cmap.size());
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)cmap.size(); ++i)
+    {
+      try
+      {
+        queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, overall_results[i]);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    }
+    // re-throw the first error, as the serial search would
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
     for (Size i = 0; i < cmap.size(); ++i)
     {
-      std::vector<AccurateMassSearchResult> query_results;
-      queryByConsensusFeature(cmap[i], i, num_of_maps, ion_mode_internal, query_results);
-      annotate_(query_results, cmap[i]);
-      overall_results.push_back(query_results);
+      annotate_(overall_results[i], cmap[i]);
     }
     // add dummy protein identification which is required to keep peptidehits alive during store()
     cmap.getProteinIdentifications().resize(cmap.getProteinIdentifications().size() + 1);
@@ -1355,6 +1403,7 @@ namespace OpenMS
 
         Size word_count(0);
         MappingEntry_ entry;
+        EmpiricalFormula entry_ef;
 
         while (istr_it != eol)
         {
@@ -1366,9 +1415,22 @@ namespace OpenMS
           else if (word_count == 1)
           {
             entry.formula = *istr_it;
+            try
+            { // parse once here instead of for every candidate hit in queryByMZ()
+              entry_ef = EmpiricalFormula(entry.formula);
+              entry.element_counts = toElementCounts_(entry_ef);
+              entry.has_element_counts = true;
+            }
+            catch (Exception::ParseError&)
+            { // keep the entry; queryByMZ() will report the formula if it is ever hit
+              if (entry.mass == 0)
+              { // the mass cannot be computed
+                throw;
+              }
+            }
             if (entry.mass == 0)
             { // recompute mass from formula
-              entry.mass = EmpiricalFormula(entry.formula).getMonoWeight();
+              entry.mass = entry_ef.getMonoWeight();
               //std::cerr << "mass of " << entry.formula << " is " << entry.mass << "\n";
             }
           }
@@ -1541,7 +1603,60 @@ namespace OpenMS
     return computeCosineSim_(theoretical_iso_dist, observed_iso_dist);
   }
 
-  std::vector<AccurateMassSearchResult> AccurateMassSearchEngine::extractQueryResults_(const Feature& feature, const Size& feature_index, const String& ion_mode_internal, Size& dummy_count) const
+  AccurateMassSearchEngine::ElementCounts_ AccurateMassSearchEngine::toElementCounts_(const EmpiricalFormula& ef)
+  {
+    // EmpiricalFormula iterates its elements sorted by Element pointer
+    return ElementCounts_(ef.begin(), ef.end());
+  }
+
+  bool AccurateMassSearchEngine::containsElements_(const ElementCounts_& formula, const ElementCounts_& required)
+  {
+    // both are sorted by element, so a single merge-like pass suffices
+    std::less<const Element*> element_less;
+    ElementCounts_::const_iterator f_it = formula.begin();
+    for (const auto& req : required)
+    {
+      while (f_it != formula.end() && element_less(f_it->first, req.first))
+      {
+        ++f_it;
+      }
+      SignedSize count = (f_it != formula.end() && f_it->first == req.first) ? f_it->second : 0;
+      if (count < req.second)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<std::vector<AccurateMassSearchResult> > AccurateMassSearchEngine::extractQueryResults_(const FeatureMap& fmap, const String& ion_mode_internal) const
+  {
+    QueryResultsTable results(fmap.size());
+    std::vector<std::exception_ptr> errors(fmap.size());
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)fmap.size(); ++i)
+    {
+      try
+      {
+        results[i] = extractQueryResults_(fmap[i], i, ion_mode_internal);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    }
+    // re-throw the first error, as the serial search would
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+    return results;
+  }
+
+  std::vector<AccurateMassSearchResult> AccurateMassSearchEngine::extractQueryResults_(const Feature& feature, const Size& feature_index, const String& ion_mode_internal) const
   {
     std::vector<AccurateMassSearchResult> query_results;
 
@@ -1553,8 +1668,6 @@ namespace OpenMS
     }
 
     bool is_dummy = (query_results[0].getMatchingIndex() == (Size) - 1);
-    if (is_dummy)
-      ++dummy_count;
 
     if (iso_similarity_ && !is_dummy)
     {
@@ -619,14 +619,18 @@ namespace OpenMS
     }
 
     // Use dynamic schedule because big CCs take much longer!
-    #pragma omp parallel for schedule(dynamic) default(none) shared(functor)
-    for (int i = 0; i < static_cast<int>(ccs_.size()); i += 1)
+    // Hand out the most expensive CCs first: otherwise a giant CC that happens to
+    // come late keeps a single thread busy long after all others have finished.
+    std::vector<Size> cc_order = getCCsOrderedByCost_();
+    #pragma omp parallel for schedule(dynamic, 1) default(none) shared(functor, cc_order)
+    for (int k = 0; k < static_cast<int>(cc_order.size()); k += 1)
     {
       #ifdef INFERENCE_BENCH
       StopWatch sw;
       sw.start();
       #endif
 
+      const unsigned int i = static_cast<unsigned int>(cc_order[k]);
       Graph& curr_cc = ccs_.at(i);
 
       #ifdef INFERENCE_MT_DEBUG
@@ -667,6 +671,27 @@ namespace OpenMS
     #endif
   }
 
+  std::vector<Size> IDBoostGraph::getCCsOrderedByCost_() const
+  {
+    // the number of messages passed during inference grows with the number of edges
+    std::vector<std::pair<Size, Size>> cost_and_index;
+    cost_and_index.reserve(ccs_.size());
+    for (Size i = 0; i < ccs_.size(); ++i)
+    {
+      cost_and_index.emplace_back(boost::num_edges(ccs_[i]) + boost::num_vertices(ccs_[i]), i);
+    }
+    std::stable_sort(cost_and_index.begin(), cost_and_index.end(),
+                     [](const std::pair<Size, Size>& a, const std::pair<Size, Size>& b) { return a.first > b.first; });
+
+    std::vector<Size> order;
+    order.reserve(cost_and_index.size());
+    for (const auto& ci : cost_and_index)
+    {
+      order.push_back(ci.second);
+    }
+    return order;
+  }
+
   /// Do sth on ccs single-threaded
   void IDBoostGraph::applyFunctorOnCCsST(const std::function<void(Graph&)>& functor)
   {
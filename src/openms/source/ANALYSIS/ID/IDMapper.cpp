@@ -36,6 +36,8 @@
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/METADATA/SpectrumLookup.h>
 
+#include <exception>
+#include <unordered_map>
 #include <unordered_set>
 
 
@@ -249,7 +251,81 @@ namespace OpenMS
     annotate(map, peptide_ids, protein_ids, clear_ids, map_ms1);
   }
 
-  bool isMatchByNativeID(const PeptideIdentification& id, ConsensusFeature& cf)
+  namespace
+  {
+    /**
+      @brief Grid of (RT, m/z) positions for range queries
+
+      Positions are binned by RT; within each bin they are sorted by m/z, so a
+      query only needs a binary search per visited bin.
+    */
+    class PositionGrid
+    {
+    public:
+      /// A position with the value reported for it by query()
+      struct Position
+      {
+        double rt;
+        double mz;
+        Size value;
+      };
+
+      /// Build the grid (positions with non-finite coordinates are ignored)
+      PositionGrid(const vector<Position>& positions, double rt_bin_width)
+      {
+        for (const Position& pos : positions)
+        {
+          if (!std::isfinite(pos.rt) || !std::isfinite(pos.mz)) continue;
+          rt_min_ = std::min(rt_min_, pos.rt);
+          rt_max_ = std::max(rt_max_, pos.rt);
+        }
+        if (rt_min_ > rt_max_) return; // no positions
+        // limit the number of bins to the number of positions
+        bin_width_ = std::max(rt_bin_width, (rt_max_ - rt_min_) / positions.size());
+        if (!(bin_width_ > 0)) bin_width_ = 1.0;
+        bins_.resize(getBin_(rt_max_) + 1);
+        for (const Position& pos : positions)
+        {
+          if (!std::isfinite(pos.rt) || !std::isfinite(pos.mz)) continue;
+          bins_[getBin_(pos.rt)].push_back(pos);
+        }
+        for (vector<Position>& bin : bins_)
+        {
+          sort(bin.begin(), bin.end(), [](const Position& a, const Position& b) { return a.mz < b.mz; });
+        }
+      }
+
+      /// Append the values of all positions inside the given (closed) ranges to @p result
+      void query(double rt_min, double rt_max, double mz_min, double mz_max, vector<Size>& result) const
+      {
+        if (bins_.empty() || rt_max < rt_min_ || rt_min > rt_max_) return;
+        const Size first = getBin_(std::max(rt_min, rt_min_));
+        const Size last = getBin_(std::min(rt_max, rt_max_));
+        for (Size b = first; b <= last; ++b)
+        {
+          const vector<Position>& bin = bins_[b];
+          auto it = lower_bound(bin.begin(), bin.end(), mz_min, [](const Position& pos, double mz) { return pos.mz < mz; });
+          for (; it != bin.end() && it->mz <= mz_max; ++it)
+          {
+            if (it->rt >= rt_min && it->rt <= rt_max) result.push_back(it->value);
+          }
+        }
+      }
+
+    private:
+      Size getBin_(double rt) const
+      {
+        return std::min(Size((rt - rt_min_) / bin_width_), bins_.size() - 1);
+      }
+
+      double rt_min_ = numeric_limits<double>::max();
+      double rt_max_ = -numeric_limits<double>::max();
+      double bin_width_ = 1.0;
+      vector<vector<Position>> bins_;
+    };
+  }
+
+  bool isMatchByNativeID(const PeptideIdentification& id, const ConsensusFeature& cf)
   {
     // check if the native id of an identifying spectrum is annotated            
     String ref_mv;
@@ -281,129 +357,185 @@ namespace OpenMS
     // append protein identifications to Map
     map.getProteinIdentifications().insert(map.getProteinIdentifications().end(), protein_ids.begin(), protein_ids.end());
 
-    // keep track of assigned/unassigned peptide identifications.
-    // maps Pep.Id. index to number of assignments to a feature
-    std::map<Size, Size> assigned_ids;
-
-    // keep track of assigned/unassigned precursors
-    std::map<Size, Size> assigned_precursors;
-
-    // store which peptides fit which feature (and avoid double entries)
-    // consensusMap -> {peptide_index}
-    vector<set<size_t>> mapping(map.size());
+    // index the positions that are matched against (consensus feature
+    // centroids or their subelements) in an RT x m/z grid, so that only
+    // nearby consensus features have to be checked for every identification
+    vector<PositionGrid::Position> positions;
+    for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+    {
+      if (!measure_from_subelements)
+      {
+        positions.push_back({map[cm_index].getRT(), map[cm_index].getMZ(), cm_index});
+      }
+      else
+      {
+        for (const FeatureHandle& handle : map[cm_index].getFeatures())
+        {
+          positions.push_back({handle.getRT(), handle.getMZ(), cm_index});
+        }
+      }
+    }
+    PositionGrid grid(positions, 2 * rt_tolerance_);
+    positions.clear();
 
-    DoubleList mz_values;
-    double rt_pep;
-    IntList charges;
+    // consensus features that can be matched by native ID (independent of RT and m/z)
+    unordered_map<String, vector<Size>> native_id_index;
+    if (!measure_from_subelements)
+    {
+      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      {
+        if (map[cm_index].metaValueExists("id_scan_id"))
+        {
+          native_id_index[map[cm_index].getMetaValue("id_scan_id").toString()].push_back(cm_index);
+        }
+        else if (map[cm_index].metaValueExists("scan_id"))
+        {
+          native_id_index[map[cm_index].getMetaValue("scan_id").toString()].push_back(cm_index);
+        }
+      }
+    }
 
-    // for statistics
-    Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
+    // consensus features (in ascending order) each peptide ID is mapped to,
+    // together with the (annotated) copy of the peptide ID to store there
+    vector<vector<pair<Size, PeptideIdentification>>> matches(ids.size());
+    vector<std::exception_ptr> errors(ids.size());
 
     // iterate over the peptide IDs
-    for (Size i = 0; i < ids.size(); ++i)
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)ids.size(); ++i)
     {
       if (ids[i].getHits().empty()) continue;
 
-      getIDDetails_(ids[i], rt_pep, mz_values, charges);
-
-      bool id_mapped(false);
-
-      // iterate over the features
-      for (Size cm_index = 0; cm_index < map.size(); ++cm_index)
+      try
       {
-        // if set to TRUE, we leave the i_mz-loop as we added the whole ID with all hits
-        bool was_added = false; // was current pep-m/z matched?!
+        DoubleList mz_values;
+        double rt_pep;
+        IntList charges;
+        getIDDetails_(ids[i], rt_pep, mz_values, charges);
+
+        // collect candidates: the grid query is slightly wider than the
+        // tolerances, the exact check below decides
+        vector<Size> candidates;
+        const double rt_slack = rt_tolerance_ + 1e-6 * (1.0 + fabs(rt_pep));
+        for (double mz_pep : mz_values)
+        {
+          if (!std::isfinite(mz_pep)) continue; // cannot match by m/z
+          const double mz_slack = getAbsoluteMZTolerance_(mz_pep) + 1e-9 * (1.0 + fabs(mz_pep));
+          grid.query(rt_pep - rt_slack, rt_pep + rt_slack, mz_pep - mz_slack, mz_pep + mz_slack, candidates);
+        }
+        if (!measure_from_subelements && ids[i].metaValueExists("spectrum_reference"))
+        {
+          auto native_it = native_id_index.find(ids[i].getMetaValue("spectrum_reference").toString());
+          if (native_it != native_id_index.end())
+          {
+            candidates.insert(candidates.end(), native_it->second.begin(), native_it->second.end());
+          }
+        }
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
 
-        // iterate over m/z values of pepIds
-        for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
+        // iterate over the candidate features
+        for (Size cm_index : candidates)
         {
-          double mz_pep = mz_values[i_mz];
+          const ConsensusFeature& feature = map[cm_index];
 
-          // charge states to use for checking:
-          IntList current_charges;
-          if (!ignore_charge_)
+          // iterate over m/z values of pepIds
+          for (Size i_mz = 0; i_mz < mz_values.size(); ++i_mz)
           {
-            // if "mz_ref." is "precursor", we have only one m/z value to check,
-            // but still one charge state per peptide hit that could match:
-            if (mz_values.size() == 1)
-            {
-              current_charges = charges;
-            }
-            else
+            double mz_pep = mz_values[i_mz];
+
+            // charge states to use for checking:
+            IntList current_charges;
+            if (!ignore_charge_)
             {
-              current_charges.push_back(charges[i_mz]);
+              // if "mz_ref." is "precursor", we have only one m/z value to check,
+              // but still one charge state per peptide hit that could match:
+              if (mz_values.size() == 1)
+              {
+                current_charges = charges;
+              }
+              else
+              {
+                current_charges.push_back(charges[i_mz]);
+              }
+              current_charges.push_back(0); // "not specified" always matches
             }
-            current_charges.push_back(0); // "not specified" always matches
-          }
 
-          //check if we compare distance from centroid or subelements
-          if (!measure_from_subelements)
-          {
-            if (isMatchByNativeID(ids[i], map[cm_index]) || // can we match by native ids? if not, match by rt/mz
-               (isMatch_(rt_pep - map[cm_index].getRT(), mz_pep, map[cm_index].getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, map[cm_index].getCharge()))))
+            // check if we compare distance from centroid or subelements
+            if (!measure_from_subelements)
             {
-              id_mapped = true;
-              was_added = true;
-              map[cm_index].getPeptideIdentifications().push_back(ids[i]);
-              ++assigned_ids[i];
+              if (isMatchByNativeID(ids[i], feature) || // can we match by native ids? if not, match by rt/mz
+                 (isMatch_(rt_pep - feature.getRT(), mz_pep, feature.getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, feature.getCharge()))))
+              {
+                matches[i].emplace_back(cm_index, ids[i]);
+                break; // we added the whole ID with all hits
+              }
             }
-          }
-          else
-          {
-            for (ConsensusFeature::HandleSetType::const_iterator it_handle = map[cm_index].getFeatures().begin();
-                 it_handle != map[cm_index].getFeatures().end();
-                 ++it_handle)
+            else
             {
-              if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
+              ConsensusFeature::HandleSetType::const_iterator it_handle = feature.getFeatures().begin();
+              for (; it_handle != feature.getFeatures().end(); ++it_handle)
+              {
+                if (isMatch_(rt_pep - it_handle->getRT(), mz_pep, it_handle->getMZ()) && (ignore_charge_ || ListUtils::contains(current_charges, it_handle->getCharge())))
+                {
+                  break; // no need to check other handles
+                }
+              }
+              if (it_handle != feature.getFeatures().end())
               {
-                id_mapped = true;
-                was_added = true;
-                if (mapping[cm_index].count(i) == 0)
+                matches[i].emplace_back(cm_index, ids[i]);
+                if (annotate_ids_with_subelements)
                 {
                   // Store the map index of the peptide feature in the id the feature was mapped to.
-                  PeptideIdentification id_pep = ids[i];
-                  if (annotate_ids_with_subelements)
-                  {
-                    id_pep.setMetaValue("map_index", it_handle->getMapIndex());
-                  }
-
-                  map[cm_index].getPeptideIdentifications().push_back(id_pep);
-                  ++assigned_ids[i];
-                  mapping[cm_index].insert(i);
+                  matches[i].back().second.setMetaValue("map_index", it_handle->getMapIndex());
                 }
-                break; // we added this peptide already.. no need to check other handles
+                break; // we added the whole ID with all hits
               }
             }
-            // continue to here
-          }
-
-          if (was_added) break;
+          } // m/z values to check
+        } // features
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    } // Identifications
 
-        } // m/z values to check
+    // fail as the serial mapping would have: with the first error
+    for (const std::exception_ptr& error : errors)
+    {
+      if (error) std::rethrow_exception(error);
+    }
 
-        // break to here
+    // for statistics
+    Size id_matches_none(0), id_matches_single(0), id_matches_multiple(0);
 
-      } // features
+    // store the IDs in the order of the input
+    for (Size i = 0; i < ids.size(); ++i)
+    {
+      if (ids[i].getHits().empty()) continue;
 
       // the id has not been mapped to any consensus feature
-      if (!id_mapped)
+      if (matches[i].empty())
       {
         map.getUnassignedPeptideIdentifications().push_back(ids[i]);
         ++id_matches_none;
+        continue;
       }
-    } // Identifications
-
-    for (std::map<Size, Size>::const_iterator it = assigned_ids.begin(); it != assigned_ids.end(); ++it)
-    {
-      if (it->second == 1)
+      if (matches[i].size() == 1)
       {
         ++id_matches_single;
       }
-      else if (it->second > 1)
+      else
       {
         ++id_matches_multiple;
       }
+      for (pair<Size, PeptideIdentification>& match : matches[i])
+      {
+        map[match.first].getPeptideIdentifications().push_back(std::move(match.second));
+      }
     }
+    matches.clear();
 
     vector<Size> unidentified = mapPrecursorsToIdentifications(spectra, ids).unidentified;
 
@@ -441,6 +573,9 @@ namespace OpenMS
       }
     }
 
+    // keep track of assigned/unassigned precursors
+    std::map<Size, Size> assigned_precursors;
+
     // for statistics:
     Size spectrum_matches_none(0), spectrum_matches_single(0), spectrum_matches_multiple(0);
 
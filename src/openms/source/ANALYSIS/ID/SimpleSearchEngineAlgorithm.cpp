@@ -146,6 +146,14 @@ namespace OpenMS
     defaults_.setValue("report:top_hits", 1, "Maximum number of top scoring hits per spectrum that are reported.");
     defaults_.setSectionDescription("report", "Reporting Options");
 
+    defaults_.setValue("fragment_index:enabled", "false", "Search spectra against an index of all fragment ions of the database instead of scoring every peptide against all spectra in its precursor window. Recommended for wide precursor mass tolerances (open search).");
+    defaults_.setValidStrings("fragment_index:enabled", {"true","false"} );
+    defaults_.setValue("fragment_index:min_matched_peaks", 3, "Minimum number of peaks matching a fragment ion of a peptide for it to be scored.");
+    defaults_.setMinInt("fragment_index:min_matched_peaks", 1);
+    defaults_.setValue("fragment_index:candidates", 50, "Number of peptides with the most matching peaks that are scored per spectrum.");
+    defaults_.setMinInt("fragment_index:candidates", 1);
+    defaults_.setSectionDescription("fragment_index", "Fragment Index Options");
+
     defaultsToParam_();
   }
 
@@ -192,6 +200,10 @@ namespace OpenMS
 
     decoys_ = param_.getValue("decoys") == "true";
     annotate_psm_ = ListUtils::toStringList<std::string>(param_.getValue("annotate:PSM"));
+
+    fragment_index_ = param_.getValue("fragment_index:enabled") == "true";
+    fragment_index_min_matched_peaks_ = param_.getValue("fragment_index:min_matched_peaks");
+    fragment_index_candidates_ = param_.getValue("fragment_index:candidates");
   }
 
   // static
@@ -418,10 +430,437 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     protein_ids[0].setSearchParameters(std::move(search_parameters));
   }
 
-  SimpleSearchEngineAlgorithm::ExitCodes SimpleSearchEngineAlgorithm::search(const String& in_mzML, const String& in_db, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids) const
+  Size SimpleSearchEngineAlgorithm::digestDatabase_(const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const ProteaseDigestion& digestor,
+    vector<StringView>& peptides) const
   {
     boost::regex peptide_motif_regex(peptide_motif_);
 
+    startProgress(0, fasta_db.size(), "Digesting proteins...");
+
+    peptides.clear();
+    Size count_proteins(0);
+#pragma omp parallel
+    {
+      vector<StringView> thread_peptides;
+#pragma omp for schedule(static) nowait
+      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
+      {
+        #pragma omp atomic
+        ++count_proteins;
+
+        IF_MASTERTHREAD
+        {
+          setProgress(count_proteins);
+        }
+
+        vector<StringView> current_digest;
+        digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
+
+        for (auto const & c : current_digest)
+        {
+          const String current_peptide = c.getString();
+          if (current_peptide.find_first_of("XBZ") != std::string::npos)
+          {
+            continue;
+          }
+
+          // if a peptide motif is provided skip all peptides without match
+          if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex))
+          {
+            continue;
+          }
+          thread_peptides.push_back(c);
+        }
+      }
+#pragma omp critical (peptides_access)
+      peptides.insert(peptides.end(), thread_peptides.begin(), thread_peptides.end());
+    }
+    Size count_digested = peptides.size();
+    std::sort(peptides.begin(), peptides.end());
+    peptides.erase(std::unique(peptides.begin(), peptides.end()), peptides.end());
+    endProgress();
+    return count_digested;
+  }
+
+  // static
+  void SimpleSearchEngineAlgorithm::keepTopHitsPerSpectrum_(vector<pair<Size, AnnotatedHit_> >& hits, Size top_hits)
+  {
+    std::sort(hits.begin(), hits.end(), [](const pair<Size, AnnotatedHit_>& a, const pair<Size, AnnotatedHit_>& b)
+    {
+      if (a.first != b.first) return a.first < b.first;
+      return AnnotatedHit_::hasBetterScore(a.second, b.second);
+    });
+
+    Size kept(0), rank(0);
+    for (Size i = 0; i != hits.size(); ++i)
+    {
+      rank = (i != 0 && hits[i].first == hits[i - 1].first) ? rank + 1 : 0;
+      if (rank < top_hits)
+      {
+        if (kept != i) { hits[kept] = std::move(hits[i]); }
+        ++kept;
+      }
+    }
+    hits.resize(kept);
+  }
+
+  void SimpleSearchEngineAlgorithm::buildFragmentIndex_(const vector<FASTAFile::FASTAEntry>& fasta_db,
+    const ProteaseDigestion& digestor,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    FragmentIndex_& index) const
+  {
+    // unique peptide sequences of the database
+    vector<StringView>& peptides = index.sequences;
+    digestDatabase_(fasta_db, digestor, peptides);
+
+    // modify the peptides and generate their fragments. The fragment m/z
+    // values of a peptide are stored consecutively in fragment_mz.
+    struct PeptideFragments
+    {
+      IndexedPeptide_ peptide;
+      Size fragment_begin;
+      Size fragment_end;
+    };
+    vector<PeptideFragments> candidates;
+    vector<float> fragment_mz;
+
+    TheoreticalSpectrumGenerator spectrum_generator;
+    Param param(spectrum_generator.getParameters());
+    param.setValue("add_first_prefix_ion", "true");
+    spectrum_generator.setParameters(param);
+
+    startProgress(0, peptides.size(), "Generating fragment ions...");
+    Size count_peptides(0);
+#pragma omp parallel
+    {
+      vector<PeptideFragments> thread_candidates;
+      vector<float> thread_mz;
+#pragma omp for schedule(dynamic, 100) nowait
+      for (SignedSize peptide_index = 0; peptide_index < (SignedSize)peptides.size(); ++peptide_index)
+      {
+        #pragma omp atomic
+        ++count_peptides;
+
+        IF_MASTERTHREAD
+        {
+          setProgress(count_peptides);
+        }
+
+        vector<AASequence> all_modified_peptides;
+
+        // this critical section is because ResidueDB is not thread safe and new residues are created based on the PTMs
+        #pragma omp critical (residuedb_access)
+        {
+          AASequence aas = AASequence::fromString(peptides[peptide_index].getString());
+          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
+        }
+
+        for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
+        {
+          const AASequence& candidate = all_modified_peptides[mod_pep_idx];
+
+          // add peaks for b and y ions with charge 1 (as in the peptide-centric search)
+          PeakSpectrum theo_spectrum;
+          spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+
+          PeptideFragments pf;
+          pf.peptide.sequence_index = (UInt32)peptide_index;
+          pf.peptide.peptide_mod_index = (UInt32)mod_pep_idx;
+          pf.peptide.mass = candidate.getMonoWeight();
+          pf.fragment_begin = thread_mz.size();
+          for (const Peak1D& p : theo_spectrum)
+          {
+            thread_mz.push_back((float)p.getMZ());
+          }
+          pf.fragment_end = thread_mz.size();
+          thread_candidates.push_back(std::move(pf));
+        }
+      }
+#pragma omp critical (fragment_index_access)
+      {
+        const Size offset = fragment_mz.size();
+        for (PeptideFragments& pf : thread_candidates)
+        {
+          pf.fragment_begin += offset;
+          pf.fragment_end += offset;
+        }
+        candidates.insert(candidates.end(), thread_candidates.begin(), thread_candidates.end());
+        fragment_mz.insert(fragment_mz.end(), thread_mz.begin(), thread_mz.end());
+      }
+    }
+    endProgress();
+
+    if (candidates.size() > (Size)std::numeric_limits<UInt32>::max() || peptides.size() > (Size)std::numeric_limits<UInt32>::max())
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, candidates.size());
+    }
+
+    // sort by mass (and sequence / modification to be independent of the thread scheduling)
+    std::sort(candidates.begin(), candidates.end(), [](const PeptideFragments& a, const PeptideFragments& b)
+    {
+      if (a.peptide.mass != b.peptide.mass) return a.peptide.mass < b.peptide.mass;
+      if (a.peptide.sequence_index != b.peptide.sequence_index) return a.peptide.sequence_index < b.peptide.sequence_index;
+      return a.peptide.peptide_mod_index < b.peptide.peptide_mod_index;
+    });
+
+    index.peptides.clear();
+    index.peptides.reserve(candidates.size());
+    for (const PeptideFragments& pf : candidates)
+    {
+      index.peptides.push_back(pf.peptide);
+    }
+
+    // lay out the fragments slice by slice and sort each slice by m/z
+    const Size slice_count = (candidates.size() + fragment_index_slice_size_ - 1) / fragment_index_slice_size_;
+    index.slice_begin.assign(slice_count + 1, 0);
+    for (Size slice = 0; slice != slice_count; ++slice)
+    {
+      Size slice_fragments(0);
+      const Size peptide_end = std::min((slice + 1) * fragment_index_slice_size_, candidates.size());
+      for (Size i = slice * fragment_index_slice_size_; i != peptide_end; ++i)
+      {
+        slice_fragments += candidates[i].fragment_end - candidates[i].fragment_begin;
+      }
+      index.slice_begin[slice + 1] = index.slice_begin[slice] + slice_fragments;
+    }
+    index.fragments.resize(index.slice_begin.back());
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize slice = 0; slice < (SignedSize)slice_count; ++slice)
+    {
+      Size pos = index.slice_begin[slice];
+      const Size peptide_end = std::min((slice + 1) * fragment_index_slice_size_, candidates.size());
+      for (Size i = slice * fragment_index_slice_size_; i != peptide_end; ++i)
+      {
+        for (Size f = candidates[i].fragment_begin; f != candidates[i].fragment_end; ++f)
+        {
+          index.fragments[pos++] = IndexedFragment_{fragment_mz[f], (UInt32)i};
+        }
+      }
+      std::sort(index.fragments.begin() + index.slice_begin[slice], index.fragments.begin() + index.slice_begin[slice + 1],
+        [](const IndexedFragment_& a, const IndexedFragment_& b)
+        {
+          if (a.mz != b.mz) return a.mz < b.mz;
+          return a.peptide_index < b.peptide_index;
+        });
+    }
+
+    OPENMS_LOG_INFO << "Proteins: " << fasta_db.size() << endl;
+    OPENMS_LOG_INFO << "Peptides: " << peptides.size() << endl;
+    OPENMS_LOG_INFO << "Indexed peptides (incl. modified): " << index.peptides.size() << endl;
+    OPENMS_LOG_INFO << "Indexed fragments: " << index.fragments.size() << endl;
+  }
+
+  void SimpleSearchEngineAlgorithm::searchFragmentIndex_(const FragmentIndex_& index,
+    const ModifiedPeptideGenerator::MapToResidueType& fixed_modifications,
+    const ModifiedPeptideGenerator::MapToResidueType& variable_modifications,
+    const PeakMap& spectra,
+    vector<vector<AnnotatedHit_> >& annotated_hits) const
+  {
+    const bool precursor_mass_tolerance_unit_ppm = (precursor_mass_tolerance_unit_ == "ppm");
+    const bool fragment_mass_tolerance_unit_ppm = (fragment_mass_tolerance_unit_ == "ppm");
+
+    // create spectrum generator for rescoring the candidates
+    TheoreticalSpectrumGenerator spectrum_generator;
+    Param param(spectrum_generator.getParameters());
+    param.setValue("add_first_prefix_ion", "true");
+    param.setValue("add_metainfo", "true");
+    spectrum_generator.setParameters(param);
+
+    startProgress(0, spectra.size(), "Scoring spectra against fragment index...");
+    Size count_spectra(0);
+
+#pragma omp parallel
+    {
+      // buffers of this thread, allocated once and reused for all its spectra:
+      // number of matched peaks per peptide (only the entries in matched_peptides are reset after each spectrum)
+      vector<UInt32> matched_peaks(index.peptides.size(), 0);
+      vector<UInt32> matched_peptides;
+      vector<pair<Size, Size> > peptide_ranges;
+      vector<UInt32> candidates;
+      vector<AASequence> all_modified_peptides;
+
+#pragma omp for schedule(dynamic)
+      for (SignedSize scan_index = 0; scan_index < (SignedSize)spectra.size(); ++scan_index)
+      {
+        #pragma omp atomic
+        ++count_spectra;
+
+        IF_MASTERTHREAD
+        {
+          setProgress(count_spectra);
+        }
+
+        const PeakSpectrum& exp_spectrum = spectra[scan_index];
+        const vector<Precursor>& precursor = exp_spectrum.getPrecursors();
+
+        // same requirements on the spectra as in the peptide-centric search
+        if (precursor.size() != 1 || exp_spectrum.size() < peptide_min_size_) { continue; }
+
+        const Size precursor_charge = precursor[0].getCharge();
+        if (precursor_charge < precursor_min_charge_ || precursor_charge > precursor_max_charge_) { continue; }
+
+        const double precursor_mz = precursor[0].getMZ();
+
+        // determine the peptides (index ranges) matching the precursor mass (optionally corrected for misassignment)
+        peptide_ranges.clear();
+        for (int isotope_number : precursor_isotopes_)
+        {
+          double precursor_mass = (double) precursor_charge * precursor_mz - (double) precursor_charge * Constants::PROTON_MASS_U;
+          if (isotope_number != 0) { precursor_mass -= isotope_number * Constants::C13C12_MASSDIFF_U; }
+
+          // invert the tolerance check of the peptide-centric search (tolerance relative to the peptide mass)
+          double low_mass, high_mass;
+          if (precursor_mass_tolerance_unit_ppm)
+          {
+            const double tolerance = precursor_mass_tolerance_ * 1e-6;
+            low_mass = precursor_mass / (1.0 + tolerance);
+            high_mass = tolerance < 1.0 ? precursor_mass / (1.0 - tolerance) : std::numeric_limits<double>::max();
+          }
+          else
+          {
+            low_mass = precursor_mass - precursor_mass_tolerance_;
+            high_mass = precursor_mass + precursor_mass_tolerance_;
+          }
+
+          auto low_it = std::lower_bound(index.peptides.begin(), index.peptides.end(), low_mass,
+            [](const IndexedPeptide_& p, double mass) { return p.mass < mass; });
+          auto up_it = std::upper_bound(low_it, index.peptides.end(), high_mass,
+            [](double mass, const IndexedPeptide_& p) { return mass < p.mass; });
+          if (low_it != up_it)
+          {
+            peptide_ranges.emplace_back(low_it - index.peptides.begin(), up_it - index.peptides.begin());
+          }
+        }
+        if (peptide_ranges.empty()) { continue; }
+
+        // merge overlapping ranges so no peptide is counted twice
+        std::sort(peptide_ranges.begin(), peptide_ranges.end());
+        Size merged(0);
+        for (Size i = 1; i < peptide_ranges.size(); ++i)
+        {
+          if (peptide_ranges[i].first <= peptide_ranges[merged].second)
+          {
+            peptide_ranges[merged].second = std::max(peptide_ranges[merged].second, peptide_ranges[i].second);
+          }
+          else
+          {
+            peptide_ranges[++merged] = peptide_ranges[i];
+          }
+        }
+        peptide_ranges.resize(merged + 1);
+
+        // count the matching peaks of all peptides in the precursor window
+        for (const auto& range : peptide_ranges)
+        {
+          const Size first_slice = range.first / fragment_index_slice_size_;
+          const Size last_slice = (range.second - 1) / fragment_index_slice_size_;
+          for (Size slice = first_slice; slice <= last_slice; ++slice)
+          {
+            const auto slice_begin = index.fragments.begin() + index.slice_begin[slice];
+            const auto slice_end = index.fragments.begin() + index.slice_begin[slice + 1];
+            for (const Peak1D& peak : exp_spectrum)
+            {
+              const double mz = peak.getMZ();
+              const double tolerance = fragment_mass_tolerance_unit_ppm ? Math::ppmToMass(fragment_mass_tolerance_, mz) : fragment_mass_tolerance_;
+              const float mz_high = (float)(mz + tolerance);
+              auto it = std::lower_bound(slice_begin, slice_end, (float)(mz - tolerance),
+                [](const IndexedFragment_& f, float v) { return f.mz < v; });
+              for (; it != slice_end && it->mz <= mz_high; ++it)
+              {
+                if (it->peptide_index < range.first || it->peptide_index >= range.second) { continue; }
+                if (matched_peaks[it->peptide_index]++ == 0)
+                {
+                  matched_peptides.push_back(it->peptide_index);
+                }
+              }
+            }
+          }
+        }
+
+        // keep the peptides with the most matching peaks as candidates
+        candidates.clear();
+        for (UInt32 peptide_index : matched_peptides)
+        {
+          if (matched_peaks[peptide_index] >= fragment_index_min_matched_peaks_)
+          {
+            candidates.push_back(peptide_index);
+          }
+        }
+        const Size n_candidates = std::min(fragment_index_candidates_, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + n_candidates, candidates.end(),
+          [&matched_peaks](UInt32 a, UInt32 b)
+          {
+            if (matched_peaks[a] != matched_peaks[b]) return matched_peaks[a] > matched_peaks[b];
+            return a < b;
+          });
+        candidates.resize(n_candidates);
+
+        for (UInt32 peptide_index : matched_peptides) { matched_peaks[peptide_index] = 0; }
+        matched_peptides.clear();
+
+        // group the candidates by unmodified peptide, so the modified variants of each peptide are created once
+        std::sort(candidates.begin(), candidates.end(), [&index](UInt32 a, UInt32 b)
+          {
+            if (index.peptides[a].sequence_index != index.peptides[b].sequence_index) return index.peptides[a].sequence_index < index.peptides[b].sequence_index;
+            return a < b;
+          });
+
+        // score the candidates
+        Size modified_sequence_index = std::numeric_limits<Size>::max();
+        for (UInt32 peptide_index : candidates)
+        {
+          const IndexedPeptide_& ip = index.peptides[peptide_index];
+          const StringView& sequence = index.sequences[ip.sequence_index];
+
+          // reapply modifications (all modified residues already exist in ResidueDB after building the index)
+          if (ip.sequence_index != modified_sequence_index)
+          {
+            AASequence aas = AASequence::fromString(sequence.getString());
+            all_modified_peptides.clear();
+            ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+            ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
+            modified_sequence_index = ip.sequence_index;
+          }
+
+          PeakSpectrum theo_spectrum;
+          spectrum_generator.getSpectrum(theo_spectrum, all_modified_peptides[ip.peptide_mod_index], 1, 1);
+          theo_spectrum.sortByPosition();
+
+          HyperScore::PSMDetail detail;
+          const double score = HyperScore::computeWithDetail(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum, detail);
+
+          if (score == 0)
+          {
+            continue; // no hit?
+          }
+
+          AnnotatedHit_ ah;
+          ah.sequence = sequence;
+          ah.peptide_mod_index = ip.peptide_mod_index;
+          ah.score = score;
+          ah.prefix_fraction = (double)detail.matched_b_ions/(double)sequence.size();
+          ah.suffix_fraction = (double)detail.matched_y_ions/(double)sequence.size();
+          ah.mean_error = detail.mean_error;
+
+          // each spectrum is only processed by one thread, so no locking is needed
+          annotated_hits[scan_index].push_back(ah);
+          if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
+          {
+            std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
+            annotated_hits[scan_index].resize(report_top_hits_);
+          }
+        }
+      }
+    }
+    endProgress();
+  }
+
+  SimpleSearchEngineAlgorithm::ExitCodes SimpleSearchEngineAlgorithm::search(const String& in_mzML, const String& in_db, vector<ProteinIdentification>& protein_ids, vector<PeptideIdentification>& peptide_ids) const
+  {
     bool precursor_mass_tolerance_unit_ppm = (precursor_mass_tolerance_unit_ == "ppm");
     bool fragment_mass_tolerance_unit_ppm = (fragment_mass_tolerance_unit_ == "ppm");
 
@@ -444,8 +883,8 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     preprocessSpectra_(spectra, fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm);
     endProgress();
 
-    // build multimap of precursor mass to scan index
-    multimap<double, Size> multimap_mass_2_scan_index;
+    // build sorted array of precursor mass to scan index
+    vector<pair<double, Size> > precursor_mass_2_scan_index;
     for (PeakMap::ConstIterator s_it = spectra.begin(); s_it != spectra.end(); ++s_it)
     {
       int scan_index = s_it - spectra.begin();
@@ -472,10 +911,13 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
           // correct for monoisotopic misassignments of the precursor annotation
           if (isotope_number != 0) { precursor_mass -= isotope_number * Constants::C13C12_MASSDIFF_U; }
 
-          multimap_mass_2_scan_index.insert(make_pair(precursor_mass, scan_index));
+          precursor_mass_2_scan_index.emplace_back(precursor_mass, scan_index);
         }
       }
     }
+    // stable, so equal masses are visited in scan order
+    std::stable_sort(precursor_mass_2_scan_index.begin(), precursor_mass_2_scan_index.end(),
+      [](const pair<double, Size>& a, const pair<double, Size>& b) { return a.first < b.first; });
 
     // create spectrum generator
     TheoreticalSpectrumGenerator spectrum_generator;
@@ -488,15 +930,6 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
     vector<vector<AnnotatedHit_> > annotated_hits(spectra.size(), vector<AnnotatedHit_>());
     for (auto & a : annotated_hits) { a.reserve(2 * report_top_hits_); }
 
-#ifdef _OPENMP
-    // we want to do locking at the spectrum level so we get good parallelization
-    vector<omp_lock_t> annotated_hits_lock(annotated_hits.size());
-    for (size_t i = 0; i != annotated_hits_lock.size(); i++)
-    { 
-      omp_init_lock(&(annotated_hits_lock[i]));
-    }
-#endif
-
     vector<FASTAFile::FASTAEntry> fasta_db;
     FASTAFile().load(in_db, fasta_db);
 
@@ -526,153 +959,134 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       endProgress();
       digestor.setMissedCleavages(peptide_missed_cleavages_);
     }
-    startProgress(0, fasta_db.size(), "Scoring peptide models against spectra...");
+    if (fragment_index_)
+    {
+      FragmentIndex_ fragment_index;
+      buildFragmentIndex_(fasta_db, digestor, fixed_modifications, variable_modifications, fragment_index);
+      searchFragmentIndex_(fragment_index, fixed_modifications, variable_modifications, spectra, annotated_hits);
+    }
+    else
+    {
+      // unique peptide sequences of the database (each one is scored once, even if contained in several proteins)
+      vector<StringView> peptides;
+      Size count_digested = digestDatabase_(fasta_db, digestor, peptides);
 
-    // lookup for processed peptides. must be defined outside of omp section and synchronized
-    set<StringView> processed_petides;
+      startProgress(0, peptides.size(), "Scoring peptide models against spectra...");
 
-    Size count_proteins(0), count_peptides(0);
+      Size count_peptides(0);
 
-#pragma omp parallel for schedule(static) default(none) shared(annotated_hits, spectrum_generator, multimap_mass_2_scan_index, fixed_modifications, variable_modifications, fasta_db, digestor, processed_petides, count_proteins, count_peptides, precursor_mass_tolerance_unit_ppm, fragment_mass_tolerance_unit_ppm, peptide_motif_regex, spectra, annotated_hits_lock)
-      for (SignedSize fasta_index = 0; fasta_index < (SignedSize)fasta_db.size(); ++fasta_index)
-      {
+      auto mass_less = [](const pair<double, Size>& a, double mass) { return a.first < mass; };
+      auto less_mass = [](double mass, const pair<double, Size>& a) { return mass < a.first; };
 
-      #pragma omp atomic
-      ++count_proteins;
-
-      IF_MASTERTHREAD
+#pragma omp parallel
       {
-        setProgress(count_proteins);
-      }
+        // hits of this thread as pairs of scan index and hit, merged into annotated_hits after the search
+        vector<pair<Size, AnnotatedHit_> > thread_hits;
+        Size thread_hits_limit = 1 << 16;
 
-      vector<StringView> current_digest;
-      digestor.digestUnmodified(fasta_db[fasta_index].sequence, current_digest, peptide_min_size_, peptide_max_size_);
-
-      for (auto const & c : current_digest)
-      { 
-        const String current_peptide = c.getString();
-        if (current_peptide.find_first_of("XBZ") != std::string::npos)
+#pragma omp for schedule(dynamic, 100) nowait
+        for (SignedSize peptide_index = 0; peptide_index < (SignedSize)peptides.size(); ++peptide_index)
         {
-          continue;
-        }
+          #pragma omp atomic
+          ++count_peptides;
 
-        // if a peptide motif is provided skip all peptides without match
-        if (!peptide_motif_.empty() && !boost::regex_match(current_peptide, peptide_motif_regex))
-        {
-          continue;
-        }          
-      
-        bool already_processed = false;
-        #pragma omp critical (processed_peptides_access)
-        {
-          // peptide (and all modified variants) already processed so skip it
-          if (processed_petides.find(c) != processed_petides.end())
+          IF_MASTERTHREAD
           {
-            already_processed = true;
+            setProgress(count_peptides);
           }
-          else
-          {
-            processed_petides.insert(c);
-          }
-        }
-
-        // skip peptides that have already been processed
-        if (already_processed) { continue; }
-
-        #pragma omp atomic
-        ++count_peptides;
 
-        vector<AASequence> all_modified_peptides;
-
-        // this critical section is because ResidueDB is not thread safe and new residues are created based on the PTMs
-        #pragma omp critical (residuedb_access)
-        {
-          AASequence aas = AASequence::fromString(current_peptide);
-          ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
-          ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
-        }
+          const StringView& c = peptides[peptide_index];
 
-        for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
-        {
-          const AASequence& candidate = all_modified_peptides[mod_pep_idx];
-          double current_peptide_mass = candidate.getMonoWeight();
-
-          // determine MS2 precursors that match to the current peptide mass
-          multimap<double, Size>::const_iterator low_it;
-          multimap<double, Size>::const_iterator up_it;
+          vector<AASequence> all_modified_peptides;
 
-          if (precursor_mass_tolerance_unit_ppm) // ppm
+          // this critical section is because ResidueDB is not thread safe and new residues are created based on the PTMs
+          #pragma omp critical (residuedb_access)
           {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + current_peptide_mass * precursor_mass_tolerance_ * 1e-6);
+            AASequence aas = AASequence::fromString(c.getString());
+            ModifiedPeptideGenerator::applyFixedModifications(fixed_modifications, aas);
+            ModifiedPeptideGenerator::applyVariableModifications(variable_modifications, aas, modifications_max_variable_mods_per_peptide_, all_modified_peptides);
           }
-          else // Dalton
+
+          for (SignedSize mod_pep_idx = 0; mod_pep_idx < (SignedSize)all_modified_peptides.size(); ++mod_pep_idx)
           {
-            low_it = multimap_mass_2_scan_index.lower_bound(current_peptide_mass - precursor_mass_tolerance_);
-            up_it = multimap_mass_2_scan_index.upper_bound(current_peptide_mass + precursor_mass_tolerance_);
-          }
+            const AASequence& candidate = all_modified_peptides[mod_pep_idx];
+            double current_peptide_mass = candidate.getMonoWeight();
 
-          // no matching precursor in data
-          if (low_it == up_it)
-          { 
-            continue;
-          }
+            // determine MS2 precursors that match to the current peptide mass
+            vector<pair<double, Size> >::const_iterator low_it;
+            vector<pair<double, Size> >::const_iterator up_it;
 
-          // create theoretical spectrum
-          PeakSpectrum theo_spectrum;
+            if (precursor_mass_tolerance_unit_ppm) // ppm
+            {
+              low_it = std::lower_bound(precursor_mass_2_scan_index.cbegin(), precursor_mass_2_scan_index.cend(), current_peptide_mass - current_peptide_mass * precursor_mass_tolerance_ * 1e-6, mass_less);
+              up_it = std::upper_bound(low_it, precursor_mass_2_scan_index.cend(), current_peptide_mass + current_peptide_mass * precursor_mass_tolerance_ * 1e-6, less_mass);
+            }
+            else // Dalton
+            {
+              low_it = std::lower_bound(precursor_mass_2_scan_index.cbegin(), precursor_mass_2_scan_index.cend(), current_peptide_mass - precursor_mass_tolerance_, mass_less);
+              up_it = std::upper_bound(low_it, precursor_mass_2_scan_index.cend(), current_peptide_mass + precursor_mass_tolerance_, less_mass);
+            }
 
-          // add peaks for b and y ions with charge 1
-          spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
+            // no matching precursor in data
+            if (low_it == up_it)
+            {
+              continue;
+            }
 
-          // sort by mz
-          theo_spectrum.sortByPosition();
+            // create theoretical spectrum
+            PeakSpectrum theo_spectrum;
 
-          for (; low_it != up_it; ++low_it)
-          {
-            const Size& scan_index = low_it->second;
-            const PeakSpectrum& exp_spectrum = spectra[scan_index];
-            // const int& charge = exp_spectrum.getPrecursors()[0].getCharge();
-            HyperScore::PSMDetail detail;
-            const double& score = HyperScore::computeWithDetail(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum, detail);
-
-            if (score == 0)
-            { 
-              continue; // no hit?
-            }
-            // add peptide hit
-            AnnotatedHit_ ah;
-            ah.sequence = c;
-            ah.peptide_mod_index = mod_pep_idx;
-            ah.score = score;
-            ah.prefix_fraction = (double)detail.matched_b_ions/(double)c.size();
-            ah.suffix_fraction = (double)detail.matched_y_ions/(double)c.size();
-            ah.mean_error = detail.mean_error;            
+            // add peaks for b and y ions with charge 1
+            spectrum_generator.getSpectrum(theo_spectrum, candidate, 1, 1);
 
-#ifdef _OPENMP
-            omp_set_lock(&(annotated_hits_lock[scan_index]));
+            // sort by mz
+            theo_spectrum.sortByPosition();
+
+            for (; low_it != up_it; ++low_it)
             {
-#endif
-              annotated_hits[scan_index].push_back(ah);
+              const Size& scan_index = low_it->second;
+              const PeakSpectrum& exp_spectrum = spectra[scan_index];
+              HyperScore::PSMDetail detail;
+              const double& score = HyperScore::computeWithDetail(fragment_mass_tolerance_, fragment_mass_tolerance_unit_ppm, exp_spectrum, theo_spectrum, detail);
 
-              // prevent vector from growing indefinitely (memory) but don't shrink the vector every time
-              if (annotated_hits[scan_index].size() >= 2 * report_top_hits_)
+              if (score == 0)
               {
-                std::partial_sort(annotated_hits[scan_index].begin(), annotated_hits[scan_index].begin() + report_top_hits_, annotated_hits[scan_index].end(), AnnotatedHit_::hasBetterScore);
-                annotated_hits[scan_index].resize(report_top_hits_); 
+                continue; // no hit?
               }
-#ifdef _OPENMP
+              // add peptide hit
+              AnnotatedHit_ ah;
+              ah.sequence = c;
+              ah.peptide_mod_index = mod_pep_idx;
+              ah.score = score;
+              ah.prefix_fraction = (double)detail.matched_b_ions/(double)c.size();
+              ah.suffix_fraction = (double)detail.matched_y_ions/(double)c.size();
+              ah.mean_error = detail.mean_error;
+
+              thread_hits.emplace_back(scan_index, std::move(ah));
             }
-            omp_unset_lock(&(annotated_hits_lock[scan_index]));
-#endif
+          }
+
+          // prevent the buffer from growing indefinitely (memory) but don't compact it every time
+          if (thread_hits.size() >= thread_hits_limit)
+          {
+            keepTopHitsPerSpectrum_(thread_hits, report_top_hits_);
+            thread_hits_limit = std::max(thread_hits_limit, 2 * thread_hits.size());
           }
         }
+
+        keepTopHitsPerSpectrum_(thread_hits, report_top_hits_);
+#pragma omp critical (annotated_hits_access)
+        for (auto& h : thread_hits)
+        {
+          annotated_hits[h.first].push_back(std::move(h.second));
+        }
       }
-    }
-    endProgress();
+      endProgress();
 
-    OPENMS_LOG_INFO << "Proteins: " << count_proteins << endl;
-    OPENMS_LOG_INFO << "Peptides: " << count_peptides << endl;
-    OPENMS_LOG_INFO << "Processed peptides: " << processed_petides.size() << endl;
+      OPENMS_LOG_INFO << "Proteins: " << fasta_db.size() << endl;
+      OPENMS_LOG_INFO << "Peptides: " << count_digested << endl;
+      OPENMS_LOG_INFO << "Processed peptides: " << peptides.size() << endl;
+    }
 
     startProgress(0, 1, "Post-processing PSMs...");
     SimpleSearchEngineAlgorithm::postProcessHits_(spectra, 
@@ -729,14 +1143,6 @@ void SimpleSearchEngineAlgorithm::postProcessHits_(const PeakMap& exp,
       }
     } 
 
-#ifdef _OPENMP
-    // free locks
-    for (size_t i = 0; i != annotated_hits_lock.size(); i++) 
-    {
-      omp_destroy_lock(&(annotated_hits_lock[i]));
-    }
-#endif
-
     return ExitCodes::EXECUTION_OK;
   }
 
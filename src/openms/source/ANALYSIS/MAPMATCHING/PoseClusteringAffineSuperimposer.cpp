@@ -39,6 +39,10 @@
 
 #include <boost/math/special_functions/fpclassify.hpp> // isnan
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // #define Debug_PoseClusteringAffineSuperimposer
 
 namespace OpenMS
@@ -64,6 +68,14 @@ namespace OpenMS
                                                 "and to disregard weak signals during alignment.  For using all points, set this to -1.");
     defaults_.setMinInt("num_used_points", -1);
 
+    defaults_.setValue("max_pair_candidates", -1, "Maximum number of elements in the scene map (selected by intensity) that each "
+                                                  "element of the model map is paired with (among those within 'mz_pair_max_distance').  "
+                                                  "Pairs are down-weighted by the number of elements in their m/z windows, and windows with "
+                                                  "10 or more elements are skipped; with this cap, a window counts at most this many elements, "
+                                                  "so crowded windows contribute their most intense candidates instead of being skipped.  "
+                                                  "For using all candidates (and skipping crowded windows), set this to -1.  0 is not allowed.", {"advanced"});
+    defaults_.setMinInt("max_pair_candidates", -1);
+
     defaults_.setValue("scaling_bucket_size", 0.005, "The scaling of the retention time "
                                                      "interval is being hashed into buckets of this size during pose "
                                                      "clustering.  A good choice for this would be a bit smaller than the "
@@ -163,8 +175,11 @@ namespace OpenMS
                                    const double total_intensity_ratio,
                                    const double scale_low_1,
                                    const double scale_high_1,
-                                   const double rt_low, const double rt_high)
+                                   const double rt_low, const double rt_high,
+                                   const Int max_pair_candidates)
   {
+    typedef Math::LinearInterpolation<double, double> LinearInterpolationType_;
+
     Size const model_map_size = model_map.size();   // i j
     Size const scene_map_size = scene_map.size();   // k l
 
@@ -177,36 +192,107 @@ namespace OpenMS
       dump_pairs_file << "#" << ' ' << "i" << ' ' << "j" << ' ' << "k" << ' ' << "l" << ' ' << std::endl;
     }
 
+    // Both maps are sorted by m/z: for each point of the model map, find the
+    // window of points in the scene map within the m/z distance.  If the
+    // number of pairs is capped, only the most intense points of the window
+    // are paired (in ascending m/z order, like the whole window).
+    const bool cap_pairs = (max_pair_candidates > 0);
+
+    // weight of a point whose m/z window contains 'count' elements (at most
+    // the cap); points in too crowded windows get a weight <= 0 and are skipped
+    auto winlength_factor = [&](Size count)
+    {
+      if (cap_pairs) count = std::min(count, Size(max_pair_candidates));
+      return 1. / count - winlength_factor_baseline;
+    };
+    std::vector<std::pair<Size, Size> > scene_windows(model_map_size);
+    std::vector<std::vector<Size> > scene_candidates(cap_pairs ? model_map_size : 0);
+    for (Size m = 0; m < model_map_size; ++m)
+    {
+      const double mz = model_map[m].getMZ();
+      scene_windows[m].first = std::lower_bound(scene_map.begin(), scene_map.end(), mz - mz_pair_max_distance,
+        [](const Peak2D& peak, double value) { return peak.getMZ() < value; }) - scene_map.begin();
+      scene_windows[m].second = std::upper_bound(scene_map.begin(), scene_map.end(), mz + mz_pair_max_distance,
+        [](double value, const Peak2D& peak) { return value < peak.getMZ(); }) - scene_map.begin();
+      if (cap_pairs)
+      {
+        std::vector<Size>& candidates = scene_candidates[m];
+        for (Size k = scene_windows[m].first; k < scene_windows[m].second; ++k)
+        {
+          candidates.push_back(k);
+        }
+        if (candidates.size() > Size(max_pair_candidates))
+        {
+          std::nth_element(candidates.begin(), candidates.begin() + max_pair_candidates, candidates.end(),
+            [&scene_map](Size a, Size b)
+            {
+              return scene_map[a].getIntensity() > scene_map[b].getIntensity() ||
+                     (scene_map[a].getIntensity() == scene_map[b].getIntensity() && a < b);
+            });
+          candidates.resize(max_pair_candidates);
+          std::sort(candidates.begin(), candidates.end());
+        }
+      }
+    }
+
+    // Every thread votes into its own copy of the hash tables, these are
+    // summed up afterwards (in the order of the threads, so the result does
+    // not depend on the scheduling).
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (!do_dump_pairs) num_threads = omp_get_max_threads();
+#endif
+    std::vector<std::vector<LinearInterpolationType_> > thread_hashes(num_threads,
+      std::vector<LinearInterpolationType_>{scaling_hash_1, scaling_hash_2, rt_low_hash_, rt_high_hash_});
+    for (std::vector<LinearInterpolationType_>& hashes : thread_hashes)
+    {
+      for (LinearInterpolationType_& hash : hashes)
+      {
+        std::fill(hash.getData().begin(), hash.getData().end(), 0.0);
+      }
+    }
+
     // first point in model map (i)
-    for (Size i = 0, i_low = 0, i_high = 0, k_low = 0, k_high = 0; i < model_map_size - 1; ++i)
+    // (the work per point decreases with i, so distribute the points round robin)
+#pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+    for (SignedSize i_signed = 0; i_signed < SignedSize(model_map_size) - 1; ++i_signed)
     {
-      // Adjust window around i in model map (get all features in a m/z range of item i in the model map)
-      while (i_low < model_map_size && model_map[i_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++i_low;
-      while (i_high < model_map_size && model_map[i_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++i_high;
+      const Size i = i_signed;
+      int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      LinearInterpolationType_& local_scaling_hash_1 = thread_hashes[thread][0];
+      LinearInterpolationType_& local_scaling_hash_2 = thread_hashes[thread][1];
+      LinearInterpolationType_& local_rt_low_hash = thread_hashes[thread][2];
+      LinearInterpolationType_& local_rt_high_hash = thread_hashes[thread][3];
+
+      // Window around i in model map (get all features in a m/z range of item i in the model map)
+      const Size i_low = std::lower_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() - mz_pair_max_distance,
+        [](const Peak2D& peak, double value) { return peak.getMZ() < value; }) - model_map.begin();
+      const Size i_high = std::upper_bound(model_map.begin(), model_map.end(), model_map[i].getMZ() + mz_pair_max_distance,
+        [](double value, const Peak2D& peak) { return value < peak.getMZ(); }) - model_map.begin();
       // stop if there are too many features are in our window
-      double i_winlength_factor = 1. / (i_high - i_low);
-      i_winlength_factor -= winlength_factor_baseline;
+      const double i_winlength_factor = winlength_factor(i_high - i_low);
       if (i_winlength_factor <= 0)
         continue;
 
-      // Adjust window around k in scene map (get all features in a m/z range of item i in the scene map)
-      while (k_low < scene_map_size && scene_map[k_low].getMZ() < model_map[i].getMZ() - mz_pair_max_distance)
-        ++k_low;
-      while (k_high < scene_map_size && scene_map[k_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
-        ++k_high;
+      // Window around k in scene map (get all features in a m/z range of item i in the scene map)
+      const Size k_low = scene_windows[i].first;
+      const Size k_high = scene_windows[i].second;
+
+      // stop if there are too many features are in our window
+      const double k_winlength_factor = winlength_factor(k_high - k_low);
+      if (k_winlength_factor <= 0)
+        continue;
 
       // Iterate through all matching features in the scene map that are
       // within the m/z distance of item i from the model map.
       // first point in scene map (k)
-      for (Size k = k_low; k < k_high; ++k)
+      const Size k_count = cap_pairs ? scene_candidates[i].size() : k_high - k_low;
+      for (Size k_pos = 0; k_pos < k_count; ++k_pos)
       {
-        // stop if there are too many features are in our window
-        double k_winlength_factor = 1. / (k_high - k_low);
-        k_winlength_factor -= winlength_factor_baseline;
-        if (k_winlength_factor <= 0)
-          continue;
+        const Size k = cap_pairs ? scene_candidates[i][k_pos] : k_low + k_pos;
 
         // compute similarity of intensities i k by taking the ratio of the two intensities
         double similarity_ik;
@@ -220,7 +306,7 @@ namespace OpenMS
         }
 
         // second point in model map (j)
-        for (Size j = i + 1, j_low = i_low, j_high = i_low, l_low = k_low, l_high = k_high; j < model_map_size; ++j)
+        for (Size j = i + 1, j_low = i_low, j_high = i_low; j < model_map_size; ++j)
         {
           // diff in model map -> skip features that are too far away in RT
           double diff_model = model_map[j].getRT() - model_map[i].getRT();
@@ -232,24 +318,22 @@ namespace OpenMS
             ++j_low;
           while (j_high < model_map_size && model_map[j_high].getMZ() <= model_map[i].getMZ() + mz_pair_max_distance)
             ++j_high;
-          double j_winlength_factor = 1. / (j_high - j_low);
-          j_winlength_factor -= winlength_factor_baseline;
+          const double j_winlength_factor = winlength_factor(j_high - j_low);
           if (j_winlength_factor <= 0)
             continue;
 
-          // Adjust window around l in scene map
-          while (l_low < scene_map_size && scene_map[l_low].getMZ() < model_map[j].getMZ() - mz_pair_max_distance)
-            ++l_low;
-          while (l_high < scene_map_size && scene_map[l_high].getMZ() <= model_map[j].getMZ() + mz_pair_max_distance)
-            ++l_high;
+          // Window around l in scene map
+          const Size l_low = scene_windows[j].first;
+          const Size l_high = scene_windows[j].second;
+          const double l_winlength_factor = winlength_factor(l_high - l_low);
+          if (l_winlength_factor <= 0)
+            continue;
 
           // second point in scene map (l)
-          for (Size l = l_low; l < l_high; ++l)
+          const Size l_count = cap_pairs ? scene_candidates[j].size() : l_high - l_low;
+          for (Size l_pos = 0; l_pos < l_count; ++l_pos)
           {
-            double l_winlength_factor = 1. / (l_high - l_low);
-            l_winlength_factor -= winlength_factor_baseline;
-            if (l_winlength_factor <= 0)
-              continue;
+            const Size l = cap_pairs ? scene_candidates[j][l_pos] : l_low + l_pos;
 
             // diff in scene map -> skip features that are too far away in RT
             double diff_scene = scene_map[l].getRT() - scene_map[k].getRT();
@@ -283,19 +367,19 @@ namespace OpenMS
             if (hashing_round == 1)
             {
               // hashing round 1 (estimate the scaling only)
-              scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
+              local_scaling_hash_1.addValue(log(scaling), similarity_ik_jl);
             }
             else if (scaling >= scale_low_1 && scaling <= scale_high_1)
             {
               // hashing round 2 (estimate scaling and shift)
-              scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
+              local_scaling_hash_2.addValue(log(scaling), similarity_ik_jl);
 
               const double rt_low_image = shift + rt_low * scaling;
-              rt_low_hash_.addValue(rt_low_image, similarity_ik_jl);
+              local_rt_low_hash.addValue(rt_low_image, similarity_ik_jl);
               const double rt_high_image = shift + rt_high * scaling;
-              rt_high_hash_.addValue(rt_high_image, similarity_ik_jl);
+              local_rt_high_hash.addValue(rt_high_image, similarity_ik_jl);
 
-              if (do_dump_pairs)
+              if (do_dump_pairs) // (only done single-threaded)
               {
                 dump_pairs_file << i << ' ' << model_map[i].getRT() << ' ' << model_map[i].getMZ() << ' ' << j << ' ' << model_map[j].getRT() << ' '
                                 << model_map[j].getMZ() << ' ' << k << ' ' << scene_map[k].getRT() << ' ' << scene_map[k].getMZ() << ' ' << l << ' '
@@ -306,6 +390,21 @@ namespace OpenMS
         }   // j
       }   // k
     }   // i
+
+    // sum up the votes of all threads
+    std::vector<LinearInterpolationType_*> hashes{&scaling_hash_1, &scaling_hash_2, &rt_low_hash_, &rt_high_hash_};
+    for (const std::vector<LinearInterpolationType_>& local_hashes : thread_hashes)
+    {
+      for (Size h = 0; h < hashes.size(); ++h)
+      {
+        std::vector<double>& data = hashes[h]->getData();
+        const std::vector<double>& local_data = local_hashes[h].getData();
+        for (Size b = 0; b < data.size(); ++b)
+        {
+          data[b] += local_data[b];
+        }
+      }
+    }
   }
 
   /**
@@ -768,6 +867,13 @@ namespace OpenMS
     /// Maximum deviation in mz of two partner points
     const double mz_pair_max_distance = param_.getValue("mz_pair_max_distance");
 
+    /// Maximum number of partner points in the scene map for each point of the model map (-1: all)
+    const Int max_pair_candidates = param_.getValue("max_pair_candidates");
+    if (max_pair_candidates == 0)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "'max_pair_candidates' must be -1 (all candidates) or at least 1");
+    }
+
     //**************************************************************************
     // Working variables
     //**************************************************************************
@@ -932,7 +1038,8 @@ namespace OpenMS
       total_intensity_ratio,
       -1, // only used in 2nd round of hashing
       -1, // only used in 2nd round of hashing
-      rt_low, rt_high);
+      rt_low, rt_high,
+      max_pair_candidates);
     setProgress((actual_progress = 30));
 
     ///////////////////////////////////////////////////////////////////
@@ -972,7 +1079,8 @@ namespace OpenMS
       total_intensity_ratio,
       scale_low_1,
       scale_high_1,
-      rt_low, rt_high);
+      rt_low, rt_high,
+      max_pair_candidates);
     setProgress((actual_progress = 50));
 
     ///////////////////////////////////////////////////////////////////
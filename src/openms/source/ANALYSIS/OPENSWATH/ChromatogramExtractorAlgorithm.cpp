@@ -37,7 +37,16 @@
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 #include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace OpenMS
 {
@@ -296,14 +305,141 @@ namespace OpenMS
         "Input to extractChromatogram needs to be sorted by m/z");
     }
 
-    //go through all spectra
+    // Coordinates with a valid RT window are only active for part of the
+    // run. Instead of testing every coordinate against every spectrum, sweep
+    // over the coordinates ordered by rt_start and keep the set of active
+    // coordinates (sorted by their index, i.e. by m/z) up to date. This makes
+    // the cost per spectrum proportional to the number of coordinates that
+    // actually get extracted.
+    std::vector<Size> unbounded_coordinates; // extracted in every spectrum
+    std::vector<Size> coordinates_by_rt_start;
+    for (Size k = 0; k < extraction_coordinates.size(); ++k)
+    {
+      if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0)
+      {
+        coordinates_by_rt_start.push_back(k);
+      }
+      else
+      {
+        unbounded_coordinates.push_back(k);
+      }
+    }
+    std::stable_sort(coordinates_by_rt_start.begin(), coordinates_by_rt_start.end(),
+      [&extraction_coordinates](const Size a, const Size b)
+      {
+        return extraction_coordinates[a].rt_start < extraction_coordinates[b].rt_start;
+      });
+
+    // Unless we are already inside a parallel region (e.g. when several
+    // SWATH maps are extracted concurrently), split the spectra into
+    // consecutive blocks, one per thread. Each thread extracts from its own
+    // light clone of the input; the first block writes directly to the
+    // output, the others are buffered and appended in block order afterwards
+    // which yields the same chromatograms as the serial extraction.
+    int nr_blocks = 1;
+#ifdef _OPENMP
+    if (omp_in_parallel() == 0)
+    {
+      nr_blocks = std::max(1, std::min(omp_get_max_threads(), (int)(input_size / min_spectra_per_thread_)));
+    }
+#endif
+
     startProgress(0, input_size, "Extracting chromatograms");
-    for (Size scan_idx = 0; scan_idx < input_size; ++scan_idx)
+    if (nr_blocks == 1)
     {
-      setProgress(scan_idx);
+      extractSpectrumRange_(*input, 0, input_size, output, nullptr, extraction_coordinates,
+                            unbounded_coordinates, coordinates_by_rt_start,
+                            mz_extraction_window, ppm, im_extraction_window, used_filter, 1);
+      endProgress();
+      return;
+    }
 
-      OpenSwath::SpectrumPtr sptr = input->getSpectrumById(scan_idx);
-      OpenSwath::SpectrumMeta s_meta = input->getSpectrumMetaById(scan_idx);
+    std::vector< std::vector<ExtractedPoint_> > block_results(nr_blocks);
+    std::vector< std::exception_ptr > block_errors(nr_blocks);
+#pragma omp parallel for schedule(static, 1) num_threads(nr_blocks)
+    for (int block = 0; block < nr_blocks; ++block)
+    {
+      try
+      {
+        Size scan_begin = input_size * block / nr_blocks;
+        Size scan_end = input_size * (block + 1) / nr_blocks;
+        OpenSwath::SpectrumAccessPtr block_input = input->lightClone();
+        extractSpectrumRange_(*block_input, scan_begin, scan_end, output,
+                              block == 0 ? nullptr : &block_results[block], extraction_coordinates,
+                              unbounded_coordinates, coordinates_by_rt_start,
+                              mz_extraction_window, ppm, im_extraction_window, used_filter,
+                              block == 0 ? nr_blocks : 0);
+      }
+      catch (...)
+      {
+        block_errors[block] = std::current_exception();
+      }
+    }
+    // re-throw the error of the earliest block, as the serial extraction would
+    for (int block = 0; block < nr_blocks; ++block)
+    {
+      if (block_errors[block])
+      {
+        std::rethrow_exception(block_errors[block]);
+      }
+    }
+
+    // append the data of all further blocks in block (= spectrum) order
+    std::vector<Size> nr_points(output.size(), 0);
+    for (const auto& points : block_results)
+    {
+      for (const auto& p : points)
+      {
+        ++nr_points[p.coordinate];
+      }
+    }
+    for (Size k = 0; k < output.size(); ++k)
+    {
+      if (nr_points[k] == 0) continue;
+      output[k]->getTimeArray()->data.reserve(output[k]->getTimeArray()->data.size() + nr_points[k]);
+      output[k]->getIntensityArray()->data.reserve(output[k]->getIntensityArray()->data.size() + nr_points[k]);
+    }
+    for (auto& points : block_results)
+    {
+      for (const auto& p : points)
+      {
+        output[p.coordinate]->getTimeArray()->data.push_back(p.rt);
+        output[p.coordinate]->getIntensityArray()->data.push_back(p.intensity);
+      }
+      std::vector<ExtractedPoint_>().swap(points);
+    }
+    endProgress();
+  }
+
+  void ChromatogramExtractorAlgorithm::extractSpectrumRange_(OpenSwath::ISpectrumAccess& input,
+      const Size scan_begin,
+      const Size scan_end,
+      std::vector< OpenSwath::ChromatogramPtr >& output,
+      std::vector<ExtractedPoint_>* buffer,
+      const std::vector<ExtractionCoordinates>& extraction_coordinates,
+      const std::vector<Size>& unbounded_coordinates,
+      const std::vector<Size>& coordinates_by_rt_start,
+      const double mz_extraction_window,
+      const bool ppm,
+      const double im_extraction_window,
+      const int used_filter,
+      const int progress_factor)
+  {
+    std::vector<Size> active_coordinates = unbounded_coordinates;
+    std::vector<Size> new_coordinates, merged_coordinates;
+    Size next_by_rt_start = 0;
+    double last_rt = -std::numeric_limits<double>::max();
+
+    //go through all spectra
+    for (Size scan_idx = scan_begin; scan_idx < scan_end; ++scan_idx)
+    {
+      if (progress_factor > 0)
+      {
+        setProgress(scan_idx * progress_factor);
+      }
+
+      OpenSwath::SpectrumPtr sptr = input.getSpectrumById(scan_idx);
+      OpenSwath::SpectrumMeta s_meta = input.getSpectrumMetaById(scan_idx);
 
       OpenSwath::BinaryDataArrayPtr mz_arr = sptr->getMZArray();
       OpenSwath::BinaryDataArrayPtr int_arr = sptr->getIntensityArray();
@@ -334,20 +470,43 @@ namespace OpenMS
         }
       }
 
-      // go through all transitions / chromatograms which are sorted by
+      // update the set of coordinates whose RT window contains the current
+      // spectrum (restart the sweep if spectra are not ordered by RT)
+      const double current_rt = s_meta.RT;
+      if (current_rt < last_rt)
+      {
+        active_coordinates = unbounded_coordinates;
+        next_by_rt_start = 0;
+      }
+      last_rt = current_rt;
+
+      new_coordinates.clear();
+      while (next_by_rt_start < coordinates_by_rt_start.size() &&
+             extraction_coordinates[coordinates_by_rt_start[next_by_rt_start]].rt_start <= current_rt)
+      {
+        new_coordinates.push_back(coordinates_by_rt_start[next_by_rt_start]);
+        ++next_by_rt_start;
+      }
+      std::sort(new_coordinates.begin(), new_coordinates.end());
+      merged_coordinates.clear();
+      std::merge(active_coordinates.begin(), active_coordinates.end(),
+                 new_coordinates.begin(), new_coordinates.end(),
+                 std::back_inserter(merged_coordinates));
+      merged_coordinates.erase(std::remove_if(merged_coordinates.begin(), merged_coordinates.end(),
+        [&extraction_coordinates, current_rt](const Size k)
+        {
+          return extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
+                 current_rt > extraction_coordinates[k].rt_end;
+        }), merged_coordinates.end());
+      active_coordinates.swap(merged_coordinates);
+
+      // go through all active transitions / chromatograms which are sorted by
       // ProductMZ. We can use this to step through the spectrum and at the
       // same time step through the transitions. We increase the peak counter
       // until we hit the next transition and then extract the signal.
-      for (Size k = 0; k < extraction_coordinates.size(); ++k)
+      for (const Size k : active_coordinates)
       {
         double integrated_intensity = 0;
-        double current_rt = s_meta.RT;
-        if (extraction_coordinates[k].rt_end - extraction_coordinates[k].rt_start > 0 &&
-             (current_rt < extraction_coordinates[k].rt_start ||
-              current_rt > extraction_coordinates[k].rt_end) )
-        {
-          continue;
-        }
 
         const bool use_im = (extraction_coordinates[k].ion_mobility >= 0.0 && has_im);
         if (!use_im && used_filter == 1)
@@ -370,11 +529,17 @@ namespace OpenMS
           throw Exception::NotImplemented(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION);
         }
 
-        output[k]->getTimeArray()->data.push_back(current_rt);
-        output[k]->getIntensityArray()->data.push_back(integrated_intensity);
+        if (buffer != nullptr)
+        {
+          buffer->push_back({k, current_rt, integrated_intensity});
+        }
+        else
+        {
+          output[k]->getTimeArray()->data.push_back(current_rt);
+          output[k]->getIntensityArray()->data.push_back(integrated_intensity);
+        }
       }
     }
-    endProgress();
   }
 
   int ChromatogramExtractorAlgorithm::getFilterNr_(const String& filter)
@@ -68,6 +68,15 @@ namespace OpenMS
     int ms_level = -1;
     double rt = -1.0;
 
+    if (mapped_file_)
+    {
+      Size available;
+      const char* data = getMappedData_(spectra_index_[id], available);
+      OpenSwath::SpectrumPtr sptr(new OpenSwath::Spectrum);
+      sptr->getDataArrays() = Internal::CachedMzMLHandler::readSpectrumFast(data, available, ms_level, rt);
+      return sptr;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -98,6 +107,15 @@ namespace OpenMS
     OPENMS_PRECONDITION(id >= 0, "Id needs to be larger than zero");
     OPENMS_PRECONDITION(id < (int)getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    if (mapped_file_)
+    {
+      Size available;
+      const char* data = getMappedData_(chrom_index_[id], available);
+      OpenSwath::ChromatogramPtr cptr(new OpenSwath::Chromatogram);
+      cptr->getDataArrays() = Internal::CachedMzMLHandler::readChromatogramFast(data, available);
+      return cptr;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -37,7 +37,6 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
 
-#include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
 #include <OpenMS/OPENSWATHALGO/ALGO/StatsHelpers.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SpectrumHelpers.h> // integrateWindow
@@ -119,6 +118,8 @@ namespace OpenMS
     dia_nr_isotopes_ = (int)param_.getValue("dia_nr_isotopes");
     dia_nr_charges_ = (int)param_.getValue("dia_nr_charges");
     peak_before_mono_max_ppm_diff_ = (double)param_.getValue("peak_before_mono_max_ppm_diff");
+
+    prescore_ = DiaPrescore(dia_extract_window_, dia_nr_isotopes_, dia_nr_charges_);
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -127,12 +128,52 @@ namespace OpenMS
   void DIAScoring::dia_isotope_scores(const std::vector<TransitionType>& transitions, SpectrumPtrType spectrum,
                                       OpenSwath::IMRMFeature* mrmfeature, double& isotope_corr, double& isotope_overlap) const
   {
+    TransitionData transition_data;
+    prepareTransitionData(transitions, transition_data);
+    dia_isotope_scores(transitions, transition_data, spectrum, mrmfeature, isotope_corr, isotope_overlap);
+  }
+
+  void DIAScoring::dia_isotope_scores(const std::vector<TransitionType>& transitions, const TransitionData& transition_data,
+                                      SpectrumPtrType spectrum, OpenSwath::IMRMFeature* mrmfeature,
+                                      double& isotope_corr, double& isotope_overlap) const
+  {
+    OPENMS_PRECONDITION(transitions.size() == transition_data.product_mz.size(), "Transition data needs to be prepared from the same transitions");
     isotope_corr = 0;
     isotope_overlap = 0;
-    // first compute a map of relative intensities from the feature, then compute the score
-    std::map<std::string, double> intensities;
+    // first compute the relative intensities from the feature, then compute the score
+    std::vector<double> intensities;
     getFirstIsotopeRelativeIntensities_(transitions, mrmfeature, intensities);
-    diaIsotopeScoresSub_(transitions, spectrum, intensities, isotope_corr, isotope_overlap);
+    diaIsotopeScoresSub_(transition_data, spectrum, intensities, isotope_corr, isotope_overlap);
+  }
+
+  void DIAScoring::prepareTransitionData(const std::vector<TransitionType>& transitions,
+                                         TransitionData& transition_data) const
+  {
+    transition_data.nr_isotopes = static_cast<Size>(dia_nr_isotopes_) + 1;
+    transition_data.product_mz.clear();
+    transition_data.fragment_charge.clear();
+    transition_data.isotope_patterns.clear();
+    transition_data.product_mz.reserve(transitions.size());
+    transition_data.fragment_charge.reserve(transitions.size());
+    transition_data.isotope_patterns.reserve(transitions.size() * transition_data.nr_isotopes);
+
+    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
+    for (const auto& tr : transitions)
+    {
+      // If no charge is given, we assume it to be 1
+      int putative_fragment_charge = 1;
+      if (tr.fragment_charge != 0)
+      {
+        putative_fragment_charge = tr.fragment_charge;
+      }
+      transition_data.product_mz.push_back(tr.getProductMZ());
+      transition_data.fragment_charge.push_back(putative_fragment_charge);
+
+      // create the theoretical distribution from the peptide weight
+      // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
+      appendScaledIsotopePattern_(solver.estimateFromPeptideWeight(std::fabs(tr.getProductMZ() * putative_fragment_charge)),
+                                  transition_data.isotope_patterns);
+    }
   }
 
   void DIAScoring::dia_massdiff_score(const std::vector<TransitionType>& transitions,
@@ -298,8 +339,7 @@ namespace OpenMS
   void DIAScoring::score_with_isotopes(SpectrumPtrType spectrum, const std::vector<TransitionType>& transitions,
                                        double& dotprod, double& manhattan) const
   {
-    OpenMS::DiaPrescore dp(dia_extract_window_, dia_nr_isotopes_, dia_nr_charges_);
-    dp.score(spectrum, transitions, dotprod, manhattan);
+    prescore_.score(spectrum, transitions, dotprod, manhattan);
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -308,54 +348,47 @@ namespace OpenMS
   /// computes a vector of relative intensities for each feature (output to intensities)
   void DIAScoring::getFirstIsotopeRelativeIntensities_(
     const std::vector<TransitionType>& transitions,
-    OpenSwath::IMRMFeature* mrmfeature, std::map<std::string, double>& intensities) const
+    OpenSwath::IMRMFeature* mrmfeature, std::vector<double>& intensities) const
   {
-    for (Size k = 0; k < transitions.size(); k++)
+    intensities.clear();
+    intensities.reserve(transitions.size());
+    const double feature_intensity = mrmfeature->getIntensity();
+    for (const auto& tr : transitions)
     {
-      std::string native_id = transitions[k].getNativeID();
-      double rel_intensity = mrmfeature->getFeature(native_id)->getIntensity() / mrmfeature->getIntensity();
-      intensities.insert(std::pair<std::string, double>(native_id, rel_intensity));
+      intensities.push_back(mrmfeature->getFeature(tr.getNativeID())->getIntensity() / feature_intensity);
     }
   }
 
-  void DIAScoring::diaIsotopeScoresSub_(const std::vector<TransitionType>& transitions, SpectrumPtrType spectrum,
-                                        std::map<std::string, double>& intensities, //relative intensities
+  void DIAScoring::diaIsotopeScoresSub_(const TransitionData& transition_data, SpectrumPtrType spectrum,
+                                        const std::vector<double>& intensities, //relative intensities
                                         double& isotope_corr,
                                         double& isotope_overlap) const
   {
-    std::vector<double> isotopes_int;
+    std::vector<double> isotopes_int(transition_data.nr_isotopes);
     double max_ratio;
     int nr_occurences;
-    for (Size k = 0; k < transitions.size(); k++)
+    for (Size k = 0; k < transition_data.product_mz.size(); k++)
     {
-      isotopes_int.clear();
-      const String native_id = transitions[k].getNativeID();
-      double rel_intensity = intensities[native_id];
-
-      // If no charge is given, we assume it to be 1
-      int putative_fragment_charge = 1;
-      if (transitions[k].fragment_charge != 0)
-      {
-        putative_fragment_charge = transitions[k].fragment_charge;
-      }
+      const double product_mz = transition_data.product_mz[k];
+      const double rel_intensity = intensities[k];
 
       // collect the potential isotopes of this peak
-      double abs_charge = std::fabs(static_cast<double>(putative_fragment_charge));
-      for (int iso = 0; iso <= dia_nr_isotopes_; ++iso)
+      double abs_charge = std::fabs(static_cast<double>(transition_data.fragment_charge[k]));
+      for (Size iso = 0; iso < transition_data.nr_isotopes; ++iso)
       {
-        double left = transitions[k].getProductMZ() + iso * C13C12_MASSDIFF_U / abs_charge;
+        double left = product_mz + iso * C13C12_MASSDIFF_U / abs_charge;
         double right = left;
         DIAHelpers::adjustExtractionWindow(right, left, dia_extract_window_, dia_extraction_ppm_);
         double mz, intensity;
         DIAHelpers::integrateWindow(spectrum, left, right, mz, intensity, dia_centroided_);
-        isotopes_int.push_back(intensity);
+        isotopes_int[iso] = intensity;
       }
 
       // calculate the scores:
       // isotope correlation (forward) and the isotope overlap (backward) scores
-      double score = scoreIsotopePattern_(isotopes_int, transitions[k].getProductMZ(), putative_fragment_charge);
+      double score = scoreIsotopePattern_(isotopes_int, transition_data.isotope_patterns.begin() + k * transition_data.nr_isotopes);
       isotope_corr += score * rel_intensity;
-      largePeaksBeforeFirstIsotope_(spectrum, transitions[k].getProductMZ(), isotopes_int[0], nr_occurences, max_ratio);
+      largePeaksBeforeFirstIsotope_(spectrum, product_mz, isotopes_int[0], nr_occurences, max_ratio);
       isotope_overlap += nr_occurences * rel_intensity;
     }
   }
@@ -409,22 +442,6 @@ namespace OpenMS
     }
   }
 
-  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
-                                          double product_mz,
-                                          int putative_fragment_charge) const
-  {
-    OPENMS_PRECONDITION(putative_fragment_charge != 0, "Charge needs to be set to != 0"); // charge can be positive and negative
-
-    IsotopeDistribution isotope_dist;
-
-    // create the theoretical distribution from the peptide weight
-    CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
-    // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
-    isotope_dist = solver.estimateFromPeptideWeight(std::fabs(product_mz * putative_fragment_charge));
-
-    return scoreIsotopePattern_(isotopes_int, isotope_dist);
-  } //end of dia_isotope_corr_sub
-
   double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
                                           const EmpiricalFormula& empf) const
   {
@@ -435,41 +452,48 @@ namespace OpenMS
   double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
                                           const IsotopeDistribution& isotope_dist) const
   {
-    typedef OpenMS::FeatureFinderAlgorithmPickedHelperStructs::TheoreticalIsotopePattern TheoreticalIsotopePattern;
+    std::vector<double> theoretical_int;
+    appendScaledIsotopePattern_(isotope_dist, theoretical_int);
+    return scoreIsotopePattern_(isotopes_int, theoretical_int.begin());
+  }
 
-    TheoreticalIsotopePattern isotopes;
+  double DIAScoring::scoreIsotopePattern_(const std::vector<double>& isotopes_int,
+                                          std::vector<double>::const_iterator theoretical_int) const
+  {
+    // score the pattern against a theoretical one
+    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), theoretical_int);
+    if (std::isnan(int_score))
+    {
+      int_score = 0;
+    }
+    return int_score;
+  } //end of dia_isotope_corr_sub
 
+  void DIAScoring::appendScaledIsotopePattern_(const IsotopeDistribution& isotope_dist,
+                                               std::vector<double>& intensities) const
+  {
+    const Size start = intensities.size();
     for (IsotopeDistribution::ConstIterator it = isotope_dist.begin(); it != isotope_dist.end(); ++it)
     {
-      isotopes.intensity.push_back(it->getIntensity());
+      intensities.push_back(it->getIntensity());
     }
-    isotopes.optional_begin = 0;
-    isotopes.optional_end = dia_nr_isotopes_;
 
     // scale the distribution to a maximum of 1
     double max = 0.0;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = start; i < intensities.size(); ++i)
     {
-      if (isotopes.intensity[i] > max)
+      if (intensities[i] > max)
       {
-        max = isotopes.intensity[i];
+        max = intensities[i];
       }
     }
-    isotopes.max = max;
     if (max == 0.) max = 1.;
-    for (Size i = 0; i < isotopes.intensity.size(); ++i)
+    for (Size i = start; i < intensities.size(); ++i)
     {
-      isotopes.intensity[i] /= max;
+      intensities[i] /= max;
     }
-    isotopes.trimmed_left = 0;
 
-    // score the pattern against a theoretical one
-    OPENMS_POSTCONDITION(isotopes_int.size() == isotopes.intensity.size(), "Vectors for pearson correlation do not have the same size.");
-    double int_score = OpenSwath::cor_pearson(isotopes_int.begin(), isotopes_int.end(), isotopes.intensity.begin());
-    if (std::isnan(int_score))
-    {
-      int_score = 0;
-    }
-    return int_score;
-  } //end of dia_isotope_corr_sub
+    // the experimental pattern always has dia_nr_isotopes + 1 entries
+    intensities.resize(start + static_cast<Size>(dia_nr_isotopes_) + 1, 0.0);
+  }
 }
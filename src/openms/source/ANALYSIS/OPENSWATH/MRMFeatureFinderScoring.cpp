@@ -52,6 +52,10 @@
 #include <boost/make_shared.hpp>
 #include <boost/foreach.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define run_identifier "unique_run_identifier"
 
 bool SortDoubleDoublePairFirst(const std::pair<double, double>& left, const std::pair<double, double>& right)
@@ -87,7 +91,8 @@ namespace OpenMS
 
   MRMFeatureFinderScoring::MRMFeatureFinderScoring() :
     DefaultParamHandler("MRMFeatureFinderScoring"),
-    ProgressLogger()
+    ProgressLogger(),
+    spectrum_cache_(new OpenSwathSpectrumCache())
   {
     defaults_.setValue("stop_report_after_feature", -1, "Stop reporting after feature (ordered by quality; -1 means do not stop).");
     defaults_.setValue("rt_extraction_window", -1.0, "Only extract RT around this value (-1 means extract over the whole range, a value of 500 means to extract around +/- 500 s of the expected elution). For this to work, the TraML input file needs to contain normalized RT values.");
@@ -231,7 +236,13 @@ namespace OpenMS
     {
       if (!trgroup.second.getChromatograms().empty()) {counter++; }
     }
-    OPENMS_LOG_INFO << "Will analyse " << counter << " peptides with a total of " << transition_exp.getTransitions().size() << " transitions " << std::endl;
+    // stay quiet if many experiments are picked in parallel (e.g. the chunks in FeatureFinderIdentification)
+#ifdef _OPENMP
+    if (!omp_in_parallel())
+#endif
+    {
+      OPENMS_LOG_INFO << "Will analyse " << counter << " peptides with a total of " << transition_exp.getTransitions().size() << " transitions " << std::endl;
+    }
 
     //
     // Step 3
@@ -553,12 +564,20 @@ namespace OpenMS
                       im_extra_drift_,
                       su_,
                       spectrum_addition_method_);
+    scorer.setSpectrumCache(spectrum_cache_);
 
     ProteaseDigestion pd;
     pd.setEnzyme("Trypsin");
 
     auto& mrmfeatures = transition_group_detection.getFeaturesMuteable();
 
+    // the theoretical isotope patterns are the same for all peak groups
+    DIAScoring::TransitionData transition_data;
+    if (!swath_maps.empty() && su_.use_dia_scores_ && su_.use_ms2_isotope_scores)
+    {
+      diascoring_.prepareTransitionData(transition_group_detection.getTransitions(), transition_data);
+    }
+
     // Go through all peak groups (found MRM features) and score them
     #ifdef _OPENMP
     int in_parallel = omp_in_parallel();
@@ -704,7 +723,8 @@ namespace OpenMS
           scorer.calculateDIAScores(imrmfeature,
                                     transition_group_detection.getTransitions(),
                                     swath_maps, ms1_map_, diascoring_, *pep, scores, masserror_ppm,
-                                    drift_lower, drift_upper, drift_target);
+                                    drift_lower, drift_upper, drift_target,
+                                    su_.use_ms2_isotope_scores ? &transition_data : nullptr);
           mrmfeature.setMetaValue("masserror_ppm", masserror_ppm);
         }
         if (sonar_present && su_.use_sonar_scores)
@@ -1048,6 +1068,9 @@ namespace OpenMS
     sn_bin_count_ = (unsigned int)param_.getValue("TransitionGroupPicker:PeakPickerMRM:sn_bin_count");
     write_log_messages_ = (bool)param_.getValue("TransitionGroupPicker:PeakPickerMRM:write_sn_log_messages").toBool();
 
+    // cached spectra may have been added up with different settings
+    spectrum_cache_->clear();
+
     // set SONAR values
     Param p = sonarscoring_.getDefaults();
     p.setValue("dia_extraction_window", param_.getValue("DIAScoring:dia_extraction_window"));
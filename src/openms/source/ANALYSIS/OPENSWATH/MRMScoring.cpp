@@ -47,32 +47,103 @@ namespace OpenSwath
 
     const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrMatrix() const
     {
+      // the matrix is assembled on demand, so concurrent calls (e.g. on a shared const object) have to be serialized
+#pragma omp critical (MRMScoring_getXCorrMatrix)
+      {
+        if (!xcorr_matrix_valid_)
+        {
+          const std::size_t n = xcorr_flat_traces_;
+          const int max_delay = static_cast<int>(xcorr_flat_length_);
+          const std::size_t nr_lags = 2 * xcorr_flat_length_ + 1;
+          xcorr_matrix_ = XCorrMatrixType(n, n);
+          std::vector<double>::const_iterator pair_it = xcorr_flat_.begin();
+          for (std::size_t i = 0; i < n; i++)
+          {
+            for (std::size_t j = i; j < n; j++, pair_it += nr_lags)
+            {
+              Scoring::XCorrArrayType& array = xcorr_matrix_.getValue(i, j);
+              array.data.reserve(nr_lags);
+              for (int delay = -max_delay; delay <= max_delay; delay++)
+              {
+                array.data.emplace_back(delay, *(pair_it + (delay + max_delay)));
+              }
+            }
+          }
+          xcorr_matrix_valid_ = true;
+        }
+      }
       return xcorr_matrix_;
     }
 
-    void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
+    void MRMScoring::computeXCorrMatrix_(const std::vector<double>& traces, std::size_t n_traces, std::size_t trace_length)
     {
-      xcorr_matrix_.resize(data.size(), data.size());
-      xcorr_matrix_max_peak_.resize(data.size(), data.size());
-      xcorr_matrix_max_peak_sec_.resize(data.size(), data.size());
+      OPENSWATH_PRECONDITION(traces.size() == n_traces * trace_length, "All traces need to have the same length");
+
+      // all lags from -trace_length to trace_length (as used by initializeXCorrMatrix)
+      const std::size_t nr_lags = 2 * trace_length + 1;
+      xcorr_flat_traces_ = n_traces;
+      xcorr_flat_length_ = trace_length;
+      xcorr_flat_.assign(n_traces * (n_traces + 1) / 2 * nr_lags, 0.0);
+      xcorr_matrix_valid_ = false;
+
+      xcorr_matrix_max_peak_.resize(n_traces, n_traces);
+      xcorr_matrix_max_peak_sec_.resize(n_traces, n_traces);
 
-      std::vector< std::vector< double > > tmp_data = data;
-      for (std::size_t i = 0; i < tmp_data.size(); i++)
+      double* pair_xcorr = xcorr_flat_.data();
+      for (std::size_t i = 0; i < n_traces; i++)
       {
-        Scoring::standardize_data(tmp_data[i]);
+        const double* x = traces.data() + i * trace_length;
+        for (std::size_t j = i; j < n_traces; j++, pair_xcorr += nr_lags)
+        {
+          const double* y = traces.data() + j * trace_length;
+
+          // The correlation at lag d is the sum of x[k] * y[k + d]. Instead of
+          // one dot product per lag, x[k] is multiplied with all of y and added
+          // to the lags k + d = 0 ... trace_length - 1. The inner loop has no
+          // branches and vectorizes, and every lag still accumulates its
+          // products in order of increasing k (exactly like
+          // Scoring::calculateCrossCorrelation).
+          for (std::size_t k = 0; k < trace_length; k++)
+          {
+            const double xk = x[k];
+            double* lag = pair_xcorr + (trace_length - k); // lag d is stored at d + trace_length
+            for (std::size_t m = 0; m < trace_length; m++)
+            {
+              lag[m] += xk * y[m];
+            }
+          }
+
+          // normalize and find the highest apex (the first one in case of ties, see Scoring::xcorrArrayGetMaxPeak)
+          std::size_t max_idx = 0;
+          for (std::size_t l = 0; l < nr_lags; l++)
+          {
+            pair_xcorr[l] /= trace_length;
+            if (pair_xcorr[l] > pair_xcorr[max_idx])
+            {
+              max_idx = l;
+            }
+          }
+          xcorr_matrix_max_peak_.setValue(i, j, std::abs(static_cast<int>(max_idx) - static_cast<int>(trace_length)));
+          xcorr_matrix_max_peak_sec_.setValue(i, j, pair_xcorr[max_idx]);
+        }
       }
+    }
+
+    void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
+    {
+      const std::size_t trace_length = data.empty() ? 0 : data[0].size();
 
+      // standardize each trace once and store all of them in one buffer
+      std::vector<double> traces;
+      traces.reserve(data.size() * trace_length);
+      std::vector<double> tmp;
       for (std::size_t i = 0; i < data.size(); i++)
       {
-        for (std::size_t j = i; j < data.size(); j++)
-        {
-          // compute normalized cross correlation
-          xcorr_matrix_.setValue(i, j, Scoring::normalizedCrossCorrelationPost(tmp_data[i], tmp_data[j], static_cast<int>(data[i].size()), 1));
-          auto x = Scoring::xcorrArrayGetMaxPeak(xcorr_matrix_.getValue(i, j));
-          xcorr_matrix_max_peak_.setValue(i, j, std::abs(x->first));
-          xcorr_matrix_max_peak_sec_.setValue(i, j, x->second);
-        }
+        tmp = data[i];
+        Scoring::standardize_data(tmp);
+        traces.insert(traces.end(), tmp.begin(), tmp.end());
       }
+      computeXCorrMatrix_(traces, data.size(), trace_length);
     }
 
     const MRMScoring::XCorrMatrixType& MRMScoring::getXCorrContrastMatrix() const
@@ -112,27 +183,23 @@ namespace OpenSwath
 
     void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& native_ids)
     {
-      std::vector<std::vector<double>> intensity;
-      fillIntensityFromFeature(mrmfeature, native_ids, intensity);
-      for (std::size_t i = 0; i < intensity.size(); i++)
-      {
-        Scoring::standardize_data(intensity[i]);
-      }
-
-      xcorr_matrix_.resize(native_ids.size(), native_ids.size());
-      xcorr_matrix_max_peak_.resize(native_ids.size(), native_ids.size());
-      xcorr_matrix_max_peak_sec_.resize(native_ids.size(), native_ids.size());
+      // standardize each trace once and store all of them in one buffer
+      std::vector<double> traces;
+      std::vector<double> intensity;
+      std::size_t trace_length = 0;
       for (std::size_t i = 0; i < native_ids.size(); i++)
       {
-        for (std::size_t j = i; j < native_ids.size(); j++)
+        intensity.clear(); // getIntensity appends
+        mrmfeature->getFeature(native_ids[i])->getIntensity(intensity);
+        Scoring::standardize_data(intensity);
+        if (i == 0)
         {
-          // compute normalized cross correlation
-          xcorr_matrix_.setValue(i, j, Scoring::normalizedCrossCorrelationPost(intensity[i], intensity[j], static_cast<int>(intensity[i].size()), 1));
-          auto x = Scoring::xcorrArrayGetMaxPeak(xcorr_matrix_.getValue(i, j));
-          xcorr_matrix_max_peak_.setValue(i, j, std::abs(x->first));
-          xcorr_matrix_max_peak_sec_.setValue(i, j, x->second);
+          trace_length = intensity.size();
+          traces.reserve(native_ids.size() * trace_length);
         }
+        traces.insert(traces.end(), intensity.begin(), intensity.end());
       }
+      computeXCorrMatrix_(traces, native_ids.size(), trace_length);
     }
 
     void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<std::string>& native_ids_set1, const std::vector<std::string>& native_ids_set2)
@@ -95,6 +95,70 @@ namespace OpenMS
 namespace OpenMS
 {
 
+  OpenSwathSpectrumCache::OpenSwathSpectrumCache(Size capacity) :
+    capacity_(capacity)
+  {
+  }
+
+  OpenSwath::SpectrumPtr OpenSwathSpectrumCache::get(const OpenSwath::SpectrumAccessPtr& swath_map,
+                                                     int spectrum_idx, int nr_spectra_to_add, double drift_lower, double drift_upper)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(Key_(swath_map.get(), spectrum_idx, nr_spectra_to_add, drift_lower, drift_upper));
+    if (it == index_.end())
+    {
+      return OpenSwath::SpectrumPtr();
+    }
+    // the map at this address may have been destroyed and replaced by another one
+    if (it->second->swath_map.expired())
+    {
+      entries_.erase(it->second);
+      index_.erase(it);
+      return OpenSwath::SpectrumPtr();
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->spectrum;
+  }
+
+  void OpenSwathSpectrumCache::insert(const OpenSwath::SpectrumAccessPtr& swath_map,
+                                      int spectrum_idx, int nr_spectra_to_add, double drift_lower, double drift_upper,
+                                      const OpenSwath::SpectrumPtr& spectrum)
+  {
+    if (capacity_ == 0) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Key_ key(swath_map.get(), spectrum_idx, nr_spectra_to_add, drift_lower, drift_upper);
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+      // another thread added up the same spectrum in the meantime
+      it->second->swath_map = swath_map;
+      it->second->spectrum = spectrum;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    if (entries_.size() >= capacity_)
+    {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+    entries_.push_front(Entry_{key, swath_map, spectrum});
+    index_[key] = entries_.begin();
+  }
+
+  Size OpenSwathSpectrumCache::size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  void OpenSwathSpectrumCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
   /// Constructor
   OpenSwathScoring::OpenSwathScoring() :
     rt_normalization_factor_(1.0),
@@ -125,6 +189,11 @@ namespace OpenMS
     this->su_ = su;
   }
 
+  void OpenSwathScoring::setSpectrumCache(boost::shared_ptr<OpenSwathSpectrumCache> cache)
+  {
+    spectrum_cache_ = cache;
+  }
+
   void OpenSwathScoring::calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature,
                                             const std::vector<TransitionType>& transitions,
                                             const std::vector<OpenSwath::SwathMap>& swath_maps,
@@ -135,7 +204,8 @@ namespace OpenMS
                                             std::vector<double>& masserror_ppm,
                                             const double drift_lower,
                                             const double drift_upper,
-                                            const double drift_target)
+                                            const double drift_target,
+                                            const DIAScoring::TransitionData* transition_data)
   {
     OPENMS_PRECONDITION(imrmfeature != nullptr, "Feature to be scored cannot be null");
     OPENMS_PRECONDITION(transitions.size() > 0, "There needs to be at least one transition.");
@@ -198,8 +268,14 @@ namespace OpenMS
       // Currently this is computed for an averagine model of a peptide so its
       // not optimal for metabolites - but better than nothing, given that for
       // most fragments we don't really know their composition
-      diascoring
-          .dia_isotope_scores(transitions, spectrum, imrmfeature, scores.isotope_correlation, scores.isotope_overlap);
+      if (transition_data)
+      {
+        diascoring.dia_isotope_scores(transitions, *transition_data, spectrum, imrmfeature, scores.isotope_correlation, scores.isotope_overlap);
+      }
+      else
+      {
+        diascoring.dia_isotope_scores(transitions, spectrum, imrmfeature, scores.isotope_correlation, scores.isotope_overlap);
+      }
     }
 
     // Peptide-specific scores (only useful, when product transitions are REAL fragments, e.g. not in FFID)
@@ -538,7 +614,7 @@ namespace OpenMS
     return getAddedSpectra_(swath_map, RT, nr_spectra_to_add, drift_lower, drift_upper);
   }
 
-  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
+  OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                                               double RT, int nr_spectra_to_add, const double drift_lower, const double drift_upper)
   {
     if (swath_maps.size() == 1)
@@ -627,6 +703,12 @@ namespace OpenMS
       closest_idx--;
     }
 
+    if (spectrum_cache_)
+    {
+      OpenSwath::SpectrumPtr cached = spectrum_cache_->get(swath_map, closest_idx, nr_spectra_to_add, drift_lower, drift_upper);
+      if (cached) return cached;
+    }
+
     if (nr_spectra_to_add == 1)
     {
       added_spec = swath_map->getSpectrumById(closest_idx);
@@ -696,6 +778,10 @@ namespace OpenMS
            added_spec->getMZArray()->data.end(), std::greater<double>()) == added_spec->getMZArray()->data.end(),
            "Postcondition violated: m/z vector needs to be sorted!" )
 
+    if (spectrum_cache_)
+    {
+      spectrum_cache_->insert(swath_map, closest_idx, nr_spectra_to_add, drift_lower, drift_upper, added_spec);
+    }
     return added_spec;
   }
 
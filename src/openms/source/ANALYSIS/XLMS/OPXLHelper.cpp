@@ -58,6 +58,51 @@ namespace OpenMS
     // initialize empty vector for the results
     vector<OPXLDataStructs::XLPrecursor> mass_to_candidates;
 
+    // collect all batches
+    enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, 100000,
+      [&mass_to_candidates, &precursor_correction_positions](vector<OPXLDataStructs::XLPrecursor>& candidates, vector< int >& positions)
+      {
+        mass_to_candidates.insert(mass_to_candidates.end(), make_move_iterator(candidates.begin()), make_move_iterator(candidates.end()));
+        precursor_correction_positions.insert(precursor_correction_positions.end(), positions.begin(), positions.end());
+      });
+    return mass_to_candidates;
+  }
+
+  void OPXLHelper::enumerateCrossLinksAndMasses(const vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(vector<OPXLDataStructs::XLPrecursor>&, vector< int >&)>& consumer)
+  {
+    if (peptides.empty() || spectrum_precursors.empty())
+    {
+      return;
+    }
+    batch_size = std::max(batch_size, Size(1));
+
+    // the current batch of candidates and the positions of their precursor masses
+    vector<OPXLDataStructs::XLPrecursor> batch;
+    vector< int > batch_positions;
+    auto flush_batch = [&]()
+    {
+      if (!batch.empty())
+      {
+        consumer(batch, batch_positions);
+        batch.clear();
+        batch_positions.clear();
+      }
+    };
+    auto add_candidate = [&](const OPXLDataStructs::XLPrecursor& precursor, int pm)
+    {
+      batch.push_back(precursor);
+      batch_positions.push_back(pm);
+      if (batch.size() >= batch_size)
+      {
+        flush_batch();
+      }
+    };
+
+    // number of alpha peptides for which the beta peptides are searched at once
+    const Size alpha_block_size = 4096;
+    vector< pair< Size, Size > > beta_ranges;
+    vector< Size > beta_offsets;
+
     double max_precursor = spectrum_precursors[spectrum_precursors.size()-1];
 
     Size peptides_size = peptides.size();
@@ -99,11 +144,11 @@ namespace OpenMS
       first_loop = lower_bound(first_loop, conservative_upper_bound, min_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
       last_loop = upper_bound(last_loop, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
 
-      int first_index = first_loop - peptides.cbegin();
-      int last_index = last_loop - peptides.cbegin();
+      Size first_index = first_loop - peptides.cbegin();
+      Size last_index = last_loop - peptides.cbegin();
 
-#pragma omp parallel for
-      for (int p1 = first_index; p1 < last_index; ++p1)
+      // (only the peptides within the precursor mass tolerance, not worth parallelizing)
+      for (Size p1 = first_index; p1 < last_index; ++p1)
       {
         const String& seq_first = peptides[p1].unmodified_seq;
         // test if this peptide could have loop-links: one cross-link with both sides attached to the same peptide
@@ -141,13 +186,9 @@ namespace OpenMS
          precursor.alpha_seq = seq_first;
          precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+         add_candidate(precursor, pm);
         }
-      } // end of parallel loop over loop-link candidates
+      } // end of loop over loop-link candidates
 
       // ################################ Enumerate Mono-Links #################
       for (Size i = 0; i < cross_link_mass_mono_link.size(); i++)
@@ -165,8 +206,7 @@ namespace OpenMS
         first_index = first_mono - peptides.cbegin();
         last_index = last_mono - peptides.cbegin();
 
-#pragma omp parallel for
-        for (int p1 = first_index; p1 < last_index; ++p1)
+        for (Size p1 = first_index; p1 < last_index; ++p1)
         {
           // Monoisotopic weight of the peptide + cross-linker
           double cross_linked_peptide_mass = peptides[p1].peptide_mass + mono_link_mass;
@@ -179,11 +219,7 @@ namespace OpenMS
           precursor.alpha_seq = peptides[p1].unmodified_seq;
           precursor.beta_seq = "";
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
+          add_candidate(precursor, pm);
         } // end of loop over candidates for a specific mono-link mass
       } // end of loop over mono-link masses
 
@@ -193,49 +229,85 @@ namespace OpenMS
       // maximal mass: difference between precursor mass and the smallest peptide + cross-linker
       max_peptide_mass = precursor_mass - cross_link_mass - peptides[0].peptide_mass + allowed_error;
       last_alpha = upper_bound(last_alpha, conservative_upper_bound, max_peptide_mass, OPXLDataStructs::AASeqWithMassComparator());
-      int last_alpha_index = last_alpha - peptides.cbegin();
 
-#pragma omp parallel for
-      for (int p1 = 0; p1 < last_alpha_index; ++p1)
-      {
-        // Constrain search for beta
-        double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
-        double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
+      // betas are searched from the alpha on, so the alpha is the lighter
+      // peptide and can weigh at most half of the pair (plus some slack for
+      // rounding, the exact check is the search for betas)
+      const double max_alpha_mass = (precursor_mass - cross_link_mass + allowed_error) / 2 + 1e-6;
+      const Size last_alpha_index = upper_bound(peptides.cbegin(), last_alpha, max_alpha_mass, OPXLDataStructs::AASeqWithMassComparator()) - peptides.cbegin();
 
-        // the last_alpha upper bound is also a conservative upper bound here
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
-        vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
+      for (Size block_begin = 0; block_begin < last_alpha_index; block_begin += alpha_block_size)
+      {
+        const Size block_end = std::min(block_begin + alpha_block_size, last_alpha_index);
 
-        if (first_beta == last_beta)
+        // Constrain search for beta
+        beta_ranges.resize(block_end - block_begin);
+#pragma omp parallel for schedule(static)
+        for (SignedSize p1 = block_begin; p1 < static_cast<SignedSize>(block_end); ++p1)
         {
-          continue;
-        }
+          double min_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass - allowed_error;
+          double max_peptide_mass_beta = precursor_mass - cross_link_mass - peptides[p1].peptide_mass + allowed_error;
 
-        Size first_beta_index = first_beta - peptides.begin();
-        Size last_beta_index = last_beta - peptides.begin();
+          // the last_alpha upper bound is also a conservative upper bound here
+          vector<OPXLDataStructs::AASeqWithMass>::const_iterator first_beta = lower_bound(peptides.cbegin()+p1, last_alpha, min_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
+          vector<OPXLDataStructs::AASeqWithMass>::const_iterator last_beta = upper_bound(peptides.cbegin()+p1, last_alpha, max_peptide_mass_beta, OPXLDataStructs::AASeqWithMassComparator());
+          beta_ranges[p1 - block_begin] = make_pair(first_beta - peptides.cbegin(), std::max(first_beta, last_beta) - peptides.cbegin());
+        }
 
-        for (Size p2 = first_beta_index; p2 < last_beta_index; ++p2)
+        // generate the pairs, at most one batch at a time
+        Size p1_begin = block_begin;
+        while (p1_begin < block_end)
         {
-          // Monoisotopic weight of the first peptide + the second peptide + cross-linker
-          double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+          // take as many alphas as fit into the current batch
+          Size p1_end = p1_begin;
+          Size num_pairs = 0;
+          beta_offsets.clear();
+          while (p1_end < block_end)
+          {
+            const Size num_betas = beta_ranges[p1_end - block_begin].second - beta_ranges[p1_end - block_begin].first;
+            if (batch.size() + num_pairs + num_betas > batch_size)
+            {
+              if (num_pairs > 0) break;
+              flush_batch(); // nothing reserved yet, start with an empty batch
+            }
+            beta_offsets.push_back(num_pairs);
+            num_pairs += num_betas;
+            ++p1_end;
+          }
 
-          // this time both peptides have valid indices
-          OPXLDataStructs::XLPrecursor precursor;
-          precursor.precursor_mass = cross_linked_pair_mass;
-          precursor.alpha_index = p1;
-          precursor.beta_index = p2;
-          precursor.alpha_seq = peptides[p1].unmodified_seq;
-          precursor.beta_seq = peptides[p2].unmodified_seq;
+          const Size offset = batch.size();
+          batch.resize(offset + num_pairs);
+          batch_positions.resize(offset + num_pairs, pm);
 
-#pragma omp critical (mass_to_candidates_access)
-         {
-           mass_to_candidates.push_back(precursor);
-           precursor_correction_positions.push_back(pm);
-         }
-        } // end of loop over betas
-      } // end of parallel loop over alphas
+#pragma omp parallel for schedule(dynamic, 16)
+          for (SignedSize p1 = p1_begin; p1 < static_cast<SignedSize>(p1_end); ++p1)
+          {
+            const pair< Size, Size >& beta_range = beta_ranges[p1 - block_begin];
+            Size pos = offset + beta_offsets[p1 - p1_begin];
+            for (Size p2 = beta_range.first; p2 < beta_range.second; ++p2, ++pos)
+            {
+              // Monoisotopic weight of the first peptide + the second peptide + cross-linker
+              double cross_linked_pair_mass = peptides[p1].peptide_mass + peptides[p2].peptide_mass + cross_link_mass;
+
+              // this time both peptides have valid indices
+              OPXLDataStructs::XLPrecursor& precursor = batch[pos];
+              precursor.precursor_mass = cross_linked_pair_mass;
+              precursor.alpha_index = p1;
+              precursor.beta_index = p2;
+              precursor.alpha_seq = peptides[p1].unmodified_seq;
+              precursor.beta_seq = peptides[p2].unmodified_seq;
+            } // end of loop over betas
+          } // end of parallel loop over alphas
+
+          if (batch.size() >= batch_size)
+          {
+            flush_batch();
+          }
+          p1_begin = p1_end;
+        }
+      } // end of loop over blocks of alphas
     } // end of loop over precursor masses
-    return mass_to_candidates;
+    flush_batch();
   }
 
   std::vector<OPXLDataStructs::AASeqWithMass> OPXLHelper::digestDatabase(
@@ -1329,7 +1401,6 @@ namespace OpenMS
                                                                                                 const std::vector<std::string>& tags)
   {
     // determine candidates
-    std::vector< OPXLDataStructs::XLPrecursor > candidates;
     std::vector< double > spectrum_precursor_vector;
     std::vector< double > allowed_error_vector;
 
@@ -1353,34 +1424,46 @@ namespace OpenMS
 
     } // end correction mass loop
 
-    std::vector< int > precursor_correction_positions;
+    vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates;
+    Size candidates_size = 0;
+    Size filtered_candidates_size = 0;
+
     // if sequence tags are used and no tags were found, don't bother combining peptide pairs
     if ( (use_sequence_tags && !tags.empty()) ||
          !use_sequence_tags)
     {
-      candidates = OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_correction_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+      // enumerate the candidates in batches, so that only the filtered ones are kept
+      OPXLHelper::enumerateCrossLinksAndMasses(filtered_peptide_masses, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursor_vector, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, 100000,
+        [&](std::vector< OPXLDataStructs::XLPrecursor >& candidates, std::vector< int >& precursor_correction_positions)
+        {
+          candidates_size += candidates.size();
+          // an empty vector of sequence tags implies no filtering should be done in this case
+          if (use_sequence_tags)
+          {
+            OPXLHelper::filterPrecursorsByTags(candidates, precursor_correction_positions, tags);
+          }
+          filtered_candidates_size += candidates.size();
+
+          vector< int > precursor_corrections;
+          for (Size pc = 0; pc < precursor_correction_positions.size(); ++pc)
+          {
+            precursor_corrections.push_back(precursor_correction_steps[precursor_correction_positions[pc]]);
+          }
+          vector <OPXLDataStructs::ProteinProteinCrossLink> batch_cross_link_candidates = OPXLHelper::buildCandidates(candidates, precursor_corrections, precursor_correction_positions, filtered_peptide_masses, cross_link_residue1, cross_link_residue2, cross_link_mass, cross_link_mass_mono_link, spectrum_precursor_vector, allowed_error_vector, cross_link_name);
+          cross_link_candidates.insert(cross_link_candidates.end(), make_move_iterator(batch_cross_link_candidates.begin()), make_move_iterator(batch_cross_link_candidates.end()));
+        });
     }
 
-    // an empty vector of sequence tags implies no filtering should be done in this case
     if (use_sequence_tags)
     {
-      Size candidates_size = candidates.size();
-      OPXLHelper::filterPrecursorsByTags(candidates, precursor_correction_positions, tags);
-
 #pragma omp critical (LOG_DEBUG_access)
       {
         OPENMS_LOG_DEBUG << "Number of sequence tags: " << tags.size() << std::endl;
         OPENMS_LOG_DEBUG << "Candidate Peptide Pairs before sequence tag filtering: " << candidates_size << std::endl;
-        OPENMS_LOG_DEBUG << "Candidate Peptide Pairs  after sequence tag filtering: " << candidates.size() << std::endl;
+        OPENMS_LOG_DEBUG << "Candidate Peptide Pairs  after sequence tag filtering: " << filtered_candidates_size << std::endl;
       }
     }
 
-    vector< int > precursor_corrections;
-    for (Size pc = 0; pc < precursor_correction_positions.size(); ++pc)
-    {
-      precursor_corrections.push_back(precursor_correction_steps[precursor_correction_positions[pc]]);
-    }
-    vector <OPXLDataStructs::ProteinProteinCrossLink> cross_link_candidates = OPXLHelper::buildCandidates(candidates, precursor_corrections, precursor_correction_positions, filtered_peptide_masses, cross_link_residue1, cross_link_residue2, cross_link_mass, cross_link_mass_mono_link, spectrum_precursor_vector, allowed_error_vector, cross_link_name);
     return cross_link_candidates;
   }
 
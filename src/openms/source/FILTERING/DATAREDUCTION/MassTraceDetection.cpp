@@ -38,6 +38,10 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
     MassTraceDetection::MassTraceDetection() :
@@ -69,6 +73,42 @@ namespace OpenMS
 
     MassTraceDetection::~MassTraceDetection() = default;
 
+    namespace
+    {
+      /// Iterative computation of the intensity-weighted mean m/z (see MassTraceDetection::updateIterativeWeightedMeanMZ)
+      void updateWeightedMeanMZ(const double added_mz, const double added_int, double& centroid_mz, double& prev_counter, double& prev_denom)
+      {
+        double counter_tmp(1 + (added_int * added_mz) / prev_counter);
+        double denom_tmp(1 + (added_int) / prev_denom);
+        centroid_mz *= (counter_tmp / denom_tmp);
+        prev_counter *= counter_tmp;
+        prev_denom *= denom_tmp;
+      }
+
+      /// Index of the peak in [begin, end) of @p mz nearest to @p target (same semantics as MSSpectrum::findNearest)
+      Size findNearest(const std::vector<double>& mz, const Size begin, const Size end, const double target)
+      {
+        auto first = mz.begin() + begin;
+        auto last = mz.begin() + end;
+        auto it = std::lower_bound(first, last, target);
+        if (it == first)
+        {
+          return begin;
+        }
+        if (it == last)
+        {
+          return end - 1;
+        }
+        // the peak before or the current peak are closest
+        auto it2 = it - 1;
+        if (std::fabs(*it - target) < std::fabs(*it2 - target))
+        {
+          return Size(it - mz.begin());
+        }
+        return Size(it2 - mz.begin());
+      }
+    }
+
     MassTraceDetection::Apex::Apex(double intensity, Size scan_idx, Size peak_idx):
       intensity(intensity),
       scan_idx(scan_idx),
@@ -79,16 +119,7 @@ namespace OpenMS
                                                            const double& added_int, double& centroid_mz, double& prev_counter,
                                                            double& prev_denom)
     {
-      double new_weight(added_int);
-      double new_mz(added_mz);
-
-      double counter_tmp(1 + (new_weight * new_mz) / prev_counter);
-      double denom_tmp(1 + (new_weight) / prev_denom);
-      centroid_mz *= (counter_tmp / denom_tmp);
-      prev_counter *= counter_tmp;
-      prev_denom *= denom_tmp;
-
-      return;
+      updateWeightedMeanMZ(added_mz, added_int, centroid_mz, prev_counter, prev_denom);
     }
 
     void MassTraceDetection::run(PeakMap::ConstAreaIterator& begin,
@@ -152,12 +183,12 @@ namespace OpenMS
       last_weights_sum = weights_sum;
     }
 
-    void updateWeightedSDEstimateRobust(const PeakType& p, const double& mean_t1, double& sd_t, double& last_weights_sum)
+    void updateWeightedSDEstimateRobust(const double mz, const double intensity, const double& mean_t1, double& sd_t, double& last_weights_sum)
     {
       double denom1 = std::log(last_weights_sum) + 2 * std::log(sd_t);
-      double denom2 = std::log(p.getIntensity()) + 2 * std::log(std::abs(p.getMZ() - mean_t1));
+      double denom2 = std::log(intensity) + 2 * std::log(std::abs(mz - mean_t1));
       double denom = std::sqrt(std::exp(denom1) + std::exp(denom2));
-      double weights_sum = last_weights_sum + p.getIntensity();
+      double weights_sum = last_weights_sum + intensity;
       double tmp_sd = denom / std::sqrt(weights_sum);
 
       if (tmp_sd > std::numeric_limits<double>::epsilon())
@@ -168,14 +199,14 @@ namespace OpenMS
       last_weights_sum = weights_sum;
     }
 
-    void computeWeightedSDEstimate(std::list<PeakType> tmp, const double& mean_t, double& sd_t, const double& /* lower_sd_bound */)
+    void computeWeightedSDEstimate(const std::vector<PeakType>& tmp, const double& mean_t, double& sd_t, const double& /* lower_sd_bound */)
     {
       double denom(0.0), weights_sum(0.0);
 
-      for (std::list<PeakType>::const_iterator l_it = tmp.begin(); l_it != tmp.end(); ++l_it)
+      for (const PeakType& p : tmp)
       {
-        denom += l_it->getIntensity() * (l_it->getMZ() - mean_t) * (l_it->getMZ() - mean_t);
-        weights_sum += l_it->getIntensity();
+        denom += p.getIntensity() * (p.getMZ() - mean_t) * (p.getMZ() - mean_t);
+        weights_sum += p.getIntensity();
       }
 
       double tmp_sd = std::sqrt(denom / (weights_sum));
@@ -197,16 +228,14 @@ namespace OpenMS
       found_masstraces.clear();
 
       // gather all peaks that are potential chromatographic peak apices
-      //   - use work_exp for actual work (remove peaks below noise threshold)
+      //   - use a flat view of the MS1 peaks for actual work (remove peaks below noise threshold)
       //   - store potential apices in chrom_apices
-      PeakMap work_exp;
+      PeakView_ peaks;
+      peaks.spec_offsets.push_back(0);
       std::vector<Apex> chrom_apices;
 
-      Size total_peak_count(0);
-      std::vector<Size> spec_offsets;
-      spec_offsets.push_back(0);
-
       Size spectra_count(0);
+      Size fwhm_meta_count(0);
 
       // *********************************************************** //
       //  Step 1: Detecting potential chromatographic apices
@@ -218,7 +247,30 @@ namespace OpenMS
         {
           continue;
         }
-        std::vector<Size> indices_passing;
+        // data arrays should always have the same size as the spectrum
+        auto check_size = [&it](const auto& arrays, const String& type)
+        {
+          for (Size i = 0; i < arrays.size(); ++i)
+          {
+            if (!arrays[i].empty() && arrays[i].size() != it.size())
+            {
+              throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, type + "[" + String(i) + "] size (" +
+                                            String(arrays[i].size()) + ") does not match spectrum size (" + String(it.size()) + ")");
+            }
+          }
+        };
+        check_size(it.getFloatDataArrays(), "FloatDataArray");
+        check_size(it.getStringDataArrays(), "StringDataArray");
+        check_size(it.getIntegerDataArrays(), "IntegerDataArray");
+
+        const MSSpectrum::FloatDataArray* fwhm_array(nullptr);
+        if (!it.getFloatDataArrays().empty() && it.getFloatDataArrays()[0].getName() == "FWHM_ppm")
+        {
+          fwhm_array = &it.getFloatDataArrays()[0];
+          ++fwhm_meta_count;
+        }
+
+        const Size spec_begin(peaks.mz.size());
         for (Size peak_idx = 0; peak_idx < it.size(); ++peak_idx)
         {
           double tmp_peak_int((it)[peak_idx].getIntensity());
@@ -229,16 +281,23 @@ namespace OpenMS
             // --> add this peak as possible chromatographic apex
             if (tmp_peak_int > chrom_peak_snr_ * noise_threshold_int_)
             {
-              chrom_apices.emplace_back(tmp_peak_int, spectra_count, indices_passing.size());
+              chrom_apices.emplace_back(tmp_peak_int, spectra_count, peaks.mz.size());
+            }
+            peaks.mz.push_back(it[peak_idx].getMZ());
+            peaks.intensity.push_back(it[peak_idx].getIntensity());
+            if (fwhm_array != nullptr && !fwhm_array->empty())
+            {
+              peaks.fwhm.push_back((*fwhm_array)[peak_idx]);
             }
-            indices_passing.push_back(peak_idx);
-            ++total_peak_count;
           }
         }
-        PeakMap::SpectrumType tmp_spec(it);
-        tmp_spec.select(indices_passing);
-        work_exp.addSpectrum(tmp_spec);
-        spec_offsets.push_back(spec_offsets.back() + tmp_spec.size());
+        // an empty FWHM array is only fine for a spectrum without peaks
+        if (fwhm_array != nullptr && fwhm_array->empty() && peaks.mz.size() != spec_begin)
+        {
+          throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, peaks.mz.size() - spec_begin);
+        }
+        peaks.rt.push_back(it.getRT());
+        peaks.spec_offsets.push_back(peaks.mz.size());
         ++spectra_count;
       }
 
@@ -248,8 +307,12 @@ namespace OpenMS
                                       "Input map consists of too few MS1 spectra (less than 3!). Aborting...", String(spectra_count));
       }
 
-      // discard last spectrum's offset
-      spec_offsets.pop_back();
+      // FWHM meta data must be present for all spectra or for none
+      if (fwhm_meta_count > 0 && fwhm_meta_count != spectra_count)
+      {
+        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + spectra_count + "].");
+      }
 
       std::sort(chrom_apices.begin(), chrom_apices.end(),
                 [](const Apex & a,
@@ -262,285 +325,276 @@ namespace OpenMS
       // Step 2: start extending mass traces beginning with the apex peak (go
       // through all peaks in order of decreasing intensity)
       // *********************************************************************
-      run_(chrom_apices, total_peak_count, work_exp, spec_offsets, found_masstraces, max_traces);
+      run_(chrom_apices, peaks, found_masstraces, max_traces);
 
       return;
     } // end of MassTraceDetection::run
 
-    void MassTraceDetection::run_(const std::vector<Apex>& chrom_apices,
-                                  const Size total_peak_count,
-                                  const PeakMap& work_exp,
-                                  const std::vector<Size>& spec_offsets,
-                                  std::vector<MassTrace>& found_masstraces,
-                                  const Size max_traces)
+    void MassTraceDetection::extendTrace_(const Apex& apex,
+                                          const PeakView_& peaks,
+                                          const boost::dynamic_bitset<>& peak_visited,
+                                          TraceCandidate_& trace) const
     {
-      boost::dynamic_bitset<> peak_visited(total_peak_count);
-      Size trace_number(1);
-
-      // check presence of FWHM meta data
-      int fwhm_meta_idx(-1);
-      Size fwhm_meta_count(0);
-      for (Size i = 0; i < work_exp.size(); ++i)
-      {
-        if (!work_exp[i].getFloatDataArrays().empty() &&
-            work_exp[i].getFloatDataArrays()[0].getName() == "FWHM_ppm")
-        {
-          if (work_exp[i].getFloatDataArrays()[0].size() != work_exp[i].size())
-          { // float data should always have the same size as the corresponding array
-            throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, work_exp[i].size());
-          }
-          fwhm_meta_idx = 0;
-          ++fwhm_meta_count;
-        }
-      }
-      if (fwhm_meta_count > 0 && fwhm_meta_count != work_exp.size())
-      {
-        throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-                                      String("FWHM meta arrays are expected to be missing or present for all MS spectra [") + fwhm_meta_count + "/" + work_exp.size() + "].");
-      }
+      trace.down.clear();
+      trace.up.clear();
+      trace.valid = false;
 
+      const Size apex_scan_idx(apex.scan_idx);
+      const double apex_mz(peaks.mz[apex.peak_idx]);
+      const double apex_int(peaks.intensity[apex.peak_idx]);
 
-      this->startProgress(0, total_peak_count, "mass trace detection");
-      Size peaks_detected(0);
+      Size trace_up_idx(apex_scan_idx);
+      Size trace_down_idx(apex_scan_idx);
 
-      for (auto m_it = chrom_apices.crbegin(); m_it != chrom_apices.crend(); ++m_it)
-      {
-        Size apex_scan_idx(m_it->scan_idx);
-        Size apex_peak_idx(m_it->peak_idx);
+      // Initialization for the iterative version of weighted m/z mean calculation
+      double centroid_mz(apex_mz);
+      double prev_counter(apex_int * apex_mz);
+      double prev_denom(apex_int);
 
-        if (peak_visited[spec_offsets[apex_scan_idx] + apex_peak_idx])
-        {
-          continue;
-        }
+      updateWeightedMeanMZ(apex_mz, apex_int, centroid_mz, prev_counter, prev_denom);
 
-        Peak2D apex_peak;
-        apex_peak.setRT(work_exp[apex_scan_idx].getRT());
-        apex_peak.setMZ(work_exp[apex_scan_idx][apex_peak_idx].getMZ());
-        apex_peak.setIntensity(work_exp[apex_scan_idx][apex_peak_idx].getIntensity());
+      Size up_hitting_peak(0), down_hitting_peak(0);
+      Size up_scan_counter(0), down_scan_counter(0);
 
-        Size trace_up_idx(apex_scan_idx);
-        Size trace_down_idx(apex_scan_idx);
+      bool toggle_up = true, toggle_down = true;
 
-        std::list<PeakType> current_trace;
-        current_trace.push_back(apex_peak);
-        std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+      Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
+      const Size max_consecutive_missing(trace_termination_outliers_);
+      const bool outlier_termination(trace_termination_criterion_ == "outlier");
 
-        // Initialization for the iterative version of weighted m/z mean calculation
-        double centroid_mz(apex_peak.getMZ());
-        double prev_counter(apex_peak.getIntensity() * apex_peak.getMZ());
-        double prev_denom(apex_peak.getIntensity());
+      double current_sample_rate(1.0);
+      const Size min_scans_to_consider(5);
 
-        updateIterativeWeightedMeanMZ(apex_peak.getMZ(), apex_peak.getIntensity(), centroid_mz, prev_counter, prev_denom);
+      double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
+      double intensity_so_far(apex_int);
 
-        std::vector<std::pair<Size, Size> > gathered_idx;
-        gathered_idx.emplace_back(apex_scan_idx, apex_peak_idx);
-        if (fwhm_meta_idx != -1)
+      // try to add the peak nearest to the current centroid in spectrum scan_idx to the trace
+      auto extend = [&](const Size scan_idx, std::vector<std::pair<Size, Size> >& gathered, Size& hitting_peak, Size& conseq_missed_peak)
+      {
+        const Size spec_begin(peaks.spec_offsets[scan_idx]);
+        const Size spec_end(peaks.spec_offsets[scan_idx + 1]);
+        if (spec_begin == spec_end)
         {
-          fwhms_mz.push_back(work_exp[apex_scan_idx].getFloatDataArrays()[fwhm_meta_idx][apex_peak_idx]);
+          return;
         }
+        const Size next_peak_idx = findNearest(peaks.mz, spec_begin, spec_end, centroid_mz);
+        const double next_peak_mz = peaks.mz[next_peak_idx];
+        const double next_peak_int = peaks.intensity[next_peak_idx];
 
-        Size up_hitting_peak(0), down_hitting_peak(0);
-        Size up_scan_counter(0), down_scan_counter(0);
-
-        bool toggle_up = true, toggle_down = true;
+        double right_bound = centroid_mz + 3 * ftl_sd;
+        double left_bound = centroid_mz - 3 * ftl_sd;
 
-        Size conseq_missed_peak_up(0), conseq_missed_peak_down(0);
-        Size max_consecutive_missing(trace_termination_outliers_);
-
-        double current_sample_rate(1.0);
-        // Size min_scans_to_consider(std::floor((min_sample_rate_ /2)*10));
-        Size min_scans_to_consider(5);
+        if ((next_peak_mz <= right_bound) &&
+            (next_peak_mz >= left_bound) &&
+            !peak_visited[next_peak_idx])
+        {
+          gathered.emplace_back(scan_idx, next_peak_idx);
+          // Update the m/z mean of the current trace as we added a new peak
+          updateWeightedMeanMZ(next_peak_mz, next_peak_int, centroid_mz, prev_counter, prev_denom);
 
-        // double outlier_ratio(0.3);
+          // Update the m/z variance dynamically
+          if (reestimate_mt_sd_)
+          {
+            updateWeightedSDEstimateRobust(next_peak_mz, next_peak_int, centroid_mz, ftl_sd, intensity_so_far);
+          }
 
-        // double ftl_mean(centroid_mz);
-        double ftl_sd((centroid_mz / 1e6) * mass_error_ppm_);
-        double intensity_so_far(apex_peak.getIntensity());
+          ++hitting_peak;
+          conseq_missed_peak = 0;
+        }
+        else
+        {
+          ++conseq_missed_peak;
+        }
+      };
 
-        while (((trace_down_idx > 0) && toggle_down) ||
-               ((trace_up_idx < work_exp.size() - 1) && toggle_up)
-                )
+      const Size last_scan_idx(peaks.numSpectra() - 1);
+      while (((trace_down_idx > 0) && toggle_down) ||
+             ((trace_up_idx < last_scan_idx) && toggle_up)
+              )
+      {
+        // *********************************************************** //
+        // Step 2.1 MOVE DOWN in RT dim
+        // *********************************************************** //
+        if ((trace_down_idx > 0) && toggle_down)
         {
-          // *********************************************************** //
-          // Step 2.1 MOVE DOWN in RT dim
-          // *********************************************************** //
-          if ((trace_down_idx > 0) && toggle_down)
+          extend(trace_down_idx - 1, trace.down, down_hitting_peak, conseq_missed_peak_down);
+          --trace_down_idx;
+          ++down_scan_counter;
+
+          // trace termination criterion: max allowed number of
+          // consecutive outliers reached OR cancel extension if
+          // sampling_rate falls below min_sample_rate_
+          if (outlier_termination)
           {
-            const MSSpectrum& spec_trace_down = work_exp[trace_down_idx - 1];
-            if (!spec_trace_down.empty())
+            if (conseq_missed_peak_down > max_consecutive_missing)
             {
-              Size next_down_peak_idx = spec_trace_down.findNearest(centroid_mz);
-              double next_down_peak_mz = spec_trace_down[next_down_peak_idx].getMZ();
-              double next_down_peak_int = spec_trace_down[next_down_peak_idx].getIntensity();
-
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
-
-              if ((next_down_peak_mz <= right_bound) &&
-                  (next_down_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_down_idx - 1] + next_down_peak_idx]
-                      )
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_down.getRT());
-                next_peak.setMZ(next_down_peak_mz);
-                next_peak.setIntensity(next_down_peak_int);
-
-                current_trace.push_front(next_peak);
-                // FWHM average
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_down.getFloatDataArrays()[fwhm_meta_idx][next_down_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_down_peak_mz, next_down_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_down_idx - 1, next_down_peak_idx);
-
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (down_hitting_peak+1 > min_flank_scans))
-                {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
-                }
-
-                ++down_hitting_peak;
-                conseq_missed_peak_down = 0;
-              }
-              else
-              {
-                ++conseq_missed_peak_down;
-              }
-
+              toggle_down = false;
             }
-            --trace_down_idx;
-            ++down_scan_counter;
-
-            // trace termination criterion: max allowed number of
-            // consecutive outliers reached OR cancel extension if
-            // sampling_rate falls below min_sample_rate_
-            if (trace_termination_criterion_ == "outlier")
-            {
-              if (conseq_missed_peak_down > max_consecutive_missing)
-              {
-                toggle_down = false;
-              }
-            }
-            else if (trace_termination_criterion_ == "sample_rate")
+          }
+          else
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
+                                  (double)(down_scan_counter + up_scan_counter + 1);
+            if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) /
-                                    (double)(down_scan_counter + up_scan_counter + 1);
-              if (down_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping down..." << std::endl;
-                toggle_down = false;
-              }
+              toggle_down = false;
             }
           }
+        }
+
+        // *********************************************************** //
+        // Step 2.2 MOVE UP in RT dim
+        // *********************************************************** //
+        if ((trace_up_idx < last_scan_idx) && toggle_up)
+        {
+          extend(trace_up_idx + 1, trace.up, up_hitting_peak, conseq_missed_peak_up);
+          ++trace_up_idx;
+          ++up_scan_counter;
 
-          // *********************************************************** //
-          // Step 2.2 MOVE UP in RT dim
-          // *********************************************************** //
-          if ((trace_up_idx < work_exp.size() - 1) && toggle_up)
+          if (outlier_termination)
           {
-            const MSSpectrum& spec_trace_up = work_exp[trace_up_idx + 1];
-            if (!spec_trace_up.empty())
+            if (conseq_missed_peak_up > max_consecutive_missing)
             {
-              Size next_up_peak_idx = spec_trace_up.findNearest(centroid_mz);
-              double next_up_peak_mz = spec_trace_up[next_up_peak_idx].getMZ();
-              double next_up_peak_int = spec_trace_up[next_up_peak_idx].getIntensity();
-
-              double right_bound = centroid_mz + 3 * ftl_sd;
-              double left_bound = centroid_mz - 3 * ftl_sd;
-
-              if ((next_up_peak_mz <= right_bound) &&
-                  (next_up_peak_mz >= left_bound) &&
-                  !peak_visited[spec_offsets[trace_up_idx + 1] + next_up_peak_idx])
-              {
-                Peak2D next_peak;
-                next_peak.setRT(spec_trace_up.getRT());
-                next_peak.setMZ(next_up_peak_mz);
-                next_peak.setIntensity(next_up_peak_int);
-
-                current_trace.push_back(next_peak);
-                if (fwhm_meta_idx != -1)
-                {
-                  fwhms_mz.push_back(spec_trace_up.getFloatDataArrays()[fwhm_meta_idx][next_up_peak_idx]);
-                }
-                // Update the m/z mean of the current trace as we added a new peak
-                updateIterativeWeightedMeanMZ(next_up_peak_mz, next_up_peak_int, centroid_mz, prev_counter, prev_denom);
-                gathered_idx.emplace_back(trace_up_idx + 1, next_up_peak_idx);
-
-                // Update the m/z variance dynamically
-                if (reestimate_mt_sd_)           //  && (up_hitting_peak+1 > min_flank_scans))
-                {
-                  // if (ftl_t > min_fwhm_scans)
-                  {
-                    updateWeightedSDEstimateRobust(next_peak, centroid_mz, ftl_sd, intensity_so_far);
-                  }
-                }
-
-                ++up_hitting_peak;
-                conseq_missed_peak_up = 0;
-
-              }
-              else
-              {
-                ++conseq_missed_peak_up;
-              }
-
+              toggle_up = false;
             }
+          }
+          else
+          {
+            current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
 
-            ++trace_up_idx;
-            ++up_scan_counter;
-
-            if (trace_termination_criterion_ == "outlier")
+            if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
             {
-              if (conseq_missed_peak_up > max_consecutive_missing)
-              {
-                toggle_up = false;
-              }
+              toggle_up = false;
             }
-            else if (trace_termination_criterion_ == "sample_rate")
-            {
-              current_sample_rate = (double)(down_hitting_peak + up_hitting_peak + 1) / (double)(down_scan_counter + up_scan_counter + 1);
+          }
+        }
+      }
 
-              if (up_scan_counter > min_scans_to_consider && current_sample_rate < min_sample_rate_)
-              {
-                // std::cout << "stopping up" << std::endl;
-                toggle_up = false;
-              }
-            }
+      double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
 
+      double mt_quality((double)(trace.down.size() + trace.up.size() + 1) / (double)num_scans);
+      const double rt_first(trace.down.empty() ? peaks.rt[apex_scan_idx] : peaks.rt[trace.down.back().first]);
+      const double rt_last(trace.up.empty() ? peaks.rt[apex_scan_idx] : peaks.rt[trace.up.back().first]);
+      double rt_range(std::fabs(rt_last - rt_first));
 
-          }
+      // *********************************************************** //
+      // Step 2.3 check if minimum length and quality of mass trace criteria are met
+      // *********************************************************** //
+      bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
+      trace.valid = (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_);
+    }
+
+    void MassTraceDetection::run_(const std::vector<Apex>& chrom_apices,
+                                  const PeakView_& peaks,
+                                  std::vector<MassTrace>& found_masstraces,
+                                  const Size max_traces)
+    {
+      const Size total_peak_count(peaks.mz.size());
+      boost::dynamic_bitset<> peak_visited(total_peak_count);
+      Size trace_number(1);
 
+      this->startProgress(0, total_peak_count, "mass trace detection");
+      Size peaks_detected(0);
+
+      // Apices are processed in batches: the traces of a batch are extended in
+      // parallel against the state of peak_visited at the start of the batch
+      // and then accepted serially in order of decreasing apex intensity. A
+      // trace only depends on peak_visited through the peaks it gathered (all
+      // of them were unvisited at the start of the batch), so if none of them
+      // was taken by a trace accepted earlier in the same batch, the trace is
+      // exactly the one the serial extension would have produced. Otherwise it
+      // is extended again against the current state.
+#ifdef _OPENMP
+      const Size batch_size(apices_per_thread_ * omp_get_max_threads());
+#else
+      const Size batch_size(1);
+#endif
+      std::vector<TraceCandidate_> candidates(std::min(batch_size, chrom_apices.size()));
+      std::vector<PeakType> trace_peaks;
+      std::vector<double> fwhms_mz; // peak-FWHM meta values of collected peaks
+
+      // is any of the peaks gathered by the trace already taken?
+      auto conflicts = [&peak_visited](const Apex& apex, const TraceCandidate_& trace)
+      {
+        if (peak_visited[apex.peak_idx])
+        {
+          return true;
         }
+        for (const auto& p : trace.down)
+        {
+          if (peak_visited[p.second]) return true;
+        }
+        for (const auto& p : trace.up)
+        {
+          if (peak_visited[p.second]) return true;
+        }
+        return false;
+      };
 
-        // std::cout << "current sr: " << current_sample_rate << std::endl;
-        double num_scans(down_scan_counter + up_scan_counter + 1 - conseq_missed_peak_down - conseq_missed_peak_up);
+      bool done(false);
+      for (Size batch_begin = 0; batch_begin < chrom_apices.size() && !done; batch_begin += batch_size)
+      {
+        // apices are sorted by increasing intensity, process them from the back
+        const Size batch_end(std::min(batch_begin + batch_size, chrom_apices.size()));
+        const Apex* apices = chrom_apices.data() + (chrom_apices.size() - batch_end);
+        const SignedSize batch_count(batch_end - batch_begin);
 
-        double mt_quality((double)current_trace.size() / (double)num_scans);
-        // std::cout << "mt quality: " << mt_quality << std::endl;
-        double rt_range(std::fabs(current_trace.rbegin()->getRT() - current_trace.begin()->getRT()));
+#pragma omp parallel for schedule(dynamic)
+        for (SignedSize i = 0; i < batch_count; ++i)
+        {
+          const Apex& apex = apices[batch_count - 1 - i];
+          if (peak_visited[apex.peak_idx])
+          {
+            continue;
+          }
+          extendTrace_(apex, peaks, peak_visited, candidates[i]);
+        }
 
-        // *********************************************************** //
-        // Step 2.3 check if minimum length and quality of mass trace criteria are met
-        // *********************************************************** //
-        bool max_trace_criteria = (max_trace_length_ < 0.0 || rt_range < max_trace_length_);
-        if (rt_range >= min_trace_length_ && max_trace_criteria && mt_quality >= min_sample_rate_)
+        for (SignedSize i = 0; i < batch_count; ++i)
         {
-          // std::cout << "T" << trace_number << "\t" << mt_quality << std::endl;
+          const Apex& apex = apices[batch_count - 1 - i];
+          if (peak_visited[apex.peak_idx])
+          {
+            continue;
+          }
+          TraceCandidate_& trace = candidates[i];
+          if (conflicts(apex, trace))
+          {
+            extendTrace_(apex, peaks, peak_visited, trace);
+          }
+          if (!trace.valid)
+          {
+            continue;
+          }
 
-          // mark all peaks as visited
-          for (Size i = 0; i < gathered_idx.size(); ++i)
+          // mark all peaks as visited and collect them in order of increasing RT
+          trace_peaks.clear();
+          fwhms_mz.clear();
+          auto add_peak = [&](const Size scan_idx, const Size peak_idx)
+          {
+            peak_visited[peak_idx] = true;
+            PeakType p;
+            p.setRT(peaks.rt[scan_idx]);
+            p.setMZ(peaks.mz[peak_idx]);
+            p.setIntensity(peaks.intensity[peak_idx]);
+            trace_peaks.push_back(p);
+            if (!peaks.fwhm.empty())
+            {
+              fwhms_mz.push_back(peaks.fwhm[peak_idx]);
+            }
+          };
+          for (auto it = trace.down.crbegin(); it != trace.down.crend(); ++it)
           {
-            peak_visited[spec_offsets[gathered_idx[i].first] +  gathered_idx[i].second] = true;
+            add_peak(it->first, it->second);
+          }
+          add_peak(apex.scan_idx, apex.peak_idx);
+          for (const auto& p : trace.up)
+          {
+            add_peak(p.first, p.second);
           }
 
-          // create new MassTrace object and store collected peaks from list current_trace
-          MassTrace new_trace(current_trace);
+          // create new MassTrace object and store collected peaks
+          MassTrace new_trace(trace_peaks);
           new_trace.updateWeightedMeanRT();
           new_trace.updateWeightedMeanMZ();
           if (!fwhms_mz.empty())
@@ -548,19 +602,19 @@ namespace OpenMS
             new_trace.fwhm_mz_avg = Math::median(fwhms_mz.begin(), fwhms_mz.end());
           }
           new_trace.setQuantMethod(quant_method_);
-          //new_trace.setCentroidSD(ftl_sd);
           new_trace.updateWeightedMZsd();
           new_trace.setLabel("T" + String(trace_number));
           ++trace_number;
 
-          found_masstraces.push_back(new_trace);
-
           peaks_detected += new_trace.getSize();
+          found_masstraces.push_back(std::move(new_trace));
+
           this->setProgress(peaks_detected);
 
           // check if we already reached the (optional) maximum number of traces
           if (max_traces > 0 && found_masstraces.size() == max_traces)
           {
+            done = true;
             break;
           }
         }
@@ -37,6 +37,14 @@
 #include <QtCore/QList>
 #include <QtCore/QString>
 
+#include <cstring>
+
+// x86 SIMD versions of the Base64 codec (selected at runtime, see Base64::encodeBytes_ / Base64::decodeBytes_)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OPENMS_BASE64_X86_SIMD
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -82,47 +90,369 @@ namespace OpenMS
      /   = 47       ->       63
 
 
-  this can be done by first subtracting 43 from each value
-  and then looking up a value in a table as found in the code,
-  e.g. lookup[char - 43] - 62
+  which is done with a direct lookup table of all 256 byte values (see
+  base64_decode_table_ below), which also marks the characters outside of the
+  Base64 alphabet.
 
-  The following string can be produced by this Python snippet:
+  */
 
-offset = 62
-s = ""
-s += chr(62 + offset)
-s += '$' * 3
-s += "".join([ chr(52 + i + offset) for i in range(10) ])
-s += '$' * 7
-s += "".join([ chr(i + offset) for i in range(26) ])
-s += '$' * 6
-s += "".join([ chr(26 + i + offset) for i in range(26) ])
-print s
+  const char Base64::encoder_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
-"|$$$rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\]^_`abcdefghijklmnopq"
+  namespace
+  {
+    /// Value of characters outside of the Base64 alphabet in base64_decode_table_
+    constexpr unsigned char invalid_base64_char_ = 0xFF;
 
-  however, this is basically just convenience to produce printable characters.
-  We could also go for a direct mapping:
+    /// Lookup table from Base64 character to its 6 bit value (invalid_base64_char_ for all other characters)
+    struct Base64DecodeTable_
+    {
+      unsigned char values[256] = {};
 
-s = '$' * 42
-s += hex(62)
-s += '$' * 3
-s += "".join([ hex(52 + i) for i in range(10) ])
-s += '$' * 7
-s += "".join([ hex(i) for i in range(26) ])
-s += '$' * 6
-s += "".join([ hex(26 + i) for i in range(26) ])
-print s
+      constexpr Base64DecodeTable_()
+      {
+        for (int i = 0; i < 256; ++i)
+        {
+          values[i] = invalid_base64_char_;
+        }
+        for (int i = 0; i < 26; ++i)
+        {
+          values['A' + i] = static_cast<unsigned char>(i);
+          values['a' + i] = static_cast<unsigned char>(26 + i);
+        }
+        for (int i = 0; i < 10; ++i)
+        {
+          values['0' + i] = static_cast<unsigned char>(52 + i);
+        }
+        values[int('+')] = 62;
+        values[int('/')] = 63;
+      }
+    };
+    constexpr Base64DecodeTable_ base64_decode_table_;
 
-"$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$0x3e$$$0x340x350x360x370x380x390x3a0x3b0x3c0x3d$$$$$$$0x00x10x20x30x40x50x60x70x80x90xa0xb0xc0xd0xe0xf0x100x110x120x130x140x150x160x170x180x19$$$$$$0x1a0x1b0x1c0x1d0x1e0x1f0x200x210x220x230x240x250x260x270x280x290x2a0x2b0x2c0x2d0x2e0x2f0x300x310x320x33"
+    /// Returns whether @p in only consists of complete groups of Base64 characters (with at most two padding characters at the end)
+    bool isCanonicalBase64_(const char* in, Size size)
+    {
+      if (size % 4 != 0)
+      {
+        return false;
+      }
+      Size end = size;
+      if (end > 0 && in[end - 1] == '=') --end;
+      if (end > 0 && in[end - 1] == '=') --end;
+      // no early exit, so the loop can be vectorized (invalid characters have the highest bit set)
+      const unsigned char* table = base64_decode_table_.values;
+      unsigned char values = 0;
+      for (Size i = 0; i < end; ++i)
+      {
+        values |= table[(unsigned char)in[i]];
+      }
+      return (values & 0x80) == 0;
+    }
 
-  which would allow lookup[char] without any adding or subtraction step (but
-  needs a 42 byte extra memory in the local cache).
+    /// Scalar encoding of complete 3 byte groups, returns the number of bytes consumed
+    Size encodeGroupsScalar_(const Byte* in, Size size, Byte* to, const char* encoder)
+    {
+      Size i = 0;
+      for (; i + 3 <= size; i += 3)
+      {
+        const UInt32 int_24bit = (UInt32(in[i]) << 16) | (UInt32(in[i + 1]) << 8) | UInt32(in[i + 2]);
+        *to++ = encoder[(int_24bit >> 18) & 0x3F];
+        *to++ = encoder[(int_24bit >> 12) & 0x3F];
+        *to++ = encoder[(int_24bit >> 6) & 0x3F];
+        *to++ = encoder[int_24bit & 0x3F];
+      }
+      return i;
+    }
 
-  */
+    /// Scalar decoding of complete 4 character groups (no padding), returns the number of characters consumed
+    Size decodeGroupsScalar_(const char* in, Size size, Byte* out, Size out_size)
+    {
+      const unsigned char* table = base64_decode_table_.values;
+      Size i = 0, o = 0;
+      for (; i + 4 <= size && o < out_size; i += 4)
+      {
+        const UInt32 int_24bit = (UInt32(table[(unsigned char)in[i]]) << 18) |
+                                 (UInt32(table[(unsigned char)in[i + 1]]) << 12) |
+                                 (UInt32(table[(unsigned char)in[i + 2]]) << 6) |
+                                 UInt32(table[(unsigned char)in[i + 3]]);
+        const Byte bytes[3] = {Byte(int_24bit >> 16), Byte(int_24bit >> 8), Byte(int_24bit)};
+        const Size n = std::min<Size>(3, out_size - o);
+        std::memcpy(out + o, bytes, n);
+        o += n;
+      }
+      return i;
+    }
 
-  const char Base64::encoder_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  const char Base64::decoder_[] = "|$$$}rstuvwxyz{$$$$$$$>?@ABCDEFGHIJKLMNOPQRSTUVW$$$$$$XYZ[\\]^_`abcdefghijklmnopq";
+#ifdef OPENMS_BASE64_X86_SIMD
+    // The SIMD kernels follow the approach of W. Mula and D. Lemire ("Faster
+    // Base64 Encoding and Decoding using AVX2 Instructions", 2018): characters
+    // are translated to 6 bit values using range comparisons and the 6 bit
+    // values are packed with multiply-add instructions (and vice versa).
+
+    __attribute__((target("ssse3")))
+    inline __m128i encodeTranslate128_(const __m128i indices)
+    {
+      // A-Z: +65, a-z: +71, 0-9: -4, '+': -19, '/': -16
+      __m128i shift = _mm_set1_epi8(65);
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)), _mm_set1_epi8(-75)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(62)), _mm_set1_epi8(-15)));
+      shift = _mm_add_epi8(shift, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(63)), _mm_set1_epi8(-12)));
+      return _mm_add_epi8(indices, shift);
+    }
+
+    __attribute__((target("ssse3")))
+    inline __m128i encodeReshuffle128_(__m128i in)
+    {
+      // spread the 12 input bytes to 16 bytes, then move the 6 bit groups into place
+      in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+      const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+      const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+      const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+      const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+      return _mm_or_si128(t1, t3);
+    }
+
+    __attribute__((target("ssse3")))
+    Size encodeGroupsSSSE3_(const Byte* in, Size size, Byte* to, const char*)
+    {
+      Size i = 0;
+      // 12 bytes are encoded per iteration, but 16 bytes are loaded
+      for (; i + 16 <= size; i += 12)
+      {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to), encodeTranslate128_(encodeReshuffle128_(data)));
+        to += 16;
+      }
+      return i;
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256i encodeTranslate256_(const __m256i indices)
+    {
+      __m256i shift = _mm256_set1_epi8(65);
+      shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)), _mm256_set1_epi8(6)));
+      shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(51)), _mm256_set1_epi8(-75)));
+      shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(indices, _mm256_set1_epi8(62)), _mm256_set1_epi8(-15)));
+      shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(indices, _mm256_set1_epi8(63)), _mm256_set1_epi8(-12)));
+      return _mm256_add_epi8(indices, shift);
+    }
+
+    __attribute__((target("avx2")))
+    Size encodeGroupsAVX2_(const Byte* in, Size size, Byte* to, const char* encoder)
+    {
+      Size i = 0;
+      // 24 bytes are encoded per iteration (12 per 128 bit lane), 28 bytes are loaded
+      for (; i + 28 <= size; i += 24)
+      {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));
+        __m256i data = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        data = _mm256_shuffle_epi8(data, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                         10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        const __m256i t0 = _mm256_and_si256(data, _mm256_set1_epi32(0x0FC0FC00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(data, _mm256_set1_epi32(0x003F03F0));
+        const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(to), encodeTranslate256_(_mm256_or_si256(t1, t3)));
+        to += 32;
+      }
+      return i + encodeGroupsSSSE3_(in + i, size - i, to, encoder);
+    }
+
+    /// Translates 16 characters to 6 bit values, returns false if an invalid character was found
+    __attribute__((target("ssse3")))
+    inline bool decodeTranslate128_(const __m128i c, __m128i& values)
+    {
+      const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+      const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('z' + 1)));
+      const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+      const __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+      const __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+      const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+      if (_mm_movemask_epi8(valid) != 0xFFFF)
+      {
+        return false;
+      }
+      __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+      shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+      shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+      shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+      shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+      values = _mm_add_epi8(c, shift);
+      return true;
+    }
+
+    __attribute__((target("ssse3")))
+    Size decodeGroupsSSSE3_(const char* in, Size size, Byte* out, Size out_size)
+    {
+      Size i = 0, o = 0;
+      // 16 characters are decoded to 12 bytes per iteration, 16 bytes are stored
+      for (; i + 16 <= size && o + 16 <= out_size; i += 16, o += 12)
+      {
+        __m128i values;
+        if (!decodeTranslate128_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), values))
+        {
+          break; // let the scalar code handle invalid characters
+        }
+        // pack 4 x 6 bit to 3 bytes in each 32 bit word
+        const __m128i merged_ab_cd = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i merged = _mm_madd_epi16(merged_ab_cd, _mm_set1_epi32(0x00011000));
+        const __m128i bytes = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), bytes);
+      }
+      return i;
+    }
+
+    __attribute__((target("avx2")))
+    Size decodeGroupsAVX2_(const char* in, Size size, Byte* out, Size out_size)
+    {
+      Size i = 0, o = 0;
+      // 32 characters are decoded to 24 bytes per iteration, 32 bytes are stored
+      for (; i + 32 <= size && o + 32 <= out_size; i += 32, o += 24)
+      {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+        const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        const __m256i plus = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('+'));
+        const __m256i slash = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('/'));
+        const __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(_mm256_or_si256(digit, plus), slash));
+        if (_mm256_movemask_epi8(valid) != -1)
+        {
+          break; // let the scalar code handle invalid characters
+        }
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-65));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(-71)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(4)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(19)));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(16)));
+        const __m256i values = _mm256_add_epi8(c, shift);
+
+        const __m256i merged_ab_cd = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i merged = _mm256_madd_epi16(merged_ab_cd, _mm256_set1_epi32(0x00011000));
+        __m256i bytes = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                                     2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        // move the 12 bytes of the upper lane next to the 12 bytes of the lower lane
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), bytes);
+      }
+      return i + decodeGroupsSSSE3_(in + i, size - i, out + o, out_size - o);
+    }
+#endif
+
+    typedef Size (*EncodeGroupsFunc_)(const Byte*, Size, Byte*, const char*);
+    typedef Size (*DecodeGroupsFunc_)(const char*, Size, Byte*, Size);
+
+    /// Returns the fastest encoder supported by the CPU
+    EncodeGroupsFunc_ selectEncoder_()
+    {
+#ifdef OPENMS_BASE64_X86_SIMD
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) return &encodeGroupsAVX2_;
+      if (__builtin_cpu_supports("ssse3")) return &encodeGroupsSSSE3_;
+#endif
+      return &encodeGroupsScalar_;
+    }
+
+    /// Returns the fastest decoder supported by the CPU
+    DecodeGroupsFunc_ selectDecoder_()
+    {
+#ifdef OPENMS_BASE64_X86_SIMD
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) return &decodeGroupsAVX2_;
+      if (__builtin_cpu_supports("ssse3")) return &decodeGroupsSSSE3_;
+#endif
+      return &decodeGroupsScalar_;
+    }
+
+    /// Decodes input accepted by isCanonicalBase64_ (see Base64::decodeBytes_)
+    Size decodeCanonicalBase64_(const char* in, Size size, Byte* out, Size out_size)
+    {
+      static const DecodeGroupsFunc_ decode_groups = selectDecoder_();
+
+      size -= size % 4; // ignore incomplete groups
+      out_size = std::min(out_size, size / 4 * 3);
+      if (out_size == 0)
+      {
+        return 0;
+      }
+
+      // all groups but the last one cannot contain padding: SIMD (if available), then scalar
+      const Size body = size - 4;
+      Size done = decode_groups(in, body, out, out_size);
+      done += decodeGroupsScalar_(in + done, body - done, out + done / 4 * 3, out_size - std::min(out_size, done / 4 * 3));
+
+      // last group (padding characters are decoded as zero bits)
+      const Size written = done / 4 * 3;
+      if (written < out_size)
+      {
+        char last[4];
+        std::memcpy(last, in + body, 4);
+        for (char& c : last)
+        {
+          if (c == '=') c = 'A';
+        }
+        decodeGroupsScalar_(last, 4, out + written, out_size - written);
+      }
+      return out_size;
+    }
+  }
+
+  void Base64::encodeBytes_(const Byte* in, Size size, String& out)
+  {
+    static const EncodeGroupsFunc_ encode_groups = selectEncoder_();
+
+    out.resize((size + 2) / 3 * 4);
+    if (size == 0)
+    {
+      return;
+    }
+    Byte* to = reinterpret_cast<Byte*>(&out[0]);
+
+    // complete groups of 3 bytes: SIMD (if available), then scalar
+    Size done = encode_groups(in, size, to, encoder_);
+    done += encodeGroupsScalar_(in + done, size - done, to + done / 3 * 4, encoder_);
+
+    // last incomplete group (with padding)
+    if (done < size)
+    {
+      to += done / 3 * 4;
+      UInt32 int_24bit = UInt32(in[done]) << 16;
+      if (done + 1 < size)
+      {
+        int_24bit |= UInt32(in[done + 1]) << 8;
+      }
+      to[0] = encoder_[(int_24bit >> 18) & 0x3F];
+      to[1] = encoder_[(int_24bit >> 12) & 0x3F];
+      to[2] = (done + 1 < size) ? encoder_[(int_24bit >> 6) & 0x3F] : '=';
+      to[3] = '=';
+    }
+  }
+
+  Size Base64::decodedSize_(const char* in, Size size)
+  {
+    if (size < 4)
+    {
+      return 0;
+    }
+    Size padding = 0;
+    if (in[size - 1] == '=') ++padding;
+    if (in[size - 2] == '=') ++padding;
+    return size / 4 * 3 - padding;
+  }
+
+  Size Base64::decodeBytes_(const char* in, Size size, Byte* out, Size out_size)
+  {
+    if (!isCanonicalBase64_(in, size))
+    { // e.g. line breaks: let Qt deal with it, which skips all characters outside of the alphabet
+      const QByteArray decoded = QByteArray::fromBase64(QByteArray::fromRawData(in, (int) size));
+      out_size = std::min(out_size, (Size) decoded.size());
+      std::memcpy(out, decoded.constData(), out_size);
+      return out_size;
+    }
+    return decodeCanonicalBase64_(in, size, out, out_size);
+  }
 
   void Base64::encodeStrings(const std::vector<String>& in, String& out, bool zlib_compression, bool append_null_byte)
   {
@@ -133,8 +463,6 @@ print s
     }
     std::string str;
     std::string compressed;
-    Byte* it;
-    Byte* end;
     for (Size i = 0; i < in.size(); ++i)
     {
       str = str.append(in[i]);
@@ -171,60 +499,12 @@ print s
         throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Compression error?");
       }
 
-      it = reinterpret_cast<Byte*>(&compressed[0]);
-      end = it + compressed_length;
-      // TODO check integer overflow
-      out.resize((Size)ceil(compressed_length / 3.) * 4); //resize output array in order to have enough space for all characters
+      encodeBytes_(reinterpret_cast<const Byte*>(compressed.data()), compressed_length, out);
     }
     else
     {
-      // TODO check integer overflow
-      out.resize((Size)ceil(str.size() / 3.) * 4); //resize output array in order to have enough space for all characters
-      it = reinterpret_cast<Byte*>(&str[0]);
-      end = it + str.size();
-    }
-    Byte* to = reinterpret_cast<Byte*>(&out[0]);
-    Size written = 0;
-
-    while (it != end)
-    {
-      Int int_24bit = 0;
-      Int padding_count = 0;
-
-      // construct 24-bit integer from 3 bytes
-      for (Size i = 0; i < 3; i++)
-      {
-        if (it != end)
-        {
-          int_24bit |= *it++ << ((2 - i) * 8);
-        }
-        else
-        {
-          padding_count++;
-        }
-      }
-
-      // write out 4 characters
-      for (Int i = 3; i >= 0; i--)
-      {
-        to[i] = encoder_[int_24bit & 0x3F];
-        int_24bit >>= 6;
-      }
-
-      // fixup for padding
-      if (padding_count > 0)
-      {
-        to[3] = '=';
-      }
-      if (padding_count > 1)
-      {
-        to[2] = '=';
-      }
-      to += 4;
-      written += 4;
+      encodeBytes_(reinterpret_cast<const Byte*>(str.data()), str.size(), out);
     }
-
-    out.resize(written); //no more space is needed
   }
 
   void Base64::decodeStrings(const String& in, std::vector<String>& out, bool zlib_compression)
@@ -259,24 +539,45 @@ print s
       return;
     }
 
-    QByteArray herewego = QByteArray::fromRawData(in.c_str(), (int) in.size());
-    base64_uncompressed = QByteArray::fromBase64(herewego);
     if (zlib_compression)
     {
-      QByteArray czip;
+      base64_uncompressed = uncompressBase64_(in);
+    }
+    else
+    {
+      QByteArray herewego = QByteArray::fromRawData(in.c_str(), (int) in.size());
+      base64_uncompressed = QByteArray::fromBase64(herewego);
+    }
+  }
+
+  QByteArray Base64::uncompressBase64_(const String& in)
+  {
+    // qUncompress expects the (expected) size of the data as 4 byte header
+    QByteArray czip;
+    if (isCanonicalBase64_(in.c_str(), in.size()))
+    {
+      const Size zipped_size = decodedSize_(in.c_str(), in.size());
+      czip.resize((int) (4 + zipped_size));
+      decodeCanonicalBase64_(in.c_str(), in.size(), reinterpret_cast<Byte*>(czip.data()) + 4, zipped_size);
+    }
+    else
+    {
+      // irregular input (e.g. containing whitespace), let Qt deal with it (skips all characters outside of the alphabet)
       czip.resize(4);
-      czip[0] = (base64_uncompressed.size() & 0xff000000) >> 24;
-      czip[1] = (base64_uncompressed.size() & 0x00ff0000) >> 16;
-      czip[2] = (base64_uncompressed.size() & 0x0000ff00) >> 8;
-      czip[3] = (base64_uncompressed.size() & 0x000000ff);
-      czip += base64_uncompressed;
-      base64_uncompressed = qUncompress(czip);
-
-      if (base64_uncompressed.isEmpty())
-      {
-        throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
-      }
+      czip += QByteArray::fromBase64(QByteArray::fromRawData(in.c_str(), (int) in.size()));
+    }
+    const int zipped_size = czip.size() - 4;
+    czip[0] = (zipped_size & 0xff000000) >> 24;
+    czip[1] = (zipped_size & 0x00ff0000) >> 16;
+    czip[2] = (zipped_size & 0x0000ff00) >> 8;
+    czip[3] = (zipped_size & 0x000000ff);
+
+    QByteArray base64_uncompressed = qUncompress(czip);
+    if (base64_uncompressed.isEmpty())
+    {
+      throw Exception::ConversionError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Decompression error?");
     }
+    return base64_uncompressed;
   }
 
 } //end OpenMS
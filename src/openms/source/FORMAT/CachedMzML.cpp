@@ -44,6 +44,8 @@
 
 #include <OpenMS/FORMAT/HANDLERS/CachedMzMLHandler.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
 namespace OpenMS
 {
 
@@ -63,11 +65,17 @@ namespace OpenMS
 
   CachedmzML::CachedmzML(const CachedmzML & rhs) :
     meta_ms_experiment_(rhs.meta_ms_experiment_),
-    ifs_(rhs.filename_cached_.c_str(), std::ios::binary),
+    mapped_file_(rhs.mapped_file_),
     filename_(rhs.filename_),
+    filename_cached_(rhs.filename_cached_),
     spectra_index_(rhs.spectra_index_),
     chrom_index_(rhs.chrom_index_)
   {
+    // only a copy which cannot share the memory-mapped file needs its own filestream
+    if (!mapped_file_ && !filename_cached_.empty())
+    {
+      ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    }
   }
 
   void CachedmzML::load_(const String& filename)
@@ -81,17 +89,53 @@ namespace OpenMS
     spectra_index_ = cache.getSpectraIndex();
     chrom_index_ = cache.getChromatogramIndex();;
 
-    // open the filestream
-    ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    // map the file into memory, fall back to a filestream if that is not possible
+    if (ifs_.is_open())
+    {
+      ifs_.close();
+    }
+    try
+    {
+      mapped_file_ = std::make_shared<const boost::iostreams::mapped_file_source>(filename_cached_);
+    }
+    catch (std::exception&)
+    {
+      mapped_file_.reset();
+    }
+    if (!mapped_file_)
+    {
+      ifs_.open(filename_cached_.c_str(), std::ios::binary);
+    }
 
     // load the meta data from disk
     MzMLFile().load(filename, meta_ms_experiment_);
   }
 
+  const char* CachedmzML::getMappedData_(std::streampos pos, Size& available) const
+  {
+    const Size offset = static_cast<Size>(pos);
+    if (offset > mapped_file_->size())
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Position " + String(offset) + " is outside of the mapped file.", filename_cached_);
+    }
+    available = mapped_file_->size() - offset;
+    return mapped_file_->data() + offset;
+  }
+
   MSSpectrum CachedmzML::getSpectrum(Size id)
   {
     OPENMS_PRECONDITION(id < getNrSpectra(), "Id cannot be larger than number of spectra");
 
+    if (mapped_file_)
+    {
+      Size available;
+      const char* data = getMappedData_(spectra_index_[id], available);
+      MSSpectrum s = meta_ms_experiment_.getSpectrum(id);
+      Internal::CachedMzMLHandler::readSpectrum(s, data, available);
+      return s;
+    }
+
     if ( !ifs_.seekg(spectra_index_[id]) )
     {
       std::cerr << "Error while reading spectrum " << id << " - seekg created an error when trying to change position to " << spectra_index_[id] << "." << std::endl;
@@ -109,6 +153,15 @@ namespace OpenMS
   {
     OPENMS_PRECONDITION(id < getNrChromatograms(), "Id cannot be larger than number of chromatograms");
 
+    if (mapped_file_)
+    {
+      Size available;
+      const char* data = getMappedData_(chrom_index_[id], available);
+      MSChromatogram c = meta_ms_experiment_.getChromatogram(id);
+      Internal::CachedMzMLHandler::readChromatogram(c, data, available);
+      return c;
+    }
+
     if ( !ifs_.seekg(chrom_index_[id]) )
     {
       std::cerr << "Error while reading chromatogram " << id << " - seekg created an error when trying to change position to " << chrom_index_[id] << "." << std::endl;
@@ -41,6 +41,10 @@
 #include <OpenMS/SYSTEM/File.h>
 #include <fstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -115,7 +119,54 @@ namespace OpenMS
     Internal::ConsensusXMLHandler handler(consensus_map, filename);
     handler.setOptions(options_);
     handler.setLogType(getLogType());
-    parse_(filename, &handler);
+
+    SplitDocument document;
+    if (!splitDocument_(filename, "consensusElement", "consensusElementList", document))
+    {
+      parse_(filename, &handler);
+    }
+    else
+    {
+      // parse everything but the consensus elements first, then the chunks of consensus elements in parallel
+      // the handler only sees the skeleton, so the progress is reported over the parsed chunks instead
+      handler.setLogType(ProgressLogger::NONE);
+      parseBuffer_(document.skeleton, &handler);
+      vector<ConsensusMap> chunk_maps(document.chunks.size());
+      startProgress(0, document.chunks.size(), "loading consensusXML file");
+      Size chunks_done(0);
+      parseChunks_(document, [&](Size i)
+      {
+        Internal::ConsensusXMLHandler chunk_handler(chunk_maps[i], filename);
+        chunk_handler.setOptions(options_);
+        chunk_handler.setSplitContext(handler.getSplitContexts().at(document.chunk_blocks[i]));
+        parseBuffer_(document.getChunkDocument(i), &chunk_handler);
+
+        Size done;
+#pragma omp atomic capture
+        done = ++chunks_done;
+        IF_MASTERTHREAD
+        {
+          setProgress(done);
+        }
+      });
+      endProgress();
+
+      // append the consensus elements in document order
+      Size n_elements = consensus_map.size();
+      for (const ConsensusMap& chunk_map : chunk_maps)
+      {
+        n_elements += chunk_map.size();
+      }
+      consensus_map.reserve(n_elements);
+      for (ConsensusMap& chunk_map : chunk_maps)
+      {
+        for (ConsensusFeature& element : chunk_map)
+        {
+          consensus_map.push_back(std::move(element));
+        }
+        chunk_map.clear(true);
+      }
+    }
 
     if (!consensus_map.isMapConsistent(&OpenMS_Log_warn)) // a warning is printed to LOG_WARN during isMapConsistent()
     {
@@ -44,6 +44,10 @@
 
 #include <fstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -79,7 +83,54 @@ namespace OpenMS
     Internal::FeatureXMLHandler handler(feature_map, filename);
     handler.setOptions(options_);
     handler.setLogType(getLogType());
-    parse_(filename, &handler);
+
+    SplitDocument document;
+    if (options_.getMetadataOnly() || !splitDocument_(filename, "feature", "featureList", document))
+    {
+      parse_(filename, &handler);
+    }
+    else
+    {
+      // parse everything but the features first, then the chunks of features in parallel
+      // the handler only sees the skeleton, so the progress is reported over the parsed chunks instead
+      handler.setLogType(ProgressLogger::NONE);
+      parseBuffer_(document.skeleton, &handler);
+      vector<FeatureMap> chunk_maps(document.chunks.size());
+      startProgress(0, document.chunks.size(), "Loading featureXML file");
+      Size chunks_done(0);
+      parseChunks_(document, [&](Size i)
+      {
+        Internal::FeatureXMLHandler chunk_handler(chunk_maps[i], filename);
+        chunk_handler.setOptions(options_);
+        chunk_handler.setSplitContext(handler.getSplitContexts().at(document.chunk_blocks[i]));
+        parseBuffer_(document.getChunkDocument(i), &chunk_handler);
+
+        Size done;
+#pragma omp atomic capture
+        done = ++chunks_done;
+        IF_MASTERTHREAD
+        {
+          setProgress(done);
+        }
+      });
+      endProgress();
+
+      // append the features in document order
+      Size n_features = feature_map.size();
+      for (const FeatureMap& chunk_map : chunk_maps)
+      {
+        n_features += chunk_map.size();
+      }
+      feature_map.reserve(n_features);
+      for (FeatureMap& chunk_map : chunk_maps)
+      {
+        for (Feature& feature : chunk_map)
+        {
+          feature_map.push_back(std::move(feature));
+        }
+        chunk_map.clear(true);
+      }
+    }
 
     // !!! Hack: set feature FWHM from meta info entries as
     // long as featureXML doesn't support a width entry.
@@ -37,8 +37,87 @@
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
 
+#include <cstring>
+
 namespace OpenMS::Internal
 {
+  namespace
+  {
+    /// Sequential reading from a memory buffer, throws Exception::ParseError instead of reading past its end
+    class MemoryReader_
+    {
+  public:
+      MemoryReader_(const char* data, Size size) :
+        pos_(data),
+        end_(data + size)
+      {
+      }
+
+      void read(void* target, Size bytes)
+      {
+        checkAvailable_(bytes);
+        std::memcpy(target, pos_, bytes);
+        pos_ += bytes;
+      }
+
+      void readArray(std::vector<double>& target, Size length)
+      {
+        if (length > available_() / sizeof(double))
+        {
+          throwParseError_();
+        }
+        target.resize(length);
+        read(target.data(), length * sizeof(double));
+      }
+
+      void readString(std::string& target, Size length)
+      {
+        checkAvailable_(length);
+        target.assign(pos_, length);
+        pos_ += length;
+      }
+
+  private:
+      Size available_() const
+      {
+        return static_cast<Size>(end_ - pos_);
+      }
+
+      void checkAvailable_(Size bytes) const
+      {
+        if (bytes > available_())
+        {
+          throwParseError_();
+        }
+      }
+
+      [[noreturn]] static void throwParseError_()
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Read past the end of the cached data, something is wrong here. Aborting.", "memory");
+      }
+
+      const char* pos_;
+      const char* end_;
+    };
+
+    /// read the data arrays of a spectrum or chromatogram (equivalent to CachedMzMLHandler::readDataFast_)
+    void readDataFromMemory_(MemoryReader_& reader, std::vector<OpenSwath::BinaryDataArrayPtr>& data, Size data_size, Size nr_float_arrays)
+    {
+      reader.readArray(data[0]->data, data_size);
+      reader.readArray(data[1]->data, data_size);
+      for (Size k = 0; k < nr_float_arrays; k++)
+      {
+        data.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+        Size len, len_name;
+        reader.read(&len, sizeof(len));
+        reader.read(&len_name, sizeof(len_name));
+        reader.readString(data.back()->description, len_name);
+        reader.readArray(data.back()->data, len);
+      }
+    }
+  }
+
   CachedMzMLHandler::CachedMzMLHandler()
   {
   }
@@ -402,11 +481,56 @@ namespace OpenMS::Internal
     return data;
   }
 
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readSpectrumFast(const char* data, Size data_size, int& ms_level, double& rt)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> arrays;
+    arrays.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    arrays.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    MemoryReader_ reader(data, data_size);
+    Size spec_size, nr_float_arrays;
+    reader.read(&spec_size, sizeof(spec_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+    reader.read(&ms_level, sizeof(ms_level));
+    reader.read(&rt, sizeof(rt));
+
+    readDataFromMemory_(reader, arrays, spec_size, nr_float_arrays);
+    return arrays;
+  }
+
+  std::vector<OpenSwath::BinaryDataArrayPtr> CachedMzMLHandler::readChromatogramFast(const char* data, Size data_size)
+  {
+    std::vector<OpenSwath::BinaryDataArrayPtr> arrays;
+    arrays.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+    arrays.push_back(OpenSwath::BinaryDataArrayPtr(new OpenSwath::BinaryDataArray));
+
+    MemoryReader_ reader(data, data_size);
+    Size chrom_size, nr_float_arrays;
+    reader.read(&chrom_size, sizeof(chrom_size));
+    reader.read(&nr_float_arrays, sizeof(nr_float_arrays));
+
+    readDataFromMemory_(reader, arrays, chrom_size, nr_float_arrays);
+    return arrays;
+  }
+
   void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, std::ifstream& ifs)
   {
     int ms_level;
     double rt;
     std::vector<OpenSwath::BinaryDataArrayPtr> data = readSpectrumFast(ifs, ms_level, rt);
+    fillSpectrum_(spectrum, data, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::readSpectrum(SpectrumType& spectrum, const char* data, Size data_size)
+  {
+    int ms_level;
+    double rt;
+    std::vector<OpenSwath::BinaryDataArrayPtr> arrays = readSpectrumFast(data, data_size, ms_level, rt);
+    fillSpectrum_(spectrum, arrays, ms_level, rt);
+  }
+
+  void CachedMzMLHandler::fillSpectrum_(SpectrumType& spectrum, const std::vector<OpenSwath::BinaryDataArrayPtr>& data, int ms_level, double rt)
+  {
     spectrum.reserve(data[0]->data.size());
     spectrum.setMSLevel(ms_level);
     spectrum.setRT(rt);
@@ -430,7 +554,16 @@ namespace OpenMS::Internal
 
   void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, std::ifstream& ifs)
   {
-    std::vector<OpenSwath::BinaryDataArrayPtr> data = readChromatogramFast(ifs);
+    fillChromatogram_(chromatogram, readChromatogramFast(ifs));
+  }
+
+  void CachedMzMLHandler::readChromatogram(ChromatogramType& chromatogram, const char* data, Size data_size)
+  {
+    fillChromatogram_(chromatogram, readChromatogramFast(data, data_size));
+  }
+
+  void CachedMzMLHandler::fillChromatogram_(ChromatogramType& chromatogram, const std::vector<OpenSwath::BinaryDataArrayPtr>& data)
+  {
     chromatogram.reserve(data[0]->data.size());
 
     for (Size j = 0; j < data[0]->data.size(); j++)
@@ -446,7 +579,7 @@ namespace OpenMS::Internal
     {
       MSChromatogram::FloatDataArray fda;
       fda.reserve(data[j]->data.size());
-      for (const auto& k : fda) fda.push_back(k);
+      for (const auto& k : data[j]->data) fda.push_back(k);
       fda.setName(data[j]->description);
       fdas.push_back(fda);
     }
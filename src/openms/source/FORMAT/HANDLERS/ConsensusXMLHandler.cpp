@@ -50,7 +50,8 @@ namespace OpenMS::Internal
     XMLHandler("", "1.7"),
     ProgressLogger(),
     act_cons_element_(),
-    last_meta_(nullptr)
+    last_meta_(nullptr),
+    progress_(0)
   {
     consensus_map_ = &map;
     file_ = filename;
@@ -60,7 +61,8 @@ namespace OpenMS::Internal
     XMLHandler("", "1.7"),
     ProgressLogger(),
     act_cons_element_(),
-    last_meta_(nullptr)
+    last_meta_(nullptr),
+    progress_(0)
   {
     cconsensus_map_ = &map;
     file_ = filename;
@@ -83,6 +85,27 @@ namespace OpenMS::Internal
     return options_;
   }
 
+  const std::vector<ConsensusXMLHandler::SplitContext>& ConsensusXMLHandler::getSplitContexts() const
+  {
+    return split_contexts_;
+  }
+
+  void ConsensusXMLHandler::setSplitContext(const SplitContext& context)
+  {
+    id_identifier_ = context.id_identifier;
+    proteinid_to_accession_ = context.proteinid_to_accession;
+  }
+
+  void ConsensusXMLHandler::splitBlock_(Size block)
+  {
+    if (split_contexts_.size() <= block)
+    {
+      split_contexts_.resize(block + 1);
+    }
+    split_contexts_[block].id_identifier = id_identifier_;
+    split_contexts_[block].proteinid_to_accession = proteinid_to_accession_;
+  }
+
   void ConsensusXMLHandler::endElement(const XMLCh* const /*uri*/, const XMLCh* const /*local_name*/, const XMLCh* const qname)
   {
     String tag = sm_.convert(qname);
@@ -90,7 +90,28 @@ namespace OpenMS::Internal
     identifier_id_.clear();
     id_identifier_.clear();
     search_param_ = ProteinIdentification::SearchParameters();
+    split_contexts_.clear();
+  }
+
+  const std::vector<FeatureXMLHandler::SplitContext>& FeatureXMLHandler::getSplitContexts() const
+  {
+    return split_contexts_;
+  }
+
+  void FeatureXMLHandler::setSplitContext(const SplitContext& context)
+  {
+    id_identifier_ = context.id_identifier;
+    proteinid_to_accession_ = context.proteinid_to_accession;
+  }
 
+  void FeatureXMLHandler::splitBlock_(Size block)
+  {
+    if (split_contexts_.size() <= block)
+    {
+      split_contexts_.resize(block + 1);
+    }
+    split_contexts_[block].id_identifier = id_identifier_;
+    split_contexts_[block].proteinid_to_accession = proteinid_to_accession_;
   }
 
   void FeatureXMLHandler::writeTo(std::ostream& os)
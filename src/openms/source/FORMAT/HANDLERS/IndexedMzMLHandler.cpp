@@ -37,6 +37,10 @@
 #include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/FORMAT/HANDLERS/MzMLSpectrumDecoder.h>
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstring>
+
 
 // #define DEBUG_READER
 
@@ -102,15 +106,22 @@ namespace OpenMS::Internal
   IndexedMzMLHandler::IndexedMzMLHandler(const IndexedMzMLHandler& source) :
     filename_(source.filename_),
     spectra_offsets_(source.spectra_offsets_),
+    spectra_native_ids_(source.spectra_native_ids_),
     chromatograms_offsets_(source.chromatograms_offsets_),
+    chromatograms_native_ids_(source.chromatograms_native_ids_),
     index_offset_(source.index_offset_),
     spectra_before_chroms_(source.spectra_before_chroms_),
-    // do not copy the filestream itself but open a new filestream using the same file
-    // this is critical for parallel access to the same file!
-    filestream_(source.filename_.c_str()),
+    mapped_file_(source.mapped_file_),
     parsing_success_(source.parsing_success_),
     skip_xml_checks_(source.skip_xml_checks_)
   {
+    // the memory-mapped file can be shared, but do not copy the filestream
+    // itself and open a new filestream using the same file instead
+    // this is critical for parallel access to the same file!
+    if (!mapped_file_)
+    {
+      filestream_.open(source.filename_.c_str());
+    }
   }
 
   IndexedMzMLHandler::~IndexedMzMLHandler()
@@ -124,10 +135,28 @@ namespace OpenMS::Internal
       filestream_.close();
     }
     filename_ = filename;
-    filestream_.open(filename);
+
+    // map the file into memory, fall back to a filestream if that is not possible
+    try
+    {
+      mapped_file_ = std::make_shared<const boost::iostreams::mapped_file_source>(filename_);
+    }
+    catch (std::exception&)
+    {
+      mapped_file_.reset();
+    }
+    if (!mapped_file_)
+    {
+      filestream_.open(filename);
+    }
     parseFooter_();
   }
 
+  bool IndexedMzMLHandler::isMemoryMapped() const
+  {
+    return mapped_file_ != nullptr;
+  }
+
   bool IndexedMzMLHandler::getParsingSuccess() const
   {
     return parsing_success_;
@@ -187,20 +216,7 @@ namespace OpenMS::Internal
       endidx = chromatograms_offsets_[chromToGet + 1];
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
-
-#ifdef DEBUG_READER
-    // print the full text we just read
-    std::cout << text << std::endl;
-#endif
-
-    return text;
+    return readText_(startidx, endidx);
   }
 
   std::string IndexedMzMLHandler::getSpectrumById_helper_(int id)
@@ -247,13 +263,35 @@ namespace OpenMS::Internal
       endidx = spectra_offsets_[spectrumToGet + 1];
     }
 
-    std::streampos readl = endidx - startidx;
-    char* buffer = new char[readl + std::streampos(1)];
-    filestream_.seekg(startidx, filestream_.beg);
-    filestream_.read(buffer, readl);
-    buffer[readl] = '\0';
-    std::string text(buffer);
-    delete[] buffer;
+    return readText_(startidx, endidx);
+  }
+
+  std::string IndexedMzMLHandler::readText_(std::streampos startidx, std::streampos endidx)
+  {
+    std::string text;
+    if (mapped_file_)
+    {
+      // read directly from the mapped file (does not modify any state)
+      const Size start = static_cast<Size>(startidx);
+      const Size end = std::min(static_cast<Size>(endidx), mapped_file_->size());
+      if (start < end)
+      {
+        // stop at the first null byte (same as reading from the filestream)
+        const char* begin = mapped_file_->data() + start;
+        const char* null_byte = static_cast<const char*>(std::memchr(begin, '\0', end - start));
+        text.assign(begin, null_byte != nullptr ? null_byte : begin + (end - start));
+      }
+    }
+    else
+    {
+      std::streampos readl = endidx - startidx;
+      char* buffer = new char[readl + std::streampos(1)];
+      filestream_.seekg(startidx, filestream_.beg);
+      filestream_.read(buffer, readl);
+      buffer[readl] = '\0';
+      text = buffer;
+      delete[] buffer;
+    }
 
 #ifdef DEBUG_READER
     // print the full text we just read
@@ -280,12 +318,13 @@ namespace OpenMS::Internal
 
   void IndexedMzMLHandler::getMSSpectrumByNativeId(std::string id, MSSpectrum& s)
   {
-    if (spectra_native_ids_.find(id) == spectra_native_ids_.end())
+    auto it = spectra_native_ids_.find(id);
+    if (it == spectra_native_ids_.end())
     {
       throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
           String( "Could not find spectrum id " + String(id) ));
     }
-    getMSSpectrumById(spectra_native_ids_[id], s);
+    getMSSpectrumById(it->second, s);
   }
 
   void IndexedMzMLHandler::getMSSpectrumById(int id, MSSpectrum& s)
@@ -44,8 +44,13 @@
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <future>
 #include <map>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS::Internal
 {
 
@@ -82,13 +87,22 @@ namespace OpenMS::Internal
     /// Destructor
     MzMLHandler::~MzMLHandler()
     {
+      try
+      {
+        waitForDecoding();
+      }
+      catch (...)
+      { // destructors must not throw, the error was (or should have been) reported by waitForDecoding() before
+      }
     }
     /// Set the peak file options
     void MzMLHandler::setOptions(const PeakFileOptions& opt)
     {
       options_ = opt;
       spectrum_data_.reserve(options_.getMaxDataPoolSize());
+      spectrum_data_decoding_.reserve(options_.getMaxDataPoolSize());
       chromatogram_data_.reserve(options_.getMaxDataPoolSize());
+      chromatogram_data_decoding_.reserve(options_.getMaxDataPoolSize());
     }
 
     /// Get the peak file options
@@ -135,6 +149,88 @@ namespace OpenMS::Internal
 
     void MzMLHandler::populateSpectraWithData_()
     {
+      // finish the batch decoded in the background (if any) first to keep the order
+      finishSpectraDecoding_();
+      reportWarnings_(decodeSpectra_(spectrum_data_));
+      appendSpectra_(spectrum_data_);
+    }
+
+    void MzMLHandler::populateSpectraWithDataAsync_()
+    {
+#ifdef _OPENMP
+      // when loading several files in parallel, a background thread with its
+      // own thread team would oversubscribe the machine: decode synchronously
+      if (omp_in_parallel())
+      {
+        populateSpectraWithData_();
+        return;
+      }
+#endif
+      finishSpectraDecoding_();
+      // decode the full batch in the background while the parser fills the next one
+      spectrum_data_.swap(spectrum_data_decoding_);
+      spectrum_decoding_ = std::async(std::launch::async, [this]() { return decodeSpectra_(spectrum_data_decoding_); });
+    }
+
+    void MzMLHandler::finishSpectraDecoding_()
+    {
+      if (!spectrum_decoding_.valid())
+      {
+        return;
+      }
+      reportWarnings_(spectrum_decoding_.get()); // re-throws errors which occurred during decoding
+      appendSpectra_(spectrum_data_decoding_);
+    }
+
+    void MzMLHandler::waitForDecoding()
+    {
+      // always wait for both batches (they access the handler), then re-throw the first error
+      std::exception_ptr error;
+      if (spectrum_decoding_.valid())
+      {
+        try
+        {
+          reportWarnings_(spectrum_decoding_.get());
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+        }
+        spectrum_data_decoding_.clear();
+      }
+      if (chromatogram_decoding_.valid())
+      {
+        try
+        {
+          reportWarnings_(chromatogram_decoding_.get());
+        }
+        catch (...)
+        {
+          if (!error)
+          {
+            error = std::current_exception();
+          }
+        }
+        chromatogram_data_decoding_.clear();
+      }
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    void MzMLHandler::reportWarnings_(const std::vector<String>& warnings) const
+    {
+      for (const String& w : warnings)
+      {
+        warning(LOAD, w);
+      }
+    }
+
+    std::vector<String> MzMLHandler::decodeSpectra_(std::vector<SpectrumData>& spectrum_data) const
+    {
+      // warnings of each spectrum (the handler must not be modified here, it is used by the parser concurrently)
+      std::vector<std::vector<String> > warnings(spectrum_data.size());
 
       // Whether spectrum should be populated with data
       if (options_.getFillData())
@@ -144,20 +240,21 @@ namespace OpenMS::Internal
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)spectrum_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)spectrum_data.size(); i++)
         {
           // parallel exception catching and re-throwing business
           if (!errCount) // no need to parse further if already an error was encountered
           {
             try
             {
-              populateSpectraWithData_(spectrum_data_[i].data,
-                                       spectrum_data_[i].default_array_length,
+              populateSpectraWithData_(spectrum_data[i].data,
+                                       spectrum_data[i].default_array_length,
                                        options_,
-                                       spectrum_data_[i].spectrum);
-              if (options_.getSortSpectraByMZ() && !spectrum_data_[i].spectrum.isSorted())
+                                       spectrum_data[i].spectrum,
+                                       warnings[i]);
+              if (options_.getSortSpectraByMZ() && !spectrum_data[i].spectrum.isSorted())
               {
-                spectrum_data_[i].spectrum.sortByPosition();
+                spectrum_data[i].spectrum.sortByPosition();
               }
             }
 
@@ -184,29 +281,77 @@ namespace OpenMS::Internal
         }
       }
 
+      std::vector<String> all_warnings;
+      for (const std::vector<String>& w : warnings)
+      {
+        all_warnings.insert(all_warnings.end(), w.begin(), w.end());
+      }
+      return all_warnings;
+    }
+
+    void MzMLHandler::appendSpectra_(std::vector<SpectrumData>& spectrum_data)
+    {
       // Append all spectra to experiment / consumer
-      for (Size i = 0; i < spectrum_data_.size(); i++)
+      for (Size i = 0; i < spectrum_data.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeSpectrum(spectrum_data_[i].spectrum);
+          consumer_->consumeSpectrum(spectrum_data[i].spectrum);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+            exp_->addSpectrum(std::move(spectrum_data[i].spectrum));
           }
         }
         else
         {
-          exp_->addSpectrum(std::move(spectrum_data_[i].spectrum));
+          exp_->addSpectrum(std::move(spectrum_data[i].spectrum));
         }
       }
 
       // Delete batch
-      spectrum_data_.clear();
+      spectrum_data.clear();
     }
 
     void MzMLHandler::populateChromatogramsWithData_()
     {
+      // finish the batch decoded in the background (if any) first to keep the order
+      finishChromatogramsDecoding_();
+      reportWarnings_(decodeChromatograms_(chromatogram_data_));
+      appendChromatograms_(chromatogram_data_);
+    }
+
+    void MzMLHandler::populateChromatogramsWithDataAsync_()
+    {
+#ifdef _OPENMP
+      // when loading several files in parallel, a background thread with its
+      // own thread team would oversubscribe the machine: decode synchronously
+      if (omp_in_parallel())
+      {
+        populateChromatogramsWithData_();
+        return;
+      }
+#endif
+      finishChromatogramsDecoding_();
+      // decode the full batch in the background while the parser fills the next one
+      chromatogram_data_.swap(chromatogram_data_decoding_);
+      chromatogram_decoding_ = std::async(std::launch::async, [this]() { return decodeChromatograms_(chromatogram_data_decoding_); });
+    }
+
+    void MzMLHandler::finishChromatogramsDecoding_()
+    {
+      if (!chromatogram_decoding_.valid())
+      {
+        return;
+      }
+      reportWarnings_(chromatogram_decoding_.get()); // re-throws errors which occurred during decoding
+      appendChromatograms_(chromatogram_data_decoding_);
+    }
+
+    std::vector<String> MzMLHandler::decodeChromatograms_(std::vector<ChromatogramData>& chromatogram_data) const
+    {
+      // warnings of each chromatogram (the handler must not be modified here, it is used by the parser concurrently)
+      std::vector<std::vector<String> > warnings(chromatogram_data.size());
+
       // Whether chromatogram should be populated with data
       if (options_.getFillData())
       {
@@ -215,18 +360,19 @@ namespace OpenMS::Internal
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-        for (SignedSize i = 0; i < (SignedSize)chromatogram_data_.size(); i++)
+        for (SignedSize i = 0; i < (SignedSize)chromatogram_data.size(); i++)
         {
           // parallel exception catching and re-throwing business
           try
           {
-            populateChromatogramsWithData_(chromatogram_data_[i].data,
-                                           chromatogram_data_[i].default_array_length,
+            populateChromatogramsWithData_(chromatogram_data[i].data,
+                                           chromatogram_data[i].default_array_length,
                                            options_,
-                                           chromatogram_data_[i].chromatogram);
-            if (options_.getSortChromatogramsByRT() && !chromatogram_data_[i].chromatogram.isSorted())
+                                           chromatogram_data[i].chromatogram,
+                                           warnings[i]);
+            if (options_.getSortChromatogramsByRT() && !chromatogram_data[i].chromatogram.isSorted())
             {
-              chromatogram_data_[i].chromatogram.sortByPosition();
+              chromatogram_data[i].chromatogram.sortByPosition();
             }
           }
           catch (OpenMS::Exception::BaseException& e)
@@ -253,25 +399,35 @@ namespace OpenMS::Internal
 
       }
 
+      std::vector<String> all_warnings;
+      for (const std::vector<String>& w : warnings)
+      {
+        all_warnings.insert(all_warnings.end(), w.begin(), w.end());
+      }
+      return all_warnings;
+    }
+
+    void MzMLHandler::appendChromatograms_(std::vector<ChromatogramData>& chromatogram_data)
+    {
       // Append all chromatograms to experiment / consumer
-      for (Size i = 0; i < chromatogram_data_.size(); i++)
+      for (Size i = 0; i < chromatogram_data.size(); i++)
       {
         if (consumer_ != nullptr)
         {
-          consumer_->consumeChromatogram(chromatogram_data_[i].chromatogram);
+          consumer_->consumeChromatogram(chromatogram_data[i].chromatogram);
           if (options_.getAlwaysAppendData())
           {
-            exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+            exp_->addChromatogram(std::move(chromatogram_data[i].chromatogram));
           }
         }
         else
         {
-          exp_->addChromatogram(std::move(chromatogram_data_[i].chromatogram));
+          exp_->addChromatogram(std::move(chromatogram_data[i].chromatogram));
         }
       }
 
       // Delete batch
-      chromatogram_data_.clear();
+      chromatogram_data.clear();
     }
 
     void MzMLHandler::addSpectrumMetaData_(const std::vector<MzMLHandlerHelper::BinaryData>& input_data,
@@ -321,7 +477,8 @@ namespace OpenMS::Internal
     void MzMLHandler::populateSpectraWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                                Size& default_arr_length,
                                                const PeakFileOptions& peak_file_options,
-                                               SpectrumType& spectrum)
+                                               SpectrumType& spectrum,
+                                               std::vector<String>& warnings) const
     {
       typedef SpectrumType::PeakType PeakType;
 
@@ -342,7 +499,7 @@ namespace OpenMS::Internal
         //if defaultArrayLength > 0 : warn that no m/z or int arrays is present
         if (default_arr_length != 0)
         {
-          warning(LOAD, String("The m/z or intensity array of spectrum '") + spectrum.getNativeID() + "' is missing and default_arr_length is " + default_arr_length + ".");
+          warnings.push_back(String("The m/z or intensity array of spectrum '") + spectrum.getNativeID() + "' is missing and default_arr_length is " + default_arr_length + ".");
         }
         return;
       }
@@ -350,11 +507,11 @@ namespace OpenMS::Internal
       // Error if intensity or m/z is encoded as int32|64 - they should be float32|64!
       if ((!input_data[mz_index].ints_32.empty()) || (!input_data[mz_index].ints_64.empty()))
       {
-        fatalError(LOAD, "Encoding m/z array as integer is not allowed!");
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Encoding m/z array as integer is not allowed!");
       }
       if ((!input_data[int_index].ints_32.empty()) || (!input_data[int_index].ints_64.empty()))
       {
-        fatalError(LOAD, "Encoding intensity array as integer is not allowed!");
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Encoding intensity array as integer is not allowed!");
       }
 
       // Warn if the decoded data has a different size than the defaultArrayLength
@@ -363,23 +520,23 @@ namespace OpenMS::Internal
       // Check if int-size and mz-size are equal
       if (mz_size != int_size)
       {
-        fatalError(LOAD, String("The length of m/z and integer values of spectrum '") + spectrum.getNativeID() + "' differ (mz-size: " + mz_size + ", int-size: " + int_size + "! Not reading spectrum!");
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, String("The length of m/z and integer values of spectrum '") + spectrum.getNativeID() + "' differ (mz-size: " + mz_size + ", int-size: " + int_size + "! Not reading spectrum!");
       }
       bool repair_array_length = false;
       if (default_arr_length != mz_size)
       {
-        warning(LOAD, String("The m/z array of spectrum '") + spectrum.getNativeID() + "' has the size " + mz_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
+        warnings.push_back(String("The m/z array of spectrum '") + spectrum.getNativeID() + "' has the size " + mz_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
         repair_array_length = true;
       }
       if (default_arr_length != int_size)
       {
-        warning(LOAD, String("The intensity array of spectrum '") + spectrum.getNativeID() + "' has the size " + int_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
+        warnings.push_back(String("The intensity array of spectrum '") + spectrum.getNativeID() + "' has the size " + int_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
         repair_array_length = true;
       }
       if (repair_array_length)
       {
         default_arr_length = int_size;
-        warning(LOAD, String("Fixing faulty defaultArrayLength to ") + default_arr_length + ".");
+        warnings.push_back(String("Fixing faulty defaultArrayLength to ") + default_arr_length + ".");
       }
 
       //create meta data arrays and reserve enough space for the content
@@ -490,7 +647,8 @@ namespace OpenMS::Internal
     void MzMLHandler::populateChromatogramsWithData_(std::vector<MzMLHandlerHelper::BinaryData>& input_data,
                                                      Size& default_arr_length,
                                                      const PeakFileOptions& peak_file_options,
-                                                     ChromatogramType& inp_chromatogram)
+                                                     ChromatogramType& inp_chromatogram,
+                                                     std::vector<String>& warnings) const
     {
       typedef ChromatogramType::PeakType ChromatogramPeakType;
 
@@ -511,7 +669,7 @@ namespace OpenMS::Internal
         //if defaultArrayLength > 0 : warn that no time or int arrays is present
         if (default_arr_length != 0)
         {
-          warning(LOAD, String("The time or intensity array of chromatogram '") +
+          warnings.push_back(String("The time or intensity array of chromatogram '") +
               inp_chromatogram.getNativeID() + "' is missing and default_arr_length is " + default_arr_length + ".");
         }
         return;
@@ -523,24 +681,24 @@ namespace OpenMS::Internal
       // Check if int-size and rt-size are equal
       if (rt_size != int_size)
       {
-        fatalError(LOAD, String("The length of RT and intensity values of chromatogram '") + inp_chromatogram.getNativeID() + "' differ (rt-size: " + rt_size + ", int-size: " + int_size + "! Not reading chromatogram!");
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, String("The length of RT and intensity values of chromatogram '") + inp_chromatogram.getNativeID() + "' differ (rt-size: " + rt_size + ", int-size: " + int_size + "! Not reading chromatogram!");
       }
       bool repair_array_length = false;
       if (default_arr_length != rt_size)
       {
-        warning(LOAD, String("The base64-decoded rt array of chromatogram '") + inp_chromatogram.getNativeID() + "' has the size " + rt_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
+        warnings.push_back(String("The base64-decoded rt array of chromatogram '") + inp_chromatogram.getNativeID() + "' has the size " + rt_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
         repair_array_length = true;
       }
       if (default_arr_length != int_size)
       {
-        warning(LOAD, String("The base64-decoded intensity array of chromatogram '") + inp_chromatogram.getNativeID() + "' has the size " + int_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
+        warnings.push_back(String("The base64-decoded intensity array of chromatogram '") + inp_chromatogram.getNativeID() + "' has the size " + int_size + ", but it should have size " + default_arr_length + " (defaultArrayLength).");
         repair_array_length = true;
       }
       // repair size of array, accessing memory that is beyond int_size will lead to segfaults later
       if (repair_array_length)
       {
         default_arr_length = int_size; // set to length of actual data (int_size and rt_size are equal, s.a.)
-        warning(LOAD, String("Fixing faulty defaultArrayLength to ") + default_arr_length + ".");
+        warnings.push_back(String("Fixing faulty defaultArrayLength to ") + default_arr_length + ".");
       }
 
       // Create meta data arrays and reserve enough space for the content
@@ -1264,7 +1422,7 @@ namespace OpenMS::Internal
 
           if (spectrum_data_.size() >= options_.getMaxDataPoolSize())
           {
-            populateSpectraWithData_();
+            populateSpectraWithDataAsync_();
           }
         }
 
@@ -1302,7 +1460,7 @@ namespace OpenMS::Internal
 
           if (chromatogram_data_.size() >= options_.getMaxDataPoolSize())
           {
-            populateChromatogramsWithData_();
+            populateChromatogramsWithDataAsync_();
           }
         }
 
@@ -1325,12 +1483,16 @@ namespace OpenMS::Internal
       {
         skip_spectrum_ = false; // no more spectra to come, so stop skipping (for the LD_RAWCOUNTS case)
         in_spectrum_list_ = false;
+        // Flush the remaining spectra (including the batch decoded in the background)
+        populateSpectraWithData_();
         logger_.endProgress();
       }
       else if (equal_(qname, s_chromatogram_list))
       {
         skip_chromatogram_ = false; // no more chromatograms to come, so stop skipping
         in_spectrum_list_ = false;
+        // Flush the remaining chromatograms (including the batch decoded in the background)
+        populateChromatogramsWithData_();
         logger_.endProgress();
       }
       else if (equal_(qname, s_sourceFileList ))
@@ -52,7 +52,11 @@
 #include <omp.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <exception>
+#include <memory>
+#include <unordered_map>
 
 namespace OpenMS::Internal
 {
@@ -78,6 +82,136 @@ namespace OpenMS::Internal
       return tmp;
     }
 
+    /*
+     * @brief A prepared statement which is executed many times with different bound values
+     *
+     * Used when writing sqMass files: a single statement is prepared per
+     * table and executed once per row, which avoids building (and parsing)
+     * large SQL strings. Queries with bound parameters read their result rows
+     * through get().
+     *
+     */
+    class ReusableStatement
+    {
+    public:
+      ReusableStatement(sqlite3* db, const String& prepare_statement) :
+        db_(db)
+      {
+        SqliteConnector::prepareStatement(db_, &stmt_, prepare_statement);
+      }
+
+      ~ReusableStatement()
+      {
+        sqlite3_finalize(stmt_);
+      }
+
+      ReusableStatement(const ReusableStatement&) = delete;
+      ReusableStatement& operator=(const ReusableStatement&) = delete;
+
+      void bind(int pos, int value)
+      {
+        check_(sqlite3_bind_int(stmt_, pos, value));
+      }
+
+      void bind(int pos, Int64 value)
+      {
+        check_(sqlite3_bind_int64(stmt_, pos, value));
+      }
+
+      void bind(int pos, double value)
+      {
+        check_(sqlite3_bind_double(stmt_, pos, value));
+      }
+
+      /// binds text (the value must stay valid until step() is called)
+      void bindText(int pos, const std::string& value)
+      {
+        check_(sqlite3_bind_text(stmt_, pos, value.c_str(), (int)value.size(), SQLITE_STATIC));
+      }
+
+      /// binds a blob (the value must stay valid until step() is called)
+      void bindBlob(int pos, const std::string& value)
+      {
+        check_(sqlite3_bind_blob(stmt_, pos, value.c_str(), (int)value.size(), SQLITE_STATIC));
+      }
+
+      void bindNull(int pos)
+      {
+        check_(sqlite3_bind_null(stmt_, pos));
+      }
+
+      /// The underlying statement (e.g. to step through the rows of a query)
+      sqlite3_stmt* get() const
+      {
+        return stmt_;
+      }
+
+      /// Executes the statement with the currently bound values and resets it for the next row
+      void step()
+      {
+        int rc = sqlite3_step(stmt_);
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+        if (rc != SQLITE_DONE)
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sqlite3_errmsg(db_));
+        }
+      }
+
+    private:
+      void check_(int rc) const
+      {
+        if (rc != SQLITE_OK)
+        {
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, sqlite3_errmsg(db_));
+        }
+      }
+
+      sqlite3* db_;
+      sqlite3_stmt* stmt_ = nullptr;
+    };
+
+    /*
+     * @brief Sets up a connection for writing
+     *
+     * If durability is not required, SQLite does not wait for the data to
+     * reach the disk and keeps its rollback journal in memory. A crash (of
+     * the program or the OS) while writing may then leave a corrupt file.
+     *
+     */
+    void prepareWriteConnection(SqliteConnector& conn, bool durable_write)
+    {
+      if (!durable_write)
+      {
+        conn.executeStatement("PRAGMA synchronous = OFF; PRAGMA journal_mode = MEMORY;");
+      }
+    }
+
+    /*
+     * @brief Encodes a data array for storage in the DATA table
+     *
+     * Uses numpress (with @p config) + zlib if @p lossy is true, otherwise
+     * zlib on the raw doubles (compression 5/6 or 1, respectively).
+     *
+     */
+    void encodeDataArray(const std::vector<double>& data,
+                         bool lossy,
+                         const MSNumpressCoder::NumpressConfig& config,
+                         String& encoded_string)
+    {
+      if (lossy)
+      {
+        String uncompressed_str;
+        MSNumpressCoder().encodeNPRaw(data, uncompressed_str, config);
+        OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
+      }
+      else
+      {
+        std::string str_data((const char*) data.data(), data.size() * sizeof(double));
+        OpenMS::ZlibCompression::compressString(str_data, encoded_string);
+      }
+    }
+
     /*
      *
      * This function populates a set of empty data containers (MSSpectrum or
@@ -91,41 +225,46 @@ namespace OpenMS::Internal
      * data_type (int)
      * binary_Data (blob)
      *
+     * Only the containers [begin, end) are filled, sql_ids holds the SQL id of
+     * each container (the rows may come in any order).
+     *
      * It is designed to work with containers of type MSSpectrum and
      * MSChromatogram to provide a single function for both use-cases.
      *
      */
     template<class ContainerT>
-    void populateContainer_sub_(sqlite3_stmt *stmt, std::vector<ContainerT>& containers)
+    void populateContainer_sub_(sqlite3_stmt *stmt,
+                                std::vector<ContainerT>& containers,
+                                const std::vector<int>& sql_ids,
+                                Size begin,
+                                Size end)
     {
       // perform first step
       sqlite3_step(stmt);
 
-      std::vector<int> cont_data;
-      cont_data.resize(containers.size());
-      std::map<Size,Size> sql_container_map;
+      std::vector<int> cont_data(end - begin, 0);
+      // map the sql table id to the index in the "containers" vector
+      std::unordered_map<Int64, Size> sql_container_map;
+      sql_container_map.reserve(end - begin);
+      for (Size k = begin; k < end; ++k)
+      {
+        sql_container_map.emplace(sql_ids[k], k);
+      }
       std::vector<double> data;
       String stemp;
       while (sqlite3_column_type( stmt, 0 ) != SQLITE_NULL)
       {
-        Size id_orig = sqlite3_column_int( stmt, 0 );
-
-        // map the sql table id to the index in the "containers" vector
-        if (sql_container_map.find(id_orig) == sql_container_map.end())
+        auto container_it = sql_container_map.find(sqlite3_column_int64(stmt, 0));
+        if (container_it == sql_container_map.end())
         {
-          Size tmp = sql_container_map.size();
-          sql_container_map[id_orig] = tmp;
+          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+              "Data for non-existent spectrum / chromatogram found");
         }
-        Size curr_id = sql_container_map[id_orig];
+        Size curr_id = container_it->second;
 
         const unsigned char * native_id_ = sqlite3_column_text(stmt, 1);
         std::string native_id(reinterpret_cast<const char*>(native_id_), sqlite3_column_bytes(stmt, 1));
 
-        if (curr_id >= containers.size())
-        {
-          throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-              "Data for non-existent spectrum / chromatogram found");
-        }
         if (native_id != containers[curr_id].getNativeID())
         {
           throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
@@ -189,7 +328,7 @@ namespace OpenMS::Internal
           {
             it->setIntensity(*data_it);
           }
-          cont_data[curr_id] += 1;
+          cont_data[curr_id - begin] += 1;
         }
         else if (data_type == 0)
         {
@@ -209,7 +348,7 @@ namespace OpenMS::Internal
           {
             it->setMZ(*data_it);
           }
-          cont_data[curr_id] += 1;
+          cont_data[curr_id - begin] += 1;
         }
         else if (data_type == 2)
         {
@@ -225,7 +364,7 @@ namespace OpenMS::Internal
           {
             it->setMZ(*data_it);
           }
-          cont_data[curr_id] += 1;
+          cont_data[curr_id - begin] += 1;
         }
         else
         {
@@ -242,11 +381,131 @@ namespace OpenMS::Internal
         if (cont_data[k] < 2)
         {
           throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-              String("Spectrum/Chromatogram ") + k + " does not have 2 data arrays.");
+              String("Spectrum/Chromatogram ") + (begin + k) + " does not have 2 data arrays.");
+        }
+      }
+    }
+
+    /*
+     *
+     * Fills spectra (table is "SPECTRUM") or chromatograms (table is
+     * "CHROMATOGRAM") with their data, sql_ids holds the SQL id of each
+     * container. If all_rows is true, sql_ids covers the whole table and the
+     * ids do not need to be sent to the database.
+     *
+     * Outside of a parallel region, the containers are split into blocks of
+     * consecutive containers which are read and decompressed in parallel. Each
+     * thread uses its own read-only connection since SQLite allows concurrent
+     * readers, but not concurrent use of a single connection.
+     *
+     */
+    template<class ContainerT>
+    void populateContainers_(const String& filename,
+                             sqlite3* db,
+                             const String& table,
+                             std::vector<ContainerT>& containers,
+                             const std::vector<int>& sql_ids,
+                             bool all_rows)
+    {
+      // fewer containers are not worth a separate query
+      const Size min_containers_per_block = 50;
+
+      const String select_sql = "SELECT " +
+                                table + ".ID," +
+                                table + ".NATIVE_ID," \
+                                "DATA.COMPRESSION," \
+                                "DATA.DATA_TYPE," \
+                                "DATA.DATA " \
+                                "FROM " + table + " " \
+                                "INNER JOIN DATA ON " + table + ".ID = DATA." + table + "_ID";
+
+      auto populate_block = [&](sqlite3* block_db, Size begin, Size end, bool restrict_ids)
+      {
+        String block_sql = select_sql;
+        if (restrict_ids)
+        {
+          std::vector<int> block_ids(sql_ids.begin() + begin, sql_ids.begin() + end);
+          block_sql += " WHERE " + table + ".ID IN (" + integerConcatenateHelper(block_ids) + ")";
+        }
+        block_sql += ";";
+
+        sqlite3_stmt* stmt;
+        SqliteConnector::prepareStatement(block_db, &stmt, block_sql);
+        try
+        {
+          populateContainer_sub_<ContainerT>(stmt, containers, sql_ids, begin, end);
+        }
+        catch (...)
+        {
+          // an unfinalized statement would keep the connection from closing
+          sqlite3_finalize(stmt);
+          throw;
+        }
+        sqlite3_finalize(stmt);
+      };
+
+      Size nr_blocks = 1;
+#ifdef _OPENMP
+      if (!omp_in_parallel() && omp_get_max_threads() > 1)
+      {
+        // a few blocks per thread to balance the load
+        nr_blocks = std::min(Size(omp_get_max_threads()) * 4, containers.size() / min_containers_per_block);
+      }
+#endif
+      if (nr_blocks <= 1)
+      {
+        if (!containers.empty())
+        {
+          populate_block(db, 0, containers.size(), !all_rows);
+        }
+        return;
+      }
+
+      std::vector<std::exception_ptr> errors(nr_blocks);
+#pragma omp parallel
+      {
+        std::unique_ptr<SqliteConnector> conn; // opened on first use, one per thread
+#pragma omp for schedule(dynamic)
+        for (SignedSize b = 0; b < (SignedSize)nr_blocks; ++b)
+        {
+          try
+          {
+            if (!conn)
+            {
+              conn = std::make_unique<SqliteConnector>(filename, SqliteConnector::SqlOpenMode::READONLY);
+            }
+            populate_block(conn->getDB(), containers.size() * b / nr_blocks, containers.size() * (b + 1) / nr_blocks, true);
+          }
+          catch (...)
+          {
+            errors[b] = std::current_exception();
+          }
+        }
+      }
+      for (const auto& error : errors)
+      {
+        if (error)
+        {
+          std::rethrow_exception(error);
         }
       }
     }
 
+    /// Returns the ids of all rows of @p table in ascending order
+    std::vector<int> selectAllIds(sqlite3* db, const String& table)
+    {
+      sqlite3_stmt* stmt;
+      SqliteConnector::prepareStatement(db, &stmt, "SELECT ID FROM " + table + " ORDER BY ID;");
+      std::vector<int> ids;
+      Sql::SqlState state = Sql::SqlState::SQL_ROW;
+      while ((state = Sql::nextRow(stmt, state)) == Sql::SqlState::SQL_ROW)
+      {
+        ids.push_back(sqlite3_column_int(stmt, 0));
+      }
+      sqlite3_finalize(stmt);
+      return ids;
+    }
+
     // the cost for initialization and copy should be minimal
     //  - a single C string is created
     //  - two ints
@@ -257,7 +516,9 @@ namespace OpenMS::Internal
       run_id_(Internal::SqliteHelper::clearSignBit(run_id)),
       use_lossy_compression_(true),
       linear_abs_mass_acc_(0.0001), // set the desired mass accuracy = 1ppm at 100 m/z
-      write_full_meta_(true)
+      write_full_meta_(true),
+      sql_batch_size_(500),
+      durable_write_(true)
     {
     }
 
@@ -342,8 +603,17 @@ namespace OpenMS::Internal
         return;
       }
 
-      populateChromatogramsWithData_(db, exp.getChromatograms());
-      populateSpectraWithData_(db, exp.getSpectra());
+      // spectra and chromatograms are stored (and read) in the order of their ids
+      std::vector<int> chrom_ids = selectAllIds(db, "CHROMATOGRAM");
+      std::vector<int> spec_ids = selectAllIds(db, "SPECTRUM");
+      if (chrom_ids.size() != exp.getNrChromatograms() || spec_ids.size() != exp.getNrSpectra())
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+            String("Meta data describes ") + exp.getNrSpectra() + " spectra and " + exp.getNrChromatograms() +
+            " chromatograms, but file contains " + spec_ids.size() + " spectra and " + chrom_ids.size() + " chromatograms");
+      }
+      populateChromatogramsWithData_(db, exp.getChromatograms(), chrom_ids, true);
+      populateSpectraWithData_(db, exp.getSpectra(), spec_ids, true);
     }
 
     UInt64 MzMLSqliteHandler::getRunID() const
@@ -392,7 +662,10 @@ namespace OpenMS::Internal
         return;
       }
 
-      populateSpectraWithData_(conn.getDB(), exp, indices);
+      // the spectra are ordered by their id
+      std::vector<int> sql_ids(indices);
+      std::sort(sql_ids.begin(), sql_ids.end());
+      populateSpectraWithData_(conn.getDB(), exp, sql_ids);
     }
 
     void MzMLSqliteHandler::readChromatograms(std::vector<MSChromatogram> & exp,
@@ -417,7 +690,10 @@ namespace OpenMS::Internal
         return;
       }
 
-      populateChromatogramsWithData_(conn.getDB(), exp, indices);
+      // the chromatograms are ordered by their id
+      std::vector<int> sql_ids(indices);
+      std::sort(sql_ids.begin(), sql_ids.end());
+      populateChromatogramsWithData_(conn.getDB(), exp, sql_ids);
     }
 
     Size MzMLSqliteHandler::getNrSpectra() const
@@ -479,6 +755,68 @@ namespace OpenMS::Internal
       return result;
     }
 
+    std::vector<int> MzMLSqliteHandler::getSpectraIndicesByRange(double rt_start,
+                                                                 double rt_end,
+                                                                 int ms_level,
+                                                                 double precursor_mz_start,
+                                                                 double precursor_mz_end) const
+    {
+      SqliteConnector conn(filename_, SqliteConnector::SqlOpenMode::READONLY);
+
+      const bool use_rt = rt_end >= rt_start;
+      const bool use_precursor = precursor_mz_end >= precursor_mz_start;
+
+      // all predicates are on indexed columns, the values are bound below
+      String select_sql = "SELECT DISTINCT SPECTRUM.ID FROM SPECTRUM ";
+      if (use_precursor)
+      {
+        select_sql += "INNER JOIN PRECURSOR ON SPECTRUM.ID = PRECURSOR.SPECTRUM_ID ";
+      }
+      String where;
+      auto add_predicate = [&where](const String& predicate)
+      {
+        where += (where.empty() ? "WHERE " : " AND ") + predicate;
+      };
+      if (use_rt)
+      {
+        add_predicate("SPECTRUM.RETENTION_TIME BETWEEN ? AND ?");
+      }
+      if (ms_level > 0)
+      {
+        add_predicate("SPECTRUM.MSLEVEL = ?");
+      }
+      if (use_precursor)
+      {
+        add_predicate("PRECURSOR.ISOLATION_TARGET BETWEEN ? AND ?");
+      }
+      select_sql += where + " ORDER BY SPECTRUM.ID;";
+
+      ReusableStatement query(conn.getDB(), select_sql);
+      int pos = 1;
+      if (use_rt)
+      {
+        query.bind(pos++, rt_start);
+        query.bind(pos++, rt_end);
+      }
+      if (ms_level > 0)
+      {
+        query.bind(pos++, ms_level);
+      }
+      if (use_precursor)
+      {
+        query.bind(pos++, precursor_mz_start);
+        query.bind(pos++, precursor_mz_end);
+      }
+
+      std::vector<int> result;
+      Sql::SqlState state = Sql::SqlState::SQL_ROW;
+      while ((state = Sql::nextRow(query.get(), state)) == Sql::SqlState::SQL_ROW)
+      {
+        result.push_back(sqlite3_column_int(query.get(), 0));
+      }
+      return result;
+    }
+
     Size MzMLSqliteHandler::getNrChromatograms() const
     {
       SqliteConnector conn(filename_);
@@ -493,95 +831,22 @@ namespace OpenMS::Internal
       return (Size)ret;
     }
 
-    void MzMLSqliteHandler::populateChromatogramsWithData_(sqlite3* db, std::vector<MSChromatogram>& chromatograms) const
-    {
-      std::string select_sql;
-      select_sql = "SELECT " \
-                    "CHROMATOGRAM.ID as chrom_id," \
-                    "CHROMATOGRAM.NATIVE_ID as chrom_native_id," \
-                    "DATA.COMPRESSION as data_compression," \
-                    "DATA.DATA_TYPE as data_type," \
-                    "DATA.DATA as binary_data " \
-                    "FROM CHROMATOGRAM " \
-                    "INNER JOIN DATA ON CHROMATOGRAM.ID = DATA.CHROMATOGRAM_ID " \
-                    ";";
-
-
-      // Execute SQL statement
-      sqlite3_stmt* stmt;
-      SqliteConnector::prepareStatement(db, &stmt, select_sql);
-      populateContainer_sub_<MSChromatogram>(stmt, chromatograms);
-      sqlite3_finalize(stmt);
-    }
-
     void MzMLSqliteHandler::populateChromatogramsWithData_(sqlite3* db,
                                                            std::vector<MSChromatogram>& chromatograms,
-                                                           const std::vector<int>& indices) const
-    {
-      OPENMS_PRECONDITION(!indices.empty(), "Need to select at least one index.")
-      OPENMS_PRECONDITION(indices.size() == chromatograms.size(), "Chromatograms and indices need to have the same length.")
-
-      String select_sql = "SELECT " \
-                          "CHROMATOGRAM.ID as chrom_id," \
-                          "CHROMATOGRAM.NATIVE_ID as chrom_native_id," \
-                          "DATA.COMPRESSION as data_compression," \
-                          "DATA.DATA_TYPE as data_type," \
-                          "DATA.DATA as binary_data " \
-                          "FROM CHROMATOGRAM " \
-                          "INNER JOIN DATA ON CHROMATOGRAM.ID = DATA.CHROMATOGRAM_ID " \
-                          "WHERE CHROMATOGRAM.ID IN (";
-      select_sql += integerConcatenateHelper(indices) + ");";
-
-      // Execute SQL statement
-      sqlite3_stmt* stmt;
-      SqliteConnector::prepareStatement(db, &stmt, select_sql);
-      populateContainer_sub_<MSChromatogram>(stmt, chromatograms);
-      sqlite3_finalize(stmt);
-    }
-
-    void MzMLSqliteHandler::populateSpectraWithData_(sqlite3* db, std::vector<MSSpectrum>& spectra) const
+                                                           const std::vector<int>& sql_ids,
+                                                           bool all_rows) const
     {
-      std::string select_sql;
-      select_sql = "SELECT " \
-                    "SPECTRUM.ID as spec_id," \
-                    "SPECTRUM.NATIVE_ID as spec_native_id," \
-                    "DATA.COMPRESSION as data_compression," \
-                    "DATA.DATA_TYPE as data_type," \
-                    "DATA.DATA as binary_data " \
-                    "FROM SPECTRUM " \
-                    "INNER JOIN DATA ON SPECTRUM.ID = DATA.SPECTRUM_ID " \
-                    ";";
-
-      // Execute SQL statement
-      sqlite3_stmt* stmt;
-      SqliteConnector::prepareStatement(db, &stmt, select_sql);
-      populateContainer_sub_<MSSpectrum>(stmt, spectra);
-      sqlite3_finalize(stmt);
+      OPENMS_PRECONDITION(sql_ids.size() == chromatograms.size(), "Chromatograms and indices need to have the same length.")
+      populateContainers_<MSChromatogram>(filename_, db, "CHROMATOGRAM", chromatograms, sql_ids, all_rows);
     }
 
     void MzMLSqliteHandler::populateSpectraWithData_(sqlite3* db,
                                                      std::vector<MSSpectrum>& spectra,
-                                                     const std::vector<int>& indices) const
+                                                     const std::vector<int>& sql_ids,
+                                                     bool all_rows) const
     {
-      OPENMS_PRECONDITION(!indices.empty(), "Need to select at least one index.")
-      OPENMS_PRECONDITION(indices.size() == spectra.size(), "Spectra and indices need to have the same length.")
-
-      String select_sql = "SELECT " \
-                          "SPECTRUM.ID as spec_id," \
-                          "SPECTRUM.NATIVE_ID as spec_native_id," \
-                          "DATA.COMPRESSION as data_compression," \
-                          "DATA.DATA_TYPE as data_type," \
-                          "DATA.DATA as binary_data " \
-                          "FROM SPECTRUM " \
-                          "INNER JOIN DATA ON SPECTRUM.ID = DATA.SPECTRUM_ID " \
-                          "WHERE SPECTRUM.ID IN (";
-      select_sql += integerConcatenateHelper(indices) + ");";
-
-      // Execute SQL statement
-      sqlite3_stmt* stmt;
-      SqliteConnector::prepareStatement(db, &stmt, select_sql);
-      populateContainer_sub_<MSSpectrum>(stmt, spectra);
-      sqlite3_finalize(stmt);
+      OPENMS_PRECONDITION(sql_ids.size() == spectra.size(), "Spectra and indices need to have the same length.")
+      populateContainers_<MSSpectrum>(filename_, db, "SPECTRUM", spectra, sql_ids, all_rows);
     }
 
     void MzMLSqliteHandler::prepareChroms_(sqlite3* db,
@@ -610,9 +875,9 @@ namespace OpenMS::Internal
 
       if (!indices.empty())
       {
-        select_sql += String("WHERE CHROMATOGRAM.ID IN (") + integerConcatenateHelper(indices) + ")";
+        select_sql += String("WHERE CHROMATOGRAM.ID IN (") + integerConcatenateHelper(indices) + ") ";
       }
-      select_sql += ";";
+      select_sql += "ORDER BY CHROMATOGRAM.ID;";
 
       // See https://www.sqlite.org/c3ref/column_blob.html
       // The pointers returned are valid until a type conversion occurs as
@@ -715,9 +980,9 @@ namespace OpenMS::Internal
 
       if (!indices.empty())
       {
-        select_sql += String("WHERE SPECTRUM.ID IN (") + integerConcatenateHelper(indices) + ")";
+        select_sql += String("WHERE SPECTRUM.ID IN (") + integerConcatenateHelper(indices) + ") ";
       }
-      select_sql += ";";
+      select_sql += "ORDER BY SPECTRUM.ID;";
 
       // See https://www.sqlite.org/c3ref/column_blob.html
       // The pointers returned are valid until a type conversion occurs as
@@ -834,6 +1099,7 @@ namespace OpenMS::Internal
     void MzMLSqliteHandler::writeRunLevelInformation(const MSExperiment& exp, bool write_full_meta)
     {
       SqliteConnector conn(filename_);
+      prepareWriteConnection(conn, durable_write_);
 
       // prepare streams and set required precision (default is 6 digits)
       std::stringstream insert_run_sql;
@@ -979,11 +1245,12 @@ namespace OpenMS::Internal
 
         "CREATE INDEX chrom_run_idx ON CHROMATOGRAM(RUN_ID);" \
 
-        "CREATE INDEX product_chr_idx ON DATA(CHROMATOGRAM_ID);" \
-        "CREATE INDEX product_sp_idx ON DATA(SPECTRUM_ID);" \
+        "CREATE INDEX product_chr_idx ON PRODUCT(CHROMATOGRAM_ID);" \
+        "CREATE INDEX product_sp_idx ON PRODUCT(SPECTRUM_ID);" \
 
-        "CREATE INDEX precursor_chr_idx ON DATA(CHROMATOGRAM_ID);" \
-        "CREATE INDEX precursor_sp_idx ON DATA(SPECTRUM_ID);";
+        "CREATE INDEX precursor_chr_idx ON PRECURSOR(CHROMATOGRAM_ID);" \
+        "CREATE INDEX precursor_sp_idx ON PRECURSOR(SPECTRUM_ID);" \
+        "CREATE INDEX precursor_target_idx ON PRECURSOR(ISOLATION_TARGET);";
 
       // Execute SQL statement
       SqliteConnector conn(filename_);
@@ -998,15 +1265,7 @@ namespace OpenMS::Internal
         return;
       }
       SqliteConnector conn(filename_);
-
-      // prepare streams and set required precision (default is 6 digits)
-      std::stringstream insert_spectra_sql;
-      std::stringstream insert_precursor_sql;
-      std::stringstream insert_product_sql;
-
-      insert_spectra_sql.precision(11);
-      insert_precursor_sql.precision(11);
-      insert_product_sql.precision(11);
+      prepareWriteConnection(conn, durable_write_);
 
       // Encoding options
       MSNumpressCoder::NumpressConfig npconfig_mz;
@@ -1019,204 +1278,144 @@ namespace OpenMS::Internal
       npconfig_int.numpressErrorTolerance = -1.0; // skip check, faster
       npconfig_int.setCompression("slof");
 
-      String prepare_statement = "INSERT INTO DATA (SPECTRUM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
-      std::vector<String> data;
-      int sql_it = 1;
-
-      std::vector<String> encoded_strings_mz(spectra.size());
-      std::vector<String> encoded_strings_int(spectra.size());
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-      for (SignedSize k = 0; k < (SignedSize)spectra.size(); k++)
-      {
-        const MSSpectrum& spec = spectra[k];
-
-        // encode mz data (zlib or np-linear + zlib)
-        {
-          std::vector<double> data_to_encode;
-          data_to_encode.resize(spec.size());
-          for (Size p = 0; p < spec.size(); ++p)
-          {
-            data_to_encode[p] = spec[p].getMZ();
-          }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_mz);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_mz[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_mz[k] = encoded_string;
-          }
-        }
-
-        // encode intensity data (zlib or np-slof + zlib)
-        {
-          std::vector<double> data_to_encode;
-          data_to_encode.resize(spec.size());
-          for (Size p = 0; p < spec.size(); ++p)
-          {
-            data_to_encode[p] = spec[p].getIntensity();
-          }
+      //  data_type is one of 0 = mz, 1 = int, 2 = rt
+      //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+      const int compression_mz = use_lossy_compression_ ? 5 : 1;
+      const int compression_int = use_lossy_compression_ ? 6 : 1;
 
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_int);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-        }
-      }
-
-      int nr_precursors = 0;
-      int nr_products = 0;
-      for (Size k = 0; k < spectra.size(); k++)
+      // all spectra are written in a single transaction
+      conn.executeStatement("BEGIN TRANSACTION");
       {
-        const MSSpectrum& spec = spectra[k];
-        int polarity = (spec.getInstrumentSettings().getPolarity() == IonSource::POSITIVE); // 1 = positive
-        insert_spectra_sql << "INSERT INTO SPECTRUM(ID, RUN_ID, NATIVE_ID, MSLEVEL, RETENTION_TIME, SCAN_POLARITY) VALUES (" <<
-          spec_id_ << "," <<
-          run_id_ << ",'" <<
-          spec.getNativeID() << "'," <<
-          spec.getMSLevel() << "," <<
-          spec.getRT() << "," <<
-          polarity << "); ";
-
-        if (!spec.getPrecursors().empty())
-        {
-          if (spec.getPrecursors().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than first precursor" << std::endl;
-          }
-          if (spec.getPrecursors()[0].getActivationMethods().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than one activation method" << std::endl;
-          }
-
-          OpenMS::Precursor prec = spec.getPrecursors()[0];
-          // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
-          int activation_method = -1;
-          if (!prec.getActivationMethods().empty() )
-          {
-            activation_method = *prec.getActivationMethods().begin();
-          }
-          String pepseq;
-          if (prec.metaValueExists("peptide_sequence"))
-          {
-            pepseq = prec.getMetaValue("peptide_sequence");
-            insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " <<
-                "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " <<
-                "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
-              spec_id_ << "," << prec.getCharge() << "," << prec.getMZ() <<
-              "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-              "," << prec.getDriftTime() << 
-              "," << prec.getActivationEnergy() << 
-              "," << activation_method << ",'" << pepseq << "'" << "); ";
-          }
-          else
-          {
-            insert_precursor_sql << "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
-              "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" <<
-              spec_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-              "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() << 
-              "," << prec.getDriftTime() <<
-              "," << prec.getActivationEnergy() <<
-              "," << activation_method << "); ";
-          }
-          nr_precursors++;
-        }
-
-        if (!spec.getProducts().empty())
+        ReusableStatement insert_data(conn.getDB(), "INSERT INTO DATA (SPECTRUM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES (?1, ?2, ?3, ?4);");
+        ReusableStatement insert_spectrum(conn.getDB(), "INSERT INTO SPECTRUM (ID, RUN_ID, NATIVE_ID, MSLEVEL, RETENTION_TIME, SCAN_POLARITY) VALUES (?1, ?2, ?3, ?4, ?5, ?6);");
+        ReusableStatement insert_precursor(conn.getDB(), "INSERT INTO PRECURSOR (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " \
+                                                         "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " \
+                                                         "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9);");
+        ReusableStatement insert_product(conn.getDB(), "INSERT INTO PRODUCT (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " \
+                                                       "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (?1, ?2, ?3, ?4, ?5);");
+
+        // Spectra are encoded in parallel in batches of sql_batch_size_ and
+        // then inserted in order (this bounds the memory for encoded data)
+        const Size batch_size = std::max(sql_batch_size_, 1);
+        std::vector<String> encoded_strings_mz;
+        std::vector<String> encoded_strings_int;
+        for (Size batch_start = 0; batch_start < spectra.size(); batch_start += batch_size)
         {
-          if (spec.getProducts().size() > 1)
-          {
-            std::cout << "WARNING cannot store more than first product" << std::endl;
-          }
-          OpenMS::Product prod = spec.getProducts()[0];
-          insert_product_sql << "INSERT INTO PRODUCT (SPECTRUM_ID, CHARGE, ISOLATION_TARGET, " << 
-            "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
-            spec_id_ << "," << 0 << "," << prod.getMZ() << 
-            "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
-          nr_products++;
-        }
-
-        //  data_type is one of 0 = mz, 1 = int, 2 = rt
-        //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
-
-        // encode mz data (zlib or np-linear + zlib)
-        {
-          data.push_back(encoded_strings_mz[k]);
-          if (use_lossy_compression_)
-          {
-            prepare_statement += String("(") + spec_id_ + ", 0, 5, ?" + sql_it++ + " ),";
-          }
-          else
-          {
-            prepare_statement += String("(") + spec_id_ + ", 0, 1, ?" + sql_it++ + " ),";
-          }
-        }
-
-        // encode intensity data (zlib or np-slof + zlib)
-        {
-          data.push_back(encoded_strings_int[k]);
-          if (use_lossy_compression_)
-          {
-            prepare_statement += String("(") + spec_id_ + ", 1, 6, ?" + sql_it++ + " ),";
-          }
-          else
+          const Size batch_end = std::min(batch_start + batch_size, spectra.size());
+          encoded_strings_mz.resize(batch_end - batch_start);
+          encoded_strings_int.resize(batch_end - batch_start);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
           {
-            prepare_statement += String("(") + spec_id_ + ", 1, 1, ?" + sql_it++ + " ),";
+            std::vector<double> data_to_encode;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (SignedSize k = batch_start; k < (SignedSize)batch_end; k++)
+            {
+              const MSSpectrum& spec = spectra[k];
+
+              // encode mz data (zlib or np-linear + zlib)
+              data_to_encode.resize(spec.size());
+              for (Size p = 0; p < spec.size(); ++p)
+              {
+                data_to_encode[p] = spec[p].getMZ();
+              }
+              encodeDataArray(data_to_encode, use_lossy_compression_, npconfig_mz, encoded_strings_mz[k - batch_start]);
+
+              // encode intensity data (zlib or np-slof + zlib)
+              for (Size p = 0; p < spec.size(); ++p)
+              {
+                data_to_encode[p] = spec[p].getIntensity();
+              }
+              encodeDataArray(data_to_encode, use_lossy_compression_, npconfig_int, encoded_strings_int[k - batch_start]);
+            }
           }
-        }
-        spec_id_++;
 
-        if (sql_it > sql_batch_size_) // flush as sqlite can only handle so many bind_blob statements
-        {
-          // prevent writing of empty data which would throw an SQL exception
-          if (!data.empty())
+          for (Size k = batch_start; k < batch_end; k++)
           {
-            prepare_statement.resize( prepare_statement.size() -1 ); // remove last ","
-            conn.executeBindStatement(prepare_statement, data);
+            const MSSpectrum& spec = spectra[k];
+            int polarity = (spec.getInstrumentSettings().getPolarity() == IonSource::POSITIVE); // 1 = positive
+            insert_spectrum.bind(1, spec_id_);
+            insert_spectrum.bind(2, (Int64)run_id_);
+            insert_spectrum.bindText(3, spec.getNativeID());
+            insert_spectrum.bind(4, (int)spec.getMSLevel());
+            insert_spectrum.bind(5, spec.getRT());
+            insert_spectrum.bind(6, polarity);
+            insert_spectrum.step();
+
+            if (!spec.getPrecursors().empty())
+            {
+              if (spec.getPrecursors().size() > 1)
+              {
+                std::cout << "WARNING cannot store more than first precursor" << std::endl;
+              }
+              if (spec.getPrecursors()[0].getActivationMethods().size() > 1)
+              {
+                std::cout << "WARNING cannot store more than one activation method" << std::endl;
+              }
+
+              const OpenMS::Precursor& prec = spec.getPrecursors()[0];
+              // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
+              int activation_method = -1;
+              if (!prec.getActivationMethods().empty() )
+              {
+                activation_method = *prec.getActivationMethods().begin();
+              }
+              insert_precursor.bind(1, spec_id_);
+              insert_precursor.bind(2, prec.getCharge());
+              insert_precursor.bind(3, prec.getMZ());
+              insert_precursor.bind(4, prec.getIsolationWindowLowerOffset());
+              insert_precursor.bind(5, prec.getIsolationWindowUpperOffset());
+              insert_precursor.bind(6, prec.getDriftTime());
+              insert_precursor.bind(7, prec.getActivationEnergy());
+              insert_precursor.bind(8, activation_method);
+              String pepseq;
+              if (prec.metaValueExists("peptide_sequence"))
+              {
+                pepseq = prec.getMetaValue("peptide_sequence");
+                insert_precursor.bindText(9, pepseq);
+              }
+              else
+              {
+                insert_precursor.bindNull(9);
+              }
+              insert_precursor.step();
+            }
+
+            if (!spec.getProducts().empty())
+            {
+              if (spec.getProducts().size() > 1)
+              {
+                std::cout << "WARNING cannot store more than first product" << std::endl;
+              }
+              const OpenMS::Product& prod = spec.getProducts()[0];
+              insert_product.bind(1, spec_id_);
+              insert_product.bind(2, 0);
+              insert_product.bind(3, prod.getMZ());
+              insert_product.bind(4, prod.getIsolationWindowLowerOffset());
+              insert_product.bind(5, prod.getIsolationWindowUpperOffset());
+              insert_product.step();
+            }
+
+            // mz data
+            insert_data.bind(1, spec_id_);
+            insert_data.bind(2, 0);
+            insert_data.bind(3, compression_mz);
+            insert_data.bindBlob(4, encoded_strings_mz[k - batch_start]);
+            insert_data.step();
+
+            // intensity data
+            insert_data.bind(1, spec_id_);
+            insert_data.bind(2, 1);
+            insert_data.bind(3, compression_int);
+            insert_data.bindBlob(4, encoded_strings_int[k - batch_start]);
+            insert_data.step();
+
+            spec_id_++;
           }
-
-          data.clear();
-          prepare_statement = "INSERT INTO DATA (SPECTRUM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
-          sql_it = 1;
         }
-
-      }
-
-      // prevent writing of empty data which would throw an SQL exception
-      if (!data.empty())
-      {
-        prepare_statement.resize( prepare_statement.size() -1 );
-        conn.executeBindStatement(prepare_statement, data);
-      }
-
-      conn.executeStatement("BEGIN TRANSACTION");
-      conn.executeStatement(insert_spectra_sql.str());
-      if (nr_precursors > 0)
-      {
-        conn.executeStatement(insert_precursor_sql.str());
-      }
-      if (nr_products > 0)
-      {
-        conn.executeStatement(insert_product_sql.str());
       }
       conn.executeStatement("END TRANSACTION");
     }
@@ -1229,15 +1428,7 @@ namespace OpenMS::Internal
         return;
       }
       SqliteConnector conn(filename_);
-
-      // prepare streams and set required precision (default is 6 digits)
-      std::stringstream insert_chrom_sql;
-      std::stringstream insert_precursor_sql;
-      std::stringstream insert_product_sql;
-
-      insert_chrom_sql.precision(11);
-      insert_precursor_sql.precision(11);
-      insert_product_sql.precision(11);
+      prepareWriteConnection(conn, durable_write_);
 
       // Encoding options
       MSNumpressCoder::NumpressConfig npconfig_mz;
@@ -1250,169 +1441,122 @@ namespace OpenMS::Internal
       npconfig_int.numpressErrorTolerance = -1.0; // skip check, faster
       npconfig_int.setCompression("slof");
 
-      String prepare_statement = "INSERT INTO DATA (CHROMATOGRAM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
-      int sql_it = 1;
+      //  data_type is one of 0 = mz, 1 = int, 2 = rt
+      //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
+      const int compression_rt = use_lossy_compression_ ? 5 : 1;
+      const int compression_int = use_lossy_compression_ ? 6 : 1;
 
-      // Perform encoding in parallel
-      std::vector<String> encoded_strings_rt(chroms.size());
-      std::vector<String> encoded_strings_int(chroms.size());
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-      for (SignedSize k = 0; k < (SignedSize)chroms.size(); k++)
-      {
-        const MSChromatogram& chrom = chroms[k];
-        // encode retention time data (zlib or np-linear + zlib)
-        {
-          std::vector<double> data_to_encode;
-          data_to_encode.resize(chrom.size());
-          for (Size p = 0; p < chrom.size(); ++p)
-          {
-            data_to_encode[p] = chrom[p].getRT();
-          }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_mz);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_rt[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_rt[k] = encoded_string;
-          }
-        }
-
-        // encode intensity data (zlib or np-slof + zlib)
-        {
-          std::vector<double> data_to_encode;
-          data_to_encode.resize(chrom.size());
-          for (Size p = 0; p < chrom.size(); ++p)
-          {
-            data_to_encode[p] = chrom[p].getIntensity();
-          }
-
-          String uncompressed_str;
-          String encoded_string;
-          if (use_lossy_compression_)
-          {
-            MSNumpressCoder().encodeNPRaw(data_to_encode, uncompressed_str, npconfig_int);
-            OpenMS::ZlibCompression::compressString(uncompressed_str, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-          else
-          {
-            std::string str_data = std::string((const char*) (&data_to_encode[0]), data_to_encode.size() * sizeof(double));
-            OpenMS::ZlibCompression::compressString(str_data, encoded_string);
-            encoded_strings_int[k] = encoded_string;
-          }
-        }
-      }
-
-      std::vector<String> data;
-      for (Size k = 0; k < chroms.size(); k++)
+      // all chromatograms are written in a single transaction
+      conn.executeStatement("BEGIN TRANSACTION");
       {
-        const MSChromatogram& chrom = chroms[k];
-        insert_chrom_sql << "INSERT INTO CHROMATOGRAM (ID, RUN_ID, NATIVE_ID) VALUES (" << chrom_id_ << "," << run_id_ << ",'" << chrom.getNativeID() << "'); ";
-
-        OpenMS::Precursor prec = chrom.getPrecursor();
-        // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
-        int activation_method = -1;
-        if (!prec.getActivationMethods().empty() )
-        {
-          activation_method = *prec.getActivationMethods().begin();
-        }
-        String pepseq;
-        if (prec.metaValueExists("peptide_sequence"))
-        {
-          pepseq = prec.getMetaValue("peptide_sequence");
-          insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " <<
-            "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " << 
-            "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (" << 
-            chrom_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-            "," << prec.getDriftTime() << 
-            "," << prec.getActivationEnergy() << 
-            "," << activation_method << ",'" << pepseq << "'" << "); ";
-        }
-        else
-        {
-          insert_precursor_sql << "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
-            "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, ACTIVATION_METHOD) VALUES (" << 
-            chrom_id_ << "," << prec.getCharge() << "," << prec.getMZ() << 
-            "," << prec.getIsolationWindowLowerOffset() << "," << prec.getIsolationWindowUpperOffset() <<
-            "," << prec.getDriftTime() << 
-            "," << prec.getActivationEnergy() << 
-            "," << activation_method << "); ";
-        }
-
-        OpenMS::Product prod = chrom.getProduct();
-        insert_product_sql << "INSERT INTO PRODUCT (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " << 
-          "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (" << 
-          chrom_id_ << "," << 0 << "," << prod.getMZ() << 
-          "," << prod.getIsolationWindowLowerOffset() << "," << prod.getIsolationWindowUpperOffset() << "); ";
-
-        //  data_type is one of 0 = mz, 1 = int, 2 = rt
-        //  compression is one of 0 = no, 1 = zlib, 2 = np-linear, 3 = np-slof, 4 = np-pic, 5 = np-linear + zlib, 6 = np-slof + zlib, 7 = np-pic + zlib
-
-        // encode retention time data (zlib or np-linear + zlib)
-        {
-          data.push_back(encoded_strings_rt[k]);
-          if (use_lossy_compression_)
-          {
-            prepare_statement += String("(") + chrom_id_ + ", 2, 5, ?" + sql_it++ + " ),";
-          }
-          else
-          {
-            prepare_statement += String("(") + chrom_id_ + ", 2, 1, ?" + sql_it++ + " ),";
-          }
-        }
-
-        // encode intensity data (zlib or np-slof + zlib)
+        ReusableStatement insert_data(conn.getDB(), "INSERT INTO DATA (CHROMATOGRAM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES (?1, ?2, ?3, ?4);");
+        ReusableStatement insert_chrom(conn.getDB(), "INSERT INTO CHROMATOGRAM (ID, RUN_ID, NATIVE_ID) VALUES (?1, ?2, ?3);");
+        ReusableStatement insert_precursor(conn.getDB(), "INSERT INTO PRECURSOR (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " \
+                                                         "ISOLATION_LOWER, ISOLATION_UPPER, DRIFT_TIME, ACTIVATION_ENERGY, " \
+                                                         "ACTIVATION_METHOD, PEPTIDE_SEQUENCE) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9);");
+        ReusableStatement insert_product(conn.getDB(), "INSERT INTO PRODUCT (CHROMATOGRAM_ID, CHARGE, ISOLATION_TARGET, " \
+                                                       "ISOLATION_LOWER, ISOLATION_UPPER) VALUES (?1, ?2, ?3, ?4, ?5);");
+
+        // Chromatograms are encoded in parallel in batches of sql_batch_size_
+        // and then inserted in order (this bounds the memory for encoded data)
+        const Size batch_size = std::max(sql_batch_size_, 1);
+        std::vector<String> encoded_strings_rt;
+        std::vector<String> encoded_strings_int;
+        for (Size batch_start = 0; batch_start < chroms.size(); batch_start += batch_size)
         {
-          data.push_back(encoded_strings_int[k]);
-          if (use_lossy_compression_)
-          {
-            prepare_statement += String("(") + chrom_id_ + ", 1, 6, ?" + sql_it++ + " ),";
-          }
-          else
+          const Size batch_end = std::min(batch_start + batch_size, chroms.size());
+          encoded_strings_rt.resize(batch_end - batch_start);
+          encoded_strings_int.resize(batch_end - batch_start);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
           {
-            prepare_statement += String("(") + chrom_id_ + ", 1, 1, ?" + sql_it++ + " ),";
+            std::vector<double> data_to_encode;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (SignedSize k = batch_start; k < (SignedSize)batch_end; k++)
+            {
+              const MSChromatogram& chrom = chroms[k];
+
+              // encode retention time data (zlib or np-linear + zlib)
+              data_to_encode.resize(chrom.size());
+              for (Size p = 0; p < chrom.size(); ++p)
+              {
+                data_to_encode[p] = chrom[p].getRT();
+              }
+              encodeDataArray(data_to_encode, use_lossy_compression_, npconfig_mz, encoded_strings_rt[k - batch_start]);
+
+              // encode intensity data (zlib or np-slof + zlib)
+              for (Size p = 0; p < chrom.size(); ++p)
+              {
+                data_to_encode[p] = chrom[p].getIntensity();
+              }
+              encodeDataArray(data_to_encode, use_lossy_compression_, npconfig_int, encoded_strings_int[k - batch_start]);
+            }
           }
-        }
-        chrom_id_++;
 
-        if (sql_it > sql_batch_size_) // flush as sqlite can only handle so many bind_blob statements
-        {
-          // prevent writing of empty data which would throw an SQL exception
-          if (!data.empty())
+          for (Size k = batch_start; k < batch_end; k++)
           {
-            prepare_statement.resize( prepare_statement.size() -1 ); // remove last ","
-            conn.executeBindStatement(prepare_statement, data);
+            const MSChromatogram& chrom = chroms[k];
+            insert_chrom.bind(1, chrom_id_);
+            insert_chrom.bind(2, (Int64)run_id_);
+            insert_chrom.bindText(3, chrom.getNativeID());
+            insert_chrom.step();
+
+            const OpenMS::Precursor& prec = chrom.getPrecursor();
+            // see src/openms/include/OpenMS/METADATA/Precursor.h for activation modes
+            int activation_method = -1;
+            if (!prec.getActivationMethods().empty() )
+            {
+              activation_method = *prec.getActivationMethods().begin();
+            }
+            insert_precursor.bind(1, chrom_id_);
+            insert_precursor.bind(2, prec.getCharge());
+            insert_precursor.bind(3, prec.getMZ());
+            insert_precursor.bind(4, prec.getIsolationWindowLowerOffset());
+            insert_precursor.bind(5, prec.getIsolationWindowUpperOffset());
+            insert_precursor.bind(6, prec.getDriftTime());
+            insert_precursor.bind(7, prec.getActivationEnergy());
+            insert_precursor.bind(8, activation_method);
+            String pepseq;
+            if (prec.metaValueExists("peptide_sequence"))
+            {
+              pepseq = prec.getMetaValue("peptide_sequence");
+              insert_precursor.bindText(9, pepseq);
+            }
+            else
+            {
+              insert_precursor.bindNull(9);
+            }
+            insert_precursor.step();
+
+            const OpenMS::Product& prod = chrom.getProduct();
+            insert_product.bind(1, chrom_id_);
+            insert_product.bind(2, 0);
+            insert_product.bind(3, prod.getMZ());
+            insert_product.bind(4, prod.getIsolationWindowLowerOffset());
+            insert_product.bind(5, prod.getIsolationWindowUpperOffset());
+            insert_product.step();
+
+            // retention time data
+            insert_data.bind(1, chrom_id_);
+            insert_data.bind(2, 2);
+            insert_data.bind(3, compression_rt);
+            insert_data.bindBlob(4, encoded_strings_rt[k - batch_start]);
+            insert_data.step();
+
+            // intensity data
+            insert_data.bind(1, chrom_id_);
+            insert_data.bind(2, 1);
+            insert_data.bind(3, compression_int);
+            insert_data.bindBlob(4, encoded_strings_int[k - batch_start]);
+            insert_data.step();
+
+            chrom_id_++;
           }
-
-          data.clear();
-          prepare_statement = "INSERT INTO DATA (CHROMATOGRAM_ID, DATA_TYPE, COMPRESSION, DATA) VALUES ";
-          sql_it = 1;
         }
-
-      }
-
-      // prevent writing of empty data which would throw an SQL exception
-      if (!data.empty())
-      {
-        prepare_statement.resize(prepare_statement.size() -1); // remove last ","
-        conn.executeBindStatement(prepare_statement, data);
       }
-
-      conn.executeStatement("BEGIN TRANSACTION");
-      conn.executeStatement(insert_chrom_sql.str());
-      conn.executeStatement(insert_precursor_sql.str());
-      conn.executeStatement(insert_product_sql.str());
       conn.executeStatement("END TRANSACTION");
     }
 
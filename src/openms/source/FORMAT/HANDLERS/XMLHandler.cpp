@@ -185,6 +185,19 @@ namespace OpenMS::Internal
     {
     }
 
+    void XMLHandler::processingInstruction(const XMLCh * const target, const XMLCh * const data)
+    {
+      if (sm_.convert(target) == XMLFile::SplitDocument::block_marker)
+      {
+        String block = sm_.convert(data);
+        splitBlock_(asUInt_(block.trim()));
+      }
+    }
+
+    void XMLHandler::splitBlock_(Size /*block*/)
+    {
+    }
+
     void XMLHandler::writeTo(std::ostream & /*os*/)
     {
     }
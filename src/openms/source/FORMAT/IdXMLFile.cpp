@@ -43,7 +43,9 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <unordered_map>
 
 using namespace std;
@@ -80,7 +82,47 @@ namespace OpenMS
     pep_ids_ = &peptide_ids;
     document_id_ = &document_id;
 
-    parse_(filename, this);
+    SplitDocument document;
+    if (!splitDocument_(filename, "PeptideIdentification", "IdentificationRun", document))
+    {
+      parse_(filename, this);
+    }
+    else
+    {
+      // parse everything but the peptide identifications first, then the chunks of peptide identifications in parallel
+      parseBuffer_(document.skeleton, this);
+      vector<vector<PeptideIdentification> > chunk_ids(document.chunks.size());
+      parseChunks_(document, [&](Size i)
+      {
+        const SplitContext_& context = split_contexts_.at(document.chunk_blocks[i]);
+        vector<ProteinIdentification> chunk_prot_ids(1);
+        chunk_prot_ids[0].setIdentifier(context.identifier);
+        String chunk_document_id;
+
+        IdXMLFile chunk_file;
+        chunk_file.file_ = filename;
+        chunk_file.prot_ids_ = &chunk_prot_ids;
+        chunk_file.pep_ids_ = &chunk_ids[i];
+        chunk_file.document_id_ = &chunk_document_id;
+        chunk_file.proteinid_to_accession_ = context.proteinid_to_accession;
+        chunk_file.prot_id_in_run_ = true;
+        parseBuffer_(document.getChunkDocument(i), &chunk_file);
+      });
+
+      // append the peptide identifications in document order
+      Size n_ids = peptide_ids.size();
+      for (const vector<PeptideIdentification>& ids : chunk_ids)
+      {
+        n_ids += ids.size();
+      }
+      peptide_ids.reserve(n_ids);
+      for (vector<PeptideIdentification>& ids : chunk_ids)
+      {
+        std::move(ids.begin(), ids.end(), back_inserter(peptide_ids));
+        vector<PeptideIdentification>().swap(ids);
+      }
+      split_contexts_.clear();
+    }
 
     //reset members
     prot_ids_ = nullptr;
@@ -933,6 +975,23 @@ namespace OpenMS
     }
   }
 
+  void IdXMLFile::splitBlock_(Size block)
+  {
+    // the first peptide identification of a run without protein identification adds an empty one
+    if (!prot_id_in_run_)
+    {
+      prot_ids_->push_back(prot_id_);
+      prot_id_in_run_ = true;
+    }
+
+    if (split_contexts_.size() <= block)
+    {
+      split_contexts_.resize(block + 1);
+    }
+    split_contexts_[block].identifier = prot_ids_->back().getIdentifier();
+    split_contexts_[block].proteinid_to_accession = proteinid_to_accession_;
+  }
+
   void IdXMLFile::addProteinGroups_(
     MetaInfoInterface& meta, const std::vector<ProteinIdentification::ProteinGroup>&
     groups, const String& group_name, const std::unordered_map<string, UInt>& accession_to_id,
@@ -130,11 +130,22 @@ namespace OpenMS
     handler.getCounts(scount, ccount);
   }
 
-  void MzMLFile::safeParse_(const String& filename, Internal::XMLHandler* handler)
+  void MzMLFile::safeParse_(const String& filename, Internal::MzMLHandler* handler)
   {
     try
     {
-      parse_(filename, handler);
+      try
+      {
+        parse_(filename, handler);
+      }
+      catch (...)
+      {
+        // errors of the batches decoded in the background refer to data before
+        // the parsing error and are reported instead (see waitForDecoding())
+        handler->waitForDecoding();
+        throw;
+      }
+      handler->waitForDecoding(); // only data left over if parsing was ended softly
     }
     catch (Exception::BaseException& e)
     {
@@ -154,7 +165,16 @@ namespace OpenMS
 
     Internal::MzMLHandler handler(map, "memory", getVersion(), *this);
     handler.setOptions(options_);
-    parseBuffer_(buffer, &handler);
+    try
+    {
+      parseBuffer_(buffer, &handler);
+    }
+    catch (...)
+    {
+      handler.waitForDecoding(); // see safeParse_()
+      throw;
+    }
+    handler.waitForDecoding();
   }
 
   void MzMLFile::load(const String& filename, PeakMap& map)
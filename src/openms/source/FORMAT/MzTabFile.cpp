@@ -54,6 +54,70 @@ using namespace std;
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Writes lines to a stream (like TextFile::store()) while reinserting the empty and comment lines of a loaded mzTab file at their original line numbers
+    class MzTabLineWriter
+    {
+    public:
+      MzTabLineWriter(std::ostream& os, const vector<Size>& empty_rows, const map<Size, String>& comment_rows) :
+        os_(os),
+        empty_rows_(empty_rows),
+        comment_rows_(comment_rows)
+      {
+      }
+
+      void write(const String& line)
+      {
+        while (true)
+        {
+          if (std::binary_search(empty_rows_.begin(), empty_rows_.end(), line_)) // check if current line was originally an empty line
+          {
+            writeLine_("\n");
+          }
+          else if (comment_rows_.find(line_) != comment_rows_.end()) // check if current line was originally a comment line
+          {
+            writeLine_(comment_rows_.at(line_));
+          }
+          else
+          {
+            break;
+          }
+          ++line_;
+        }
+        writeLine_(line);
+        ++line_;
+      }
+
+      void write(const StringList& lines)
+      {
+        for (const String& line : lines) { write(line); }
+      }
+
+    private:
+      void writeLine_(const String& line)
+      {
+        if (line.hasSuffix("\r\n"))
+        {
+          os_ << line.chop(2) << "\n";
+        }
+        else if (line.hasSuffix("\n"))
+        {
+          os_ << line;
+        }
+        else
+        {
+          os_ << line << "\n";
+        }
+      }
+
+      std::ostream& os_;
+      const vector<Size>& empty_rows_;
+      const map<Size, String>& comment_rows_;
+      Size line_ = 0; ///< number of the next line in the output (including reinserted lines)
+    };
+  }
+
   MzTabFile::MzTabFile():
   store_protein_reliability_(false),
   store_peptide_reliability_(false),
@@ -2948,27 +3012,20 @@ namespace OpenMS
    
     Size n_best_search_engine_score = meta_data.protein_search_engine_score.size();
 
-    {
-      MzTabProteinSectionRow row;
-      bool first = true;
-      size_t n_header_columns = 0;
-      while (s.nextPRTRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabProteinHeader_(
-            row,
-            n_best_search_engine_score,
-            s.getProteinOptionalColumnNames(),
-            meta_data,
-            n_header_columns) + "\n";
-          first = false;
-        }
-        size_t n_section_columns = 0;
-        tab_file << generateMzTabSectionRow_(row, s.getProteinOptionalColumnNames(), meta_data, n_section_columns) + "\n";
-        if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Protein header and content differs in columns. Please report this bug to the OpenMS developers.");
-      }
-    }
+    writeMzTabSection_<MzTabProteinSectionRow>(
+      [&s](MzTabProteinSectionRow& row) { return s.nextPRTRow(row); },
+      [&](const MzTabProteinSectionRow& row)
+      { // add header
+        size_t n_header_columns = 0;
+        tab_file << "\n" << generateMzTabProteinHeader_(
+          row,
+          n_best_search_engine_score,
+          s.getProteinOptionalColumnNames(),
+          meta_data,
+          n_header_columns) + "\n";
+        return n_header_columns;
+      },
+      s.getProteinOptionalColumnNames(), meta_data, tab_file);
 
     Size n_search_engine_scores = meta_data.psm_search_engine_score.size();
 
@@ -2977,22 +3034,15 @@ namespace OpenMS
       OPENMS_LOG_WARN << "No search engine scores given. Please check your input data." << endl;
     }
 
-    {
-      MzTabPSMSectionRow row;
-      bool first = true;
-      size_t n_header_columns = 0;
-      while (s.nextPSMRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames(), n_header_columns) + "\n";
-          first = false;
-        }
-        size_t n_section_columns = 0;
-        tab_file << generateMzTabSectionRow_(row, s.getPSMOptionalColumnNames(), meta_data, n_section_columns) + "\n";
-        if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "PSM header and content differs in columns. Please report this bug to the OpenMS developers.");
-      }
-    }
+    writeMzTabSection_<MzTabPSMSectionRow>(
+      [&s](MzTabPSMSectionRow& row) { return s.nextPSMRow(row); },
+      [&](const MzTabPSMSectionRow&)
+      { // add header
+        size_t n_header_columns = 0;
+        tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames(), n_header_columns) + "\n";
+        return n_header_columns;
+      },
+      s.getPSMOptionalColumnNames(), meta_data, tab_file);
 
     tab_file.close();
     
@@ -3040,58 +3090,39 @@ namespace OpenMS
     Size n_best_search_engine_score = meta_data.protein_search_engine_score.size();
     // TODO: we currently only store one search engine score per PSM so we need to limit the number to the main score
     n_best_search_engine_score = std::min(n_best_search_engine_score, Size(1));
-    {
-      MzTabProteinSectionRow row;
-      bool first = true;
-      size_t n_header_columns = 0;
-      while (s.nextPRTRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabProteinHeader_(
-            row,
-            n_best_search_engine_score,
-            s.getProteinOptionalColumnNames(),
-            meta_data, 
-            n_header_columns) + "\n";
-          first = false;
-        }
-        size_t n_section_columns = 0;
-        tab_file << generateMzTabSectionRow_(row, s.getProteinOptionalColumnNames(), meta_data, n_section_columns) + "\n";
-        if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Protein header and content differs in columns. Please report this bug to the OpenMS developers.");
-      }
-    }
 
-    Size assays(0);
-    Size study_variables(0);
-    {
-      MzTabPeptideSectionRow row;
-      bool first = true;
-      size_t n_header_columns = 0;
-      while (s.nextPEPRow(row))
-      {
-        if (first)
-        {
-          assays = row.peptide_abundance_assay.size();
-          study_variables = row.peptide_abundance_study_variable.size();
-          Size n_search_engine_score = row.search_engine_score_ms_run.size(); // scores to runs          
-          Size search_ms_runs = n_search_engine_score != 0 ? row.search_engine_score_ms_run.at(1).size() : 0; // take number of searched MS runs from first score. TODO: handle this more generic
-          OPENMS_LOG_DEBUG << "Exporting assays: " << assays << endl;
-          OPENMS_LOG_DEBUG << "Exporting study variables: " << study_variables << endl;
-          OPENMS_LOG_DEBUG << "Exporting search engines scores: " << n_search_engine_score << endl;
-          Size n_best_search_engine_score = row.best_search_engine_score.size();
-          tab_file << "\n" << generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, s.getPeptideOptionalColumnNames(), n_header_columns) + "\n";
-          first = false;
-        }
-        size_t n_section_columns = 0;
-        tab_file << generateMzTabSectionRow_(row, s.getPeptideOptionalColumnNames(), meta_data, n_section_columns) + "\n";
-        if (n_header_columns != n_section_columns)
-        {
-          OPENMS_LOG_ERROR << "Number of columns in header/section: " << n_header_columns << "/" << n_section_columns << endl;
-          throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Peptide header and content differs in columns. Please report this bug to the OpenMS developers.");
-        }
-      }
-    } 
+    writeMzTabSection_<MzTabProteinSectionRow>(
+      [&s](MzTabProteinSectionRow& row) { return s.nextPRTRow(row); },
+      [&](const MzTabProteinSectionRow& row)
+      { // add header
+        size_t n_header_columns = 0;
+        tab_file << "\n" << generateMzTabProteinHeader_(
+          row,
+          n_best_search_engine_score,
+          s.getProteinOptionalColumnNames(),
+          meta_data, 
+          n_header_columns) + "\n";
+        return n_header_columns;
+      },
+      s.getProteinOptionalColumnNames(), meta_data, tab_file);
+
+    writeMzTabSection_<MzTabPeptideSectionRow>(
+      [&s](MzTabPeptideSectionRow& row) { return s.nextPEPRow(row); },
+      [&](const MzTabPeptideSectionRow& row)
+      { // add header
+        Size assays = row.peptide_abundance_assay.size();
+        Size study_variables = row.peptide_abundance_study_variable.size();
+        Size n_search_engine_score = row.search_engine_score_ms_run.size(); // scores to runs          
+        Size search_ms_runs = n_search_engine_score != 0 ? row.search_engine_score_ms_run.at(1).size() : 0; // take number of searched MS runs from first score. TODO: handle this more generic
+        OPENMS_LOG_DEBUG << "Exporting assays: " << assays << endl;
+        OPENMS_LOG_DEBUG << "Exporting study variables: " << study_variables << endl;
+        OPENMS_LOG_DEBUG << "Exporting search engines scores: " << n_search_engine_score << endl;
+        Size n_best_search_engine_score = row.best_search_engine_score.size();
+        size_t n_header_columns = 0;
+        tab_file << "\n" << generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, s.getPeptideOptionalColumnNames(), n_header_columns) + "\n";
+        return n_header_columns;
+      },
+      s.getPeptideOptionalColumnNames(), meta_data, tab_file);
 
     Size n_search_engine_scores = meta_data.psm_search_engine_score.size();
 
@@ -3100,25 +3131,17 @@ namespace OpenMS
       OPENMS_LOG_WARN << "No search engine scores given. Please check your input data." << endl;
     }
 
-    {
-      MzTabPSMSectionRow row;
-      bool first = true;
-
-      // TODO: we currently only store one search engine score per PSM so we need to limit the number to the main score      
-      n_search_engine_scores = 1;
-      size_t n_header_columns = 0;
-      while (s.nextPSMRow(row))
-      {
-        if (first)
-        { // add header
-          tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames(), n_header_columns) + "\n";
-          first = false;
-        }
-        size_t n_section_columns = 0;
-        tab_file << generateMzTabSectionRow_(row, s.getPSMOptionalColumnNames(), meta_data, n_section_columns) + "\n";
-        if (n_header_columns != n_section_columns)  throw Exception::Postcondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "PSM header and content differs in columns. Please report this bug to the OpenMS developers.");
-      }
-    }
+    // TODO: we currently only store one search engine score per PSM so we need to limit the number to the main score      
+    n_search_engine_scores = 1;
+    writeMzTabSection_<MzTabPSMSectionRow>(
+      [&s](MzTabPSMSectionRow& row) { return s.nextPSMRow(row); },
+      [&](const MzTabPSMSectionRow&)
+      { // add header
+        size_t n_header_columns = 0;
+        tab_file << "\n" << generateMzTabPSMHeader_(n_search_engine_scores, s.getPSMOptionalColumnNames(), n_header_columns) + "\n";
+        return n_header_columns;
+      },
+      s.getPSMOptionalColumnNames(), meta_data, tab_file);
 
     tab_file.close();
   }
@@ -3131,8 +3154,33 @@ namespace OpenMS
       + FileTypes::typeToName(FileTypes::MZTAB) + "' or '" + FileTypes::typeToName(FileTypes::TSV) + "'");
     }
 
+    ofstream tab_file;
+    // stream not opened in binary mode, thus "\n" will be evaluated platform dependent (like in TextFile::store())
+    tab_file.open(filename, ios::out | ios::trunc);
+    if (!tab_file)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    // the lines are written as soon as they are generated, reinserting the comments (might provide critical cues for human reader)
+    // and empty lines of the original file
+    MzTabLineWriter writer(tab_file, mz_tab.getEmptyRows(), mz_tab.getCommentRows());
     StringList out;
+
+    // write the rows of a section in blocks, so that only the lines of one block are kept in memory
+    auto write_section = [&](const auto& rows, const vector<String>& optional_columns, size_t n_header_columns)
+    {
+      for (Size block_begin = 0; block_begin < rows.size(); block_begin += row_block_size_)
+      {
+        const Size block_end = std::min(block_begin + row_block_size_, rows.size());
+        out.clear();
+        generateMzTabSection_(rows.begin() + block_begin, rows.begin() + block_end, optional_columns, mz_tab.getMetaData(), out, n_header_columns);
+        writer.write(out);
+      }
+    };
+
     generateMzTabMetaDataSection_(mz_tab.getMetaData(), out);
+    writer.write(out);
     bool complete = (mz_tab.getMetaData().mz_tab_mode.toCellString() == "Complete");
     Size ms_runs = mz_tab.getMetaData().ms_run.size();
 
@@ -3147,16 +3195,16 @@ namespace OpenMS
 
       // add header
       // use the first row as a reference row to get the optional cols from meta values
-      out.push_back("");
+      writer.write(String());
       size_t n_header_columns = 0;
-      out.push_back(generateMzTabProteinHeader_(protein_section[0],
+      writer.write(generateMzTabProteinHeader_(protein_section[0],
           n_best_search_engine_score,
           mz_tab.getProteinOptionalColumnNames(),
           mz_tab.getMetaData(), 
           n_header_columns));
 
       // add section content
-      generateMzTabSection_(protein_section, mz_tab.getProteinOptionalColumnNames(), mz_tab.getMetaData(), out, n_header_columns);
+      write_section(protein_section, mz_tab.getProteinOptionalColumnNames(), n_header_columns);
     }
 
     if (!peptide_section.empty())
@@ -3186,10 +3234,10 @@ namespace OpenMS
       Size n_search_engine_score = peptide_section[0].search_engine_score_ms_run.size();
       Size n_best_search_engine_score = peptide_section[0].best_search_engine_score.size();
 
-      out.push_back("");
+      writer.write(String());
       size_t n_header_columns = 0;
-      out.push_back(generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getPeptideOptionalColumnNames(), n_header_columns));
-      generateMzTabSection_(mz_tab.getPeptideSectionRows(), mz_tab.getPeptideOptionalColumnNames(), mz_tab.getMetaData(), out, n_header_columns);
+      writer.write(generateMzTabPeptideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getPeptideOptionalColumnNames(), n_header_columns));
+      write_section(mz_tab.getPeptideSectionRows(), mz_tab.getPeptideOptionalColumnNames(), n_header_columns);
     }
 
     if (!psm_section.empty())
@@ -3201,10 +3249,10 @@ namespace OpenMS
       {
         // TODO warn
       }
-      out.push_back("");
+      writer.write(String());
       size_t n_header_columns = 0;
-      out.push_back(generateMzTabPSMHeader_(n_search_engine_scores, mz_tab.getPSMOptionalColumnNames(), n_header_columns));
-      generateMzTabSection_(mz_tab.getPSMSectionRows(), mz_tab.getPSMOptionalColumnNames(), mz_tab.getMetaData(), out, n_header_columns);
+      writer.write(generateMzTabPSMHeader_(n_search_engine_scores, mz_tab.getPSMOptionalColumnNames(), n_header_columns));
+      write_section(mz_tab.getPSMSectionRows(), mz_tab.getPSMOptionalColumnNames(), n_header_columns);
     }
 
     if (!smallmolecule_section.empty())
@@ -3213,10 +3261,10 @@ namespace OpenMS
       Size study_variables = smallmolecule_section[0].smallmolecule_abundance_study_variable.size();
       Size n_search_engine_score = smallmolecule_section[0].search_engine_score_ms_run.size();
       Size n_best_search_engine_score = mz_tab.getMetaData().smallmolecule_search_engine_score.size();
-      out.push_back("");
+      writer.write(String());
       size_t n_header_columns = 0;
-      out.push_back(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getSmallMoleculeOptionalColumnNames(), n_header_columns));
-      generateMzTabSection_(smallmolecule_section, mz_tab.getSmallMoleculeOptionalColumnNames(), mz_tab.getMetaData(), out, n_header_columns);
+      writer.write(generateMzTabSmallMoleculeHeader_(ms_runs, n_best_search_engine_score, n_search_engine_score, assays, study_variables, mz_tab.getSmallMoleculeOptionalColumnNames(), n_header_columns));
+      write_section(smallmolecule_section, mz_tab.getSmallMoleculeOptionalColumnNames(), n_header_columns);
     }
 
     const MzTabNucleicAcidSectionRows& nucleic_acid_section = mz_tab.getNucleicAcidSectionRows();
@@ -3251,12 +3299,12 @@ namespace OpenMS
       Size n_best_search_engine_score = mz_tab.getMetaData().nucleic_acid_search_engine_score.size();
 
       // add header
-      out.push_back("");
+      writer.write(String());
       size_t n_header_columns = 0;
-      out.push_back(generateMzTabNucleicAcidHeader_(search_ms_runs, n_search_engine_score, n_best_search_engine_score, mz_tab.getNucleicAcidOptionalColumnNames(), n_header_columns));
+      writer.write(generateMzTabNucleicAcidHeader_(search_ms_runs, n_search_engine_score, n_best_search_engine_score, mz_tab.getNucleicAcidOptionalColumnNames(), n_header_columns));
 
       // add section
-      generateMzTabSection_(nucleic_acid_section, mz_tab.getNucleicAcidOptionalColumnNames(), mz_tab.getMetaData(), out, n_header_columns);
+      write_section(nucleic_acid_section, mz_tab.getNucleicAcidOptionalColumnNames(), n_header_columns);
     }
 
     if (!oligonucleotide_section.empty())
@@ -3285,10 +3333,10 @@ namespace OpenMS
       }
       Size n_search_engine_score = oligonucleotide_section[0].search_engine_score_ms_run.size();
       Size n_best_search_engine_score = mz_tab.getMetaData().oligonucleotide_search_engine_score.size();
-      out.push_back("");
+      writer.write(String());
       size_t n_columns = 0;
-      out.push_back(generateMzTabOligonucleotideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, mz_tab.getOligonucleotideOptionalColumnNames(), n_columns));
-      generateMzTabSection_(mz_tab.getOligonucleotideSectionRows(), mz_tab.getOligonucleotideOptionalColumnNames(), mz_tab.getMetaData(), out, n_columns);
+      writer.write(generateMzTabOligonucleotideHeader_(search_ms_runs, n_best_search_engine_score, n_search_engine_score, mz_tab.getOligonucleotideOptionalColumnNames(), n_columns));
+      write_section(mz_tab.getOligonucleotideSectionRows(), mz_tab.getOligonucleotideOptionalColumnNames(), n_columns);
     }
 
     if (!osm_section.empty())
@@ -3299,50 +3347,13 @@ namespace OpenMS
       {
         // TODO warn
       }
-      out.push_back("");
+      writer.write(String());
       size_t n_columns = 0;
-      out.push_back(generateMzTabOSMHeader_(n_search_engine_scores, mz_tab.getOSMOptionalColumnNames(), n_columns));
-      generateMzTabSection_(mz_tab.getOSMSectionRows(), mz_tab.getOSMOptionalColumnNames(), mz_tab.getMetaData(), out, n_columns);
-  }
-
-    // insert comments (might provide critical cues for human reader) and empty lines
-  Size line = 0;
-  vector<Size> empty_rows = mz_tab.getEmptyRows();
-  map<Size, String> comment_rows = mz_tab.getCommentRows();
-
-  if (empty_rows.empty() && comment_rows.empty())
-  {
-    TextFile tmp_out;
-    for (TextFile::ConstIterator it = out.begin(); it != out.end(); ++it)
-    {
-      tmp_out.addLine(*it);
-    }
-    tmp_out.store(filename);
-  }
-  else
-  {
-    TextFile tmp_out;
-    for (TextFile::ConstIterator it = out.begin(); it != out.end(); )
-    {
-      if (std::binary_search(empty_rows.begin(), empty_rows.end(), line))  // check if current line was originally an empty line
-      {
-        tmp_out.addLine("\n");
-        ++line;
-      }
-      else if (comment_rows.find(line) != comment_rows.end()) // check if current line was originally a comment line
-      {
-        tmp_out.addLine(comment_rows[line]);
-        ++line;
-      }
-      else   // no empty line, no comment => add row
-      {
-        tmp_out.addLine(*it);
-        ++line;
-        ++it;
-      }
+      writer.write(generateMzTabOSMHeader_(n_search_engine_scores, mz_tab.getOSMOptionalColumnNames(), n_columns));
+      write_section(mz_tab.getOSMSectionRows(), mz_tab.getOSMOptionalColumnNames(), n_columns);
     }
-    tmp_out.store(filename);
-  }
+
+    tab_file.close();
   }
 
 }
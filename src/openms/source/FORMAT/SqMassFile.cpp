@@ -53,7 +53,7 @@ namespace OpenMS
   void SqMassFile::store(const String& filename, MapType& map) const
   {
     OpenMS::Internal::MzMLSqliteHandler sql_mass(filename, map.getSqlRunID());
-    sql_mass.setConfig(config_.write_full_meta, config_.use_lossy_numpress, config_.linear_fp_mass_acc);
+    sql_mass.setConfig(config_.write_full_meta, config_.use_lossy_numpress, config_.linear_fp_mass_acc, 500, config_.durable_write);
     sql_mass.createTables();
     sql_mass.writeExperiment(map);
   }
@@ -47,11 +47,17 @@
 #include <xercesc/framework/MemBufInputSource.hpp>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <iomanip> // setprecision etc.
 
 #include <boost/shared_ptr.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS::Internal
@@ -109,15 +115,25 @@ private:
         throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
       }
 
-      // initialize parser
-      try
+      // initialize parser (not thread-safe, but chunks of split documents are parsed in parallel)
+      bool initialized = true;
+      String init_error;
+#pragma omp critical (XMLFile_initialize)
       {
-        xercesc::XMLPlatformUtils::Initialize();
+        try
+        {
+          xercesc::XMLPlatformUtils::Initialize();
+        }
+        catch (const xercesc::XMLException & toCatch)
+        {
+          initialized = false;
+          init_error = StringManager().convert(toCatch.getMessage());
+        }
       }
-      catch (const xercesc::XMLException & toCatch)
+      if (!initialized)
       {
         throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "", String("Error during initialization: ") + StringManager().convert(toCatch.getMessage()));
+            "", String("Error during initialization: ") + init_error);
       }
 
       boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
@@ -195,15 +211,25 @@ private:
 
       StringManager sm;
 
-      // initialize parser
-      try
+      // initialize parser (not thread-safe, but chunks of split documents are parsed in parallel)
+      bool initialized = true;
+      String init_error;
+#pragma omp critical (XMLFile_initialize)
       {
-        xercesc::XMLPlatformUtils::Initialize();
+        try
+        {
+          xercesc::XMLPlatformUtils::Initialize();
+        }
+        catch (const xercesc::XMLException & toCatch)
+        {
+          initialized = false;
+          init_error = StringManager().convert(toCatch.getMessage());
+        }
       }
-      catch (const xercesc::XMLException & toCatch)
+      if (!initialized)
       {
         throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
-            "", String("Error during initialization: ") + StringManager().convert(toCatch.getMessage()));
+            "", String("Error during initialization: ") + init_error);
       }
 
       boost::shared_ptr< xercesc::SAX2XMLReader > parser(xercesc::XMLReaderFactory::createXMLReader());
@@ -255,6 +281,300 @@ private:
       }
     }
 
+    std::string XMLFile::SplitDocument::getChunkDocument(Size index) const
+    {
+      const std::pair<Size, Size>& range = chunks[index];
+      std::string chunk;
+      chunk.reserve(declaration.size() + namespaces.size() + range.second - range.first + 64);
+      chunk += declaration;
+      chunk += "\n<openms-split-chunk";
+      chunk += namespaces;
+      chunk += ">\n";
+      chunk.append(buffer, range.first, range.second - range.first);
+      chunk += "\n</openms-split-chunk>\n";
+      return chunk;
+    }
+
+    bool XMLFile::splitDocument_(const String& filename, const String& entry_tag, const String& parent_tag, SplitDocument& document) const
+    {
+      document = SplitDocument();
+      auto fail = [&document]()
+      {
+        document = SplitDocument();
+        return false;
+      };
+
+#ifdef _OPENMP
+      const Size n_threads = omp_get_max_threads();
+#else
+      const Size n_threads = 1;
+#endif
+      if (n_threads < 2)
+      {
+        return false;
+      }
+
+      // read the whole file (compressed files are parsed as usual)
+      {
+        std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!is)
+        {
+          return false;
+        }
+        is.seekg(0, std::ios::end);
+        const std::streamoff size = is.tellg();
+        if (size < 0 || Size(size) < 2 * min_split_chunk_size_)
+        {
+          return false;
+        }
+        is.seekg(0, std::ios::beg);
+        char magic[2] = {0, 0};
+        is.read(magic, 2);
+        if ((magic[0] == 'B' && magic[1] == 'Z') || (magic[0] == char(0x1f) && magic[1] == char(0x8b)))
+        {
+          return false;
+        }
+        document.buffer.resize(size);
+        is.seekg(0, std::ios::beg);
+        is.read(&document.buffer[0], size);
+        if (!is)
+        {
+          return fail();
+        }
+      }
+
+      const std::string& b = document.buffer;
+      const Size n = b.size();
+      // a few chunks per thread to balance the load
+      const Size chunk_size = std::max(min_split_chunk_size_, n / (4 * n_threads));
+
+      // XML declaration (possibly preceded by a byte order mark), needed to decode the chunks
+      const Size declaration_begin = (b.compare(0, 3, "\xEF\xBB\xBF") == 0) ? 3 : 0;
+      if (b.compare(declaration_begin, 5, "<?xml") == 0)
+      {
+        const Size declaration_end = b.find("?>", declaration_begin);
+        if (declaration_end == std::string::npos)
+        {
+          return fail();
+        }
+        document.declaration = b.substr(0, declaration_end + 2);
+      }
+
+      // scan the tags of the document; names of open elements are stored as (offset, length) in the buffer
+      std::vector<std::pair<Size, Size> > open_tags;
+      auto is_tag = [&b](const std::pair<Size, Size>& name, const String& tag)
+      {
+        return name.second == tag.size() && b.compare(name.first, name.second, tag) == 0;
+      };
+
+      std::vector<std::pair<Size, Size> > blocks; // byte ranges of the blocks of consecutive entries
+      bool in_block = false;
+      Size chunk_begin = 0;
+      Size last_entry_end = 0;
+      Size entry_begin = 0;
+      Size entry_depth = 0; // number of open tags including the current entry (0 if not inside an entry)
+
+      auto close_block = [&]()
+      {
+        if (!in_block)
+        {
+          return;
+        }
+        document.chunks.emplace_back(chunk_begin, last_entry_end);
+        document.chunk_blocks.push_back(blocks.size() - 1);
+        blocks.back().second = last_entry_end;
+        in_block = false;
+      };
+      auto add_entry = [&](Size begin, Size end)
+      {
+        if (!in_block)
+        {
+          blocks.emplace_back(begin, end);
+          in_block = true;
+          chunk_begin = begin;
+        }
+        else if (last_entry_end - chunk_begin >= chunk_size)
+        {
+          document.chunks.emplace_back(chunk_begin, last_entry_end);
+          document.chunk_blocks.push_back(blocks.size() - 1);
+          chunk_begin = begin;
+        }
+        last_entry_end = end;
+      };
+
+      Size pos = 0;
+      while (true)
+      {
+        const Size lt = b.find('<', pos);
+        // character data between entries ends a block
+        if (in_block && entry_depth == 0 &&
+            std::any_of(b.begin() + pos, (lt == std::string::npos) ? b.end() : b.begin() + lt, [](char c) { return !std::isspace(static_cast<unsigned char>(c)); }))
+        {
+          close_block();
+        }
+        if (lt == std::string::npos)
+        {
+          break;
+        }
+
+        if (b.compare(lt, 4, "<!--") == 0)
+        {
+          const Size end = b.find("-->", lt + 4);
+          if (end == std::string::npos)
+          {
+            return fail();
+          }
+          pos = end + 3;
+          continue;
+        }
+        if (b.compare(lt, 9, "<![CDATA[") == 0 || b.compare(lt, 2, "<?") == 0)
+        {
+          const bool cdata = b[lt + 1] == '!';
+          const Size end = b.find(cdata ? "]]>" : "?>", lt);
+          if (end == std::string::npos)
+          {
+            return fail();
+          }
+          if (entry_depth == 0)
+          {
+            close_block();
+          }
+          pos = end + (cdata ? 3 : 2);
+          continue;
+        }
+        if (b.compare(lt, 2, "<!") == 0)
+        { // document type declarations might declare entities, so parse such documents as usual
+          return fail();
+        }
+
+        const bool end_tag = (lt + 1 < n && b[lt + 1] == '/');
+        const Size name_begin = lt + (end_tag ? 2 : 1);
+        Size name_end = name_begin;
+        while (name_end < n && !std::isspace(static_cast<unsigned char>(b[name_end])) && b[name_end] != '/' && b[name_end] != '>')
+        {
+          ++name_end;
+        }
+        // find the end of the tag (attribute values may contain '>')
+        Size tag_end = name_end;
+        char quote = 0;
+        for (; tag_end < n; ++tag_end)
+        {
+          const char c = b[tag_end];
+          if (quote != 0)
+          {
+            if (c == quote) quote = 0;
+          }
+          else if (c == '"' || c == '\'')
+          {
+            quote = c;
+          }
+          else if (c == '>')
+          {
+            break;
+          }
+        }
+        if (tag_end >= n)
+        {
+          return fail();
+        }
+        pos = tag_end + 1;
+        const std::pair<Size, Size> name(name_begin, name_end - name_begin);
+
+        if (end_tag)
+        {
+          if (open_tags.empty() || b.compare(open_tags.back().first, open_tags.back().second, b, name.first, name.second) != 0)
+          { // not well-formed, leave the error reporting to the parser
+            return fail();
+          }
+          if (open_tags.size() == entry_depth)
+          {
+            add_entry(entry_begin, pos);
+            entry_depth = 0;
+          }
+          else if (entry_depth == 0 && is_tag(open_tags.back(), parent_tag))
+          {
+            close_block();
+          }
+          open_tags.pop_back();
+        }
+        else
+        {
+          const bool empty_element = (b[tag_end - 1] == '/');
+          if (open_tags.empty())
+          { // the chunks are parsed without the root element, so they have to declare its namespaces themselves
+            Size attr = name_end;
+            while (attr < tag_end)
+            {
+              while (attr < tag_end && std::isspace(static_cast<unsigned char>(b[attr])))
+              {
+                ++attr;
+              }
+              const Size attr_name_begin = attr;
+              while (attr < tag_end && b[attr] != '=' && !std::isspace(static_cast<unsigned char>(b[attr])))
+              {
+                ++attr;
+              }
+              const Size attr_name_end = attr;
+              while (attr < tag_end && b[attr] != '"' && b[attr] != '\'')
+              {
+                ++attr;
+              }
+              if (attr == tag_end)
+              {
+                break;
+              }
+              const Size value_end = b.find(b[attr], attr + 1);
+              const std::string attr_name = b.substr(attr_name_begin, attr_name_end - attr_name_begin);
+              if (attr_name == "xmlns" || attr_name.compare(0, 6, "xmlns:") == 0)
+              {
+                document.namespaces += " " + b.substr(attr_name_begin, value_end + 1 - attr_name_begin);
+              }
+              attr = value_end + 1;
+            }
+          }
+          if (entry_depth == 0 && !open_tags.empty() && is_tag(open_tags.back(), parent_tag))
+          {
+            if (is_tag(name, entry_tag))
+            {
+              if (empty_element)
+              {
+                add_entry(lt, pos);
+              }
+              else
+              {
+                entry_begin = lt;
+                entry_depth = open_tags.size() + 1;
+              }
+            }
+            else
+            { // other elements between the entries end a block
+              close_block();
+            }
+          }
+          if (!empty_element)
+          {
+            open_tags.push_back(name);
+          }
+        }
+      }
+
+      if (!open_tags.empty() || in_block || document.chunks.size() < 2)
+      {
+        return fail();
+      }
+
+      // replace the blocks by markers
+      Size last = 0;
+      for (Size i = 0; i < blocks.size(); ++i)
+      {
+        document.skeleton.append(b, last, blocks[i].first - last);
+        document.skeleton += String("<?") + SplitDocument::block_marker + " " + String(i) + "?>";
+        last = blocks[i].second;
+      }
+      document.skeleton.append(b, last, std::string::npos);
+      return true;
+    }
+
     void XMLFile::save_(const String & filename, XMLHandler * handler) const
     {
       // open file in binary mode to avoid any line ending conversions
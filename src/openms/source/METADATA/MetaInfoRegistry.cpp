@@ -42,81 +42,71 @@ namespace OpenMS
 {
 
   MetaInfoRegistry::MetaInfoRegistry() :
-    next_index_(1024), 
-    name_to_index_(), 
-    index_to_name_(), 
-    index_to_description_(), 
+    next_index_(1024),
+    entries_(),
+    index_to_description_(),
     index_to_unit_()
   {
-    name_to_index_["isotopic_range"] = 1;
-    index_to_name_[1] = "isotopic_range";
+    clear_();
+
+    insert_("isotopic_range", 1);
     index_to_description_[1] = "consecutive numbering of the peaks in an isotope pattern. 0 is the monoisotopic peak";
     index_to_unit_[1] = "";
 
-    name_to_index_["cluster_id"] = 2;
-    index_to_name_[2] = "cluster_id";
+    insert_("cluster_id", 2);
     index_to_description_[2] = "consecutive numbering of isotope clusters in a spectrum";
     index_to_unit_[2] = "";
 
-    name_to_index_["label"] = 3;
-    index_to_name_[3] = "label";
+    insert_("label", 3);
     index_to_description_[3] = "label e.g. shown in visualization";
     index_to_unit_[3] = "";
 
-    name_to_index_["icon"] = 4;
-    index_to_name_[4] = "icon";
+    insert_("icon", 4);
     index_to_description_[4] = "icon shown in visualization";
     index_to_unit_[4] = "";
 
-    name_to_index_["color"] = 5;
-    index_to_name_[5] = "color";
+    insert_("color", 5);
     index_to_description_[5] = "color used for visualization e.g. #FF00FF for purple";
     index_to_unit_[5] = "";
 
-    name_to_index_["RT"] = 6;
-    index_to_name_[6] = "RT";
+    insert_("RT", 6);
     index_to_description_[6] = "the retention time of an identification";
     index_to_unit_[6] = "";
 
-    name_to_index_["MZ"] = 7;
-    index_to_name_[7] = "MZ";
+    insert_("MZ", 7);
     index_to_description_[7] = "the MZ of an identification";
     index_to_unit_[7] = "";
 
-    name_to_index_["predicted_RT"] = 8;
-    index_to_name_[8] = "predicted_RT";
+    insert_("predicted_RT", 8);
     index_to_description_[8] = "the predicted retention time of a peptide hit";
     index_to_unit_[8] = "";
 
-    name_to_index_["predicted_RT_p_value"] = 9;
-    index_to_name_[9] = "predicted_RT_p_value";
+    insert_("predicted_RT_p_value", 9);
     index_to_description_[9] = "the predicted RT p-value of a peptide hit";
     index_to_unit_[9] = "";
 
-    name_to_index_["spectrum_reference"] = 10;
-    index_to_name_[10] = "spectrum_reference";
+    insert_("spectrum_reference", 10);
     index_to_description_[10] = "Reference to a spectrum or feature number";
     index_to_unit_[10] = "";
 
-    name_to_index_["ID"] = 11;
-    index_to_name_[11] = "ID";
+    insert_("ID", 11);
     index_to_description_[11] = "Some type of identifier";
     index_to_unit_[11] = "";
 
-    name_to_index_["low_quality"] = 12;
-    index_to_name_[12] = "low_quality";
+    insert_("low_quality", 12);
     index_to_description_[12] = "Flag which indicates that some entity has a low quality (e.g. a feature pair)";
     index_to_unit_[12] = "";
 
-    name_to_index_["charge"] = 13;
-    index_to_name_[13] = "charge";
+    insert_("charge", 13);
     index_to_description_[13] = "Charge of a feature or peak";
     index_to_unit_[13] = "";
   }
 
-  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs)
+  MetaInfoRegistry::MetaInfoRegistry(const MetaInfoRegistry& rhs) :
+    next_index_(1024)
   {
-    *this = rhs;
+    clear_();
+    copyFrom_(rhs);
   }
 
   MetaInfoRegistry::~MetaInfoRegistry()
@@ -129,132 +119,215 @@ namespace OpenMS
     {
       return *this;
     }
+    clear_();
+    copyFrom_(rhs);
+    return *this;
+  }
+
+  void MetaInfoRegistry::clear_()
+  {
+    entries_.clear();
+    chunk_storage_.clear();
+    buckets_.reset(new EntryPtr_[bucket_count_]);
+    for (Size i = 0; i < bucket_count_; ++i)
+    {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    chunks_.reset(new std::atomic<EntryPtr_*>[max_chunks_]);
+    for (Size i = 0; i < max_chunks_; ++i)
+    {
+      chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    index_to_description_.clear();
+    index_to_unit_.clear();
+  }
+
+  void MetaInfoRegistry::copyFrom_(const MetaInfoRegistry& rhs)
+  {
 #pragma omp critical (MetaInfoRegistry)
     {
       next_index_ = rhs.next_index_;
-      name_to_index_ = rhs.name_to_index_;
-      index_to_name_ = rhs.index_to_name_;
+      // entries are stored in the order of their registration
+      for (const Entry_& entry : rhs.entries_)
+      {
+        insert_(entry.name, entry.index);
+      }
       index_to_description_ = rhs.index_to_description_;
       index_to_unit_ = rhs.index_to_unit_;
     }
-    return *this;
   }
 
-  UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
+  void MetaInfoRegistry::insert_(const std::string& name, UInt index)
   {
-    UInt rv;
-#pragma omp critical (MetaInfoRegistry)
+    entries_.push_back(Entry_{name, index, nullptr});
+    Entry_& entry = entries_.back();
+
+    // fill the index lookup table (chunks are allocated on demand)
+    EntryPtr_* chunk = chunks_[index / chunk_size_].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
     {
-      MapString2IndexType::iterator it = name_to_index_.find(name);
-      if (it == name_to_index_.end())
+      chunk_storage_.emplace_back(new EntryPtr_[chunk_size_]);
+      chunk = chunk_storage_.back().get();
+      for (Size i = 0; i < chunk_size_; ++i)
       {
-        name_to_index_[name] = next_index_;
-        index_to_name_[next_index_] = name;
-        index_to_description_[next_index_] = description;
-        index_to_unit_[next_index_] = unit;
-        rv = next_index_++;
+        chunk[i].store(nullptr, std::memory_order_relaxed);
       }
-      else
+      chunks_[index / chunk_size_].store(chunk, std::memory_order_release);
+    }
+    chunk[index % chunk_size_].store(&entry, std::memory_order_release);
+
+    // prepend to the bucket list: readers either see the old head or the
+    // fully constructed new entry (which links to the old head)
+    EntryPtr_& bucket = buckets_[std::hash<std::string>()(name) % bucket_count_];
+    entry.next_in_bucket = bucket.load(std::memory_order_relaxed);
+    bucket.store(&entry, std::memory_order_release);
+  }
+
+  UInt MetaInfoRegistry::findIndex_(const std::string& name) const
+  {
+    const Entry_* entry = buckets_[std::hash<std::string>()(name) % bucket_count_].load(std::memory_order_acquire);
+    for (; entry != nullptr; entry = entry->next_in_bucket)
+    {
+      if (entry->name == name)
+      {
+        return entry->index;
+      }
+    }
+    return UInt(-1);
+  }
+
+  const MetaInfoRegistry::Entry_* MetaInfoRegistry::findEntry_(UInt index) const
+  {
+    if (index / chunk_size_ >= max_chunks_)
+    {
+      return nullptr;
+    }
+    const EntryPtr_* chunk = chunks_[index / chunk_size_].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+    {
+      return nullptr;
+    }
+    return chunk[index % chunk_size_].load(std::memory_order_acquire);
+  }
+
+  UInt MetaInfoRegistry::registerName(const String& name, const String& description, const String& unit)
+  {
+    // fast path: names are registered once and looked up many times
+    UInt rv = findIndex_(name);
+    if (rv != UInt(-1))
+    {
+      return rv;
+    }
+    bool overflow = false;
+#pragma omp critical (MetaInfoRegistry)
+    {
+      // check again, another thread may have registered the name in the meantime
+      rv = findIndex_(name);
+      if (rv == UInt(-1))
       {
-        rv = it->second;
+        if (next_index_ / chunk_size_ >= max_chunks_)
+        {
+          overflow = true;
+        }
+        else
+        {
+          rv = next_index_++;
+          index_to_description_[rv] = description;
+          index_to_unit_[rv] = unit;
+          insert_(name, rv);
+        }
       }
     }
+    if (overflow)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, next_index_, chunk_size_ * max_chunks_);
+    }
     return rv;
   }
 
   void MetaInfoRegistry::setDescription(UInt index, const String& description)
   {
-    MapIndex2StringType::iterator pos;
+    bool found = false;
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = index_to_description_.find(index);
+      MapIndex2StringType::iterator pos = index_to_description_.find(index);
       if (pos != index_to_description_.end())
       {
         pos->second = description;
+        found = true;
       }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+    }
+    if (!found)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
   }
 
   void MetaInfoRegistry::setDescription(const String& name, const String& description)
   {
-    MapString2IndexType::iterator pos;
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_description_[pos->second] = description;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      index_to_description_[index] = description;
     }
   }
 
   void MetaInfoRegistry::setUnit(UInt index, const String& unit)
   {
-    MapIndex2StringType::iterator pos;
+    bool found = false;
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = index_to_unit_.find(index);
+      MapIndex2StringType::iterator pos = index_to_unit_.find(index);
       if (pos != index_to_unit_.end())
       {
         pos->second = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+        found = true;
       }
     }
+    if (!found)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+    }
   }
 
   void MetaInfoRegistry::setUnit(const String& name, const String& unit)
   {
-    MapString2IndexType::iterator pos;
+    UInt index = findIndex_(name);
+    if (index == UInt(-1))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
+    }
 #pragma omp critical (MetaInfoRegistry)
     {
-      pos = name_to_index_.find(name);
-      if (pos != name_to_index_.end())
-      {
-        index_to_unit_[pos->second] = unit;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered name!", name);
-      }
+      index_to_unit_[index] = unit;
     }
   }
 
   UInt MetaInfoRegistry::getIndex(const String& name) const
   {
-    UInt rv = UInt(-1);
-#pragma omp critical (MetaInfoRegistry)
-    {
-      MapString2IndexType::const_iterator it = name_to_index_.find(name);
-      if (it != name_to_index_.end())
-      {
-        rv = it->second;
-      }
-    }
-    return rv;
+    return findIndex_(name);
   }
 
   String MetaInfoRegistry::getDescription(UInt index) const
   {
     String result;
+    bool found = false;
 #pragma omp critical (MetaInfoRegistry)
     {
       MapIndex2StringType::const_iterator it = index_to_description_.find(index);
-      if (it == index_to_description_.end())
+      if (it != index_to_description_.end())
       {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+        result = it->second;
+        found = true;
       }
-      result = it->second;
+    }
+    if (!found)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
     return result;
   }
@@ -262,17 +335,14 @@ namespace OpenMS
   String MetaInfoRegistry::getDescription(const String& name) const
   {
     String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
+    UInt index = findIndex_(name);
     if (index == UInt(-1)) // not found
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered Name!", name);
     }
-    else
-    {
 #pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_description_.find(index))->second;
-      }
+    {
+      rv = (index_to_description_.find(index))->second;
     }
     return rv;
   }
@@ -280,14 +350,19 @@ namespace OpenMS
   String MetaInfoRegistry::getUnit(UInt index) const
   {
     String result;
+    bool found = false;
 #pragma omp critical (MetaInfoRegistry)
     {
       MapIndex2StringType::const_iterator it = index_to_unit_.find(index);
-      if (it == index_to_unit_.end())
+      if (it != index_to_unit_.end())
       {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
+        result = it->second;
+        found = true;
       }
-      result = it->second;
+    }
+    if (!found)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
     return result;
   }
@@ -295,37 +370,26 @@ namespace OpenMS
   String MetaInfoRegistry::getUnit(const String& name) const
   {
     String rv;
-    UInt index = getIndex(name); // this has to be outside the OpenMP "critical" block!
+    UInt index = findIndex_(name);
     if (index == UInt(-1)) // not found
     {
       throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered Name!", name);
     }
-    else
-    {
 #pragma omp critical (MetaInfoRegistry)
-      {
-        rv = (index_to_unit_.find(index))->second;
-      }
+    {
+      rv = (index_to_unit_.find(index))->second;
     }
     return rv;
   }
 
   String MetaInfoRegistry::getName(UInt index) const
   {
-    String rv;
-#pragma omp critical (MetaInfoRegistry)
+    const Entry_* entry = findEntry_(index);
+    if (entry == nullptr)
     {
-      MapIndex2StringType::const_iterator it = index_to_name_.find(index);
-      if (it != index_to_name_.end())
-      {
-        rv = it->second;
-      }
-      else
-      {
-        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
-      }
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unregistered index!", String(index));
     }
-    return rv;
+    return entry->name;
   }
 
 } //namespace
@@ -40,6 +40,7 @@
 
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/ChromatogramExtractor.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/DataAccessHelper.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
 #include <OpenMS/ANALYSIS/SVM/SimpleSVM.h>
 #include <OpenMS/ANALYSIS/MAPMATCHING/MapAlignmentAlgorithmIdentification.h>
@@ -53,6 +54,7 @@
 #include <numeric>
 #include <fstream>
 #include <algorithm>
+#include <exception>
 #include <random>
 
 #ifdef _OPENMP
@@ -75,7 +77,7 @@ namespace OpenMS
     defaults_.setMinInt("debug", 0);
 
     defaults_.setValue("extract:batch_size", 5000, "Nr of peptides used in each batch of chromatogram extraction."
-                         " Smaller values decrease memory usage but increase runtime.");
+                         " Smaller values decrease memory usage but increase runtime. Batches are processed in parallel, one per thread.");
     defaults_.setMinInt("extract:batch_size", 1);
     defaults_.setValue("extract:mz_window", 10.0, "m/z window size for chromatogram extraction (unit: ppm if 1 or greater, else Da/Th)");
     defaults_.setMinFloat("extract:mz_window", 0.0);
@@ -305,7 +307,8 @@ namespace OpenMS
     feat_finder_.setLogType(ProgressLogger::NONE);
     feat_finder_.setStrictFlag(false);
     // to use MS1 Swath scores:
-    feat_finder_.setMS1Map(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(boost::make_shared<MSExperiment>(ms_data_)));
+    OpenSwath::SpectrumAccessPtr ms1_map = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(boost::make_shared<MSExperiment>(ms_data_));
+    feat_finder_.setMS1Map(ms1_map);
 
     double rt_uncertainty(0);
     bool with_external_ids = !peptides_ext.empty();
@@ -460,7 +463,7 @@ namespace OpenMS
       OPENMS_LOG_INFO << "Creating full assay library for debugging." << endl;
       // Warning: this step is pretty inefficient, since it does the whole library generation twice
       // Really use for debug only
-      createAssayLibrary_(peptide_map_.begin(), peptide_map_.end(), ref_rt_map, false);
+      createAssayLibrary_(peptide_map_.begin(), peptide_map_.end(), ref_rt_map, library_, isotope_probs_, false);
       cout << "Writing debug.traml file." << endl;
       FileHandler().storeTransitions("debug.traml", library_);
       ref_rt_map.clear();
@@ -472,54 +475,131 @@ namespace OpenMS
     //-------------------------------------------------------------
     //Note: progress only works in non-debug when no logs come in-between
     getProgressLogger().startProgress(0, chunks.size(), "Creating assay library and extracting chromatograms");
+    // Chunks cover disjoint parts of the peptide map and are processed in
+    // parallel, each with its own assay library, chromatograms, feature finder
+    // and ref. RT map. The results are merged in chunk order afterwards.
+    std::vector<FeatureMap> chunk_features(chunks.size());
+    std::vector<PeptideRefRTMap> chunk_ref_rt_maps(chunks.size());
+    std::vector<std::map<String, double> > chunk_isotope_probs(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    // sizes for debug output, which is written after the parallel loop
+    std::vector<Size> chunk_transitions(chunks.size(), 0), chunk_chromatograms(chunks.size(), 0);
     Size chunk_count = 0;
-    for (auto& chunk : chunks)
+
+    // suppress status output from OpenSWATH, unless in debug mode:
+    if (debug_level_ < 1)
+    {
+      OpenMS_Log_info.remove(cout);
+    }
+#pragma omp parallel
     {
-      //TODO since ref_rt_map is only used after chunking, we could create
-      // maps per chunk and merge them in the end. Would help in parallelizing as well.
-      createAssayLibrary_(chunk.first, chunk.second, ref_rt_map);
-      OPENMS_LOG_DEBUG << "#Transitions: " << library_.getTransitions().size() << endl;
+      // picking stores per-assay state, so every thread needs its own feature finder
+      MRMFeatureFinderScoring feat_finder;
+      feat_finder.setParameters(feat_finder_.getParameters());
+      feat_finder.setLogType(ProgressLogger::NONE);
+      feat_finder.setStrictFlag(false);
+      feat_finder.setMS1Map(ms1_map->lightClone());
+      OpenSwath::SpectrumAccessPtr spec_access = spec_temp->lightClone();
+      std::vector<OpenSwath::SwathMap> swath_maps(1);
+      swath_maps[0].sptr = spec_access;
 
-      ChromatogramExtractor extractor;
-      // extractor.setLogType(ProgressLogger::NONE);
+#pragma omp for schedule(dynamic, 1)
+      for (SignedSize chunk_idx = 0; chunk_idx < (SignedSize)chunks.size(); ++chunk_idx)
       {
-        vector<OpenSwath::ChromatogramPtr> chrom_temp;
-        vector<ChromatogramExtractor::ExtractionCoordinates> coords;
-        // take entries in library_ and put to chrom_temp and coords
-        extractor.prepare_coordinates(chrom_temp, coords, library_,
-                                      numeric_limits<double>::quiet_NaN(), false);
+        try
+        {
+          TargetedExperiment library;
+          createAssayLibrary_(chunks[chunk_idx].first, chunks[chunk_idx].second, chunk_ref_rt_maps[chunk_idx],
+                              library, chunk_isotope_probs[chunk_idx]);
+          chunk_transitions[chunk_idx] = library.getTransitions().size();
+
+          boost::shared_ptr<PeakMap> chrom_data = boost::make_shared<PeakMap>();
+          ChromatogramExtractor extractor;
+          // extractor.setLogType(ProgressLogger::NONE);
+          {
+            vector<OpenSwath::ChromatogramPtr> chrom_temp;
+            vector<ChromatogramExtractor::ExtractionCoordinates> coords;
+            // take entries in library and put to chrom_temp and coords
+            extractor.prepare_coordinates(chrom_temp, coords, library,
+                                          numeric_limits<double>::quiet_NaN(), false);
+
+            extractor.extractChromatograms(spec_access, chrom_temp, coords, mz_window_,
+                                           mz_window_ppm_, "tophat");
+            extractor.return_chromatogram(chrom_temp, coords, library, (*shared)[0],
+                                          chrom_data->getChromatograms(), false);
+          }
 
+          chunk_chromatograms[chunk_idx] = chrom_data->getNrChromatograms();
 
-        extractor.extractChromatograms(spec_temp, chrom_temp, coords, mz_window_,
-                                       mz_window_ppm_, "tophat");
-        extractor.return_chromatogram(chrom_temp, coords, library_, (*shared)[0],
-                                      chrom_data_.getChromatograms(), false);
+          // detect chromatographic peaks; use the spectrum access overload directly, so the MS data is not copied for every chunk
+          OpenSwath::LightTargetedExperiment light_library;
+          OpenSwathDataAccessHelper::convertTargetedExp(library, light_library);
+          library.clear(true);
+          MRMFeatureFinderScoring::TransitionGroupMapType transition_group_map;
+          feat_finder.pickExperiment(SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(chrom_data),
+                                     chunk_features[chunk_idx], light_library, TransformationDescription(),
+                                     swath_maps, transition_group_map);
+        }
+        catch (...)
+        {
+          errors[chunk_idx] = std::current_exception();
+        }
+
+        Size chunks_done;
+#pragma omp atomic capture
+        chunks_done = ++chunk_count;
+        IF_MASTERTHREAD
+        {
+          getProgressLogger().setProgress(chunks_done);
+        }
       }
+    }
+    if (debug_level_ < 1)
+    {
+      OpenMS_Log_info.insert(cout); // revert logging change
+    }
 
-      OPENMS_LOG_DEBUG << "Extracted " << chrom_data_.getNrChromatograms()
-                       << " chromatogram(s)." << endl;
+    for (Size chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx)
+    {
+      OPENMS_LOG_DEBUG << "Chunk " << chunk_idx + 1 << ": #Transitions: " << chunk_transitions[chunk_idx]
+                       << ", extracted " << chunk_chromatograms[chunk_idx] << " chromatogram(s)." << endl;
+    }
+
+    // re-throw the first error, as the serial processing would
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
 
-      OPENMS_LOG_DEBUG << "Detecting chromatographic peaks..." << endl;
-      // suppress status output from OpenSWATH, unless in debug mode:
-      if (debug_level_ < 1)
+    for (Size chunk_idx = 0; chunk_idx < chunks.size(); ++chunk_idx)
+    {
+      // since the chromatogram maps are just containers for the chromatograms and identifications will be empty,
+      // pickExperiment above only adds empty ProteinIdentification runs with colliding identifiers.
+      // Usually we could sanitize the identifiers or merge the runs, but since they are empty and we add the
+      // "real" proteins later -> just drop them
+      FeatureMap& current = chunk_features[chunk_idx];
+      features.reserve(features.size() + current.size());
+      for (Feature& feature : current)
       {
-        OpenMS_Log_info.remove(cout);
+        features.push_back(std::move(feature));
       }
-      feat_finder_.pickExperiment(chrom_data_, features, library_,
-                                  TransformationDescription(), ms_data_);
-      if (debug_level_ < 1)
+      current.clear(true);
+
+      for (auto& ref_rts : chunk_ref_rt_maps[chunk_idx])
       {
-        OpenMS_Log_info.insert(cout); // revert logging change
+        std::pair<RTMap, RTMap>& merged = ref_rt_map[ref_rts.first];
+        merged.first.insert(ref_rts.second.first.begin(), ref_rts.second.first.end());
+        merged.second.insert(ref_rts.second.second.begin(), ref_rts.second.second.end());
+      }
+      for (const auto& iso_prob : chunk_isotope_probs[chunk_idx])
+      {
+        isotope_probs_[iso_prob.first] = iso_prob.second;
       }
-      chrom_data_.clear(true);
-      library_.clear(true);
-      // since chrom_data_ here is just a container for the chromatograms and identifications will be empty,
-      // pickExperiment above will only add empty ProteinIdentification runs with colliding identifiers.
-      // Usually we could sanitize the identifiers or merge the runs, but since they are empty and we add the
-      // "real" proteins later -> just clear them
-      features.getProteinIdentifications().clear();
-      getProgressLogger().setProgress(++chunk_count);
     }
+    features.getProteinIdentifications().clear();
     getProgressLogger().endProgress();
 
     OPENMS_LOG_INFO << "Found " << features.size() << " feature candidates in total."
@@ -740,7 +820,8 @@ namespace OpenMS
 
   }
 
-  void FeatureFinderIdentificationAlgorithm::createAssayLibrary_(const PeptideMap::iterator& begin, const PeptideMap::iterator& end, PeptideRefRTMap& ref_rt_map, bool clear_IDs)
+  void FeatureFinderIdentificationAlgorithm::createAssayLibrary_(const PeptideMap::iterator& begin, const PeptideMap::iterator& end, PeptideRefRTMap& ref_rt_map,
+                                                                 TargetedExperiment& library, std::map<String, double>& isotope_probs, bool clear_IDs) const
   {
     std::set<String> protein_accessions;
 
@@ -815,8 +896,8 @@ namespace OpenMS
             peptide.rts.clear();
             addPeptideRT_(peptide, rt - rt_tolerance);
             addPeptideRT_(peptide, rt + rt_tolerance);
-            library_.addPeptide(peptide);
-            generateTransitions_(peptide.id, mz, charge, iso_dist);
+            library.addPeptide(peptide);
+            generateTransitions_(peptide.id, mz, charge, iso_dist, library, isotope_probs);
             internal_ids.emplace(rt_pep);
           }
         }
@@ -895,8 +976,8 @@ namespace OpenMS
               peptide.rts.clear();
               addPeptideRT_(peptide, reg.start);
               addPeptideRT_(peptide, reg.end);
-              library_.addPeptide(peptide);
-              generateTransitions_(peptide.id, mz, charge, iso_dist);
+              library.addPeptide(peptide);
+              generateTransitions_(peptide.id, mz, charge, iso_dist, library, isotope_probs);
             }
             internal_ids.insert(reg.ids[charge].first.begin(),
                                 reg.ids[charge].first.end());
@@ -911,7 +992,7 @@ namespace OpenMS
     {
       TargetedExperiment::Protein protein;
       protein.id = acc;
-      library_.addProtein(protein);
+      library.addProtein(protein);
     }
   }
 
@@ -998,7 +1079,9 @@ namespace OpenMS
     const String& peptide_id, 
     double mz, 
     Int charge,
-    const IsotopeDistribution& iso_dist)
+    const IsotopeDistribution& iso_dist,
+    TargetedExperiment& library,
+    std::map<String, double>& isotope_probs) const
   {
     // go through different isotopes:
     Size counter = 0;
@@ -1016,8 +1099,8 @@ namespace OpenMS
       transition.setPeptideRef(peptide_id);
 
       //TODO what about transition charge? A lot of DIA scores depend on it and default to charge 1 otherwise.
-      library_.addTransition(transition);
-      isotope_probs_[transition_name] = iso.getIntensity();
+      library.addTransition(transition);
+      isotope_probs[transition_name] = iso.getIntensity();
       ++counter;
     }
   }
@@ -41,12 +41,19 @@
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 #include <OpenMS/KERNEL/SpectrumHelper.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
 
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
 namespace OpenMS
 {
+
   PeakPickerHiRes::PeakPickerHiRes() :
     DefaultParamHandler("PeakPickerHiRes"),
     ProgressLogger()
@@ -97,6 +104,18 @@ namespace OpenMS
   }
 
   void PeakPickerHiRes::pick(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    PickScratch_ scratch;
+    pickSpectrum_(input, output, boundaries, check_spacings, scratch);
+  }
+
+  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    PickScratch_ scratch;
+    pickChromatogram_(input, output, boundaries, check_spacings, scratch);
+  }
+
+  void PeakPickerHiRes::pickSpectrum_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, PickScratch_& scratch) const
   {
     // copy meta data of the input spectrum
     copySpectrumMeta(input, output);
@@ -110,10 +129,10 @@ namespace OpenMS
       im_data_index = tmp_index;
     }
 
-    pick_(input, output, boundaries, check_spacings, im_data_index);
+    pick_(input, output, boundaries, scratch, check_spacings, im_data_index);
   }
 
-  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  void PeakPickerHiRes::pickChromatogram_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, PickScratch_& scratch) const
   {
     // copy meta data of the input chromatogram
     output.clear(true);
@@ -121,13 +140,14 @@ namespace OpenMS
     output.MetaInfoInterface::operator=(input);
     output.setName(input.getName());
 
-    pick_(input, output, boundaries, check_spacings);
+    pick_(input, output, boundaries, scratch, check_spacings);
   }
 
   template <typename ContainerType>
   void PeakPickerHiRes::pick_(const ContainerType& input,
                               ContainerType& output,
                               std::vector<PeakBoundary>& boundaries,
+                              PickScratch_& scratch,
                               bool check_spacings,
                               int im_data_index) const
   {
@@ -156,6 +176,13 @@ namespace OpenMS
     {
       return;
     }
+    // a peak has at most as many data points as the input
+    if (scratch.mz.size() < input.size())
+    {
+      scratch.mz.resize(input.size());
+      scratch.intensity.resize(input.size());
+    }
+
     // if both spacing constraints are disabled, don't check spacings at all:
     if ((spacing_difference_ == std::numeric_limits<double>::infinity()) &&
       (spacing_difference_gap_ == std::numeric_limits<double>::infinity()))
@@ -242,13 +269,28 @@ namespace OpenMS
           continue;
         }
 
-        std::map<double, double> peak_raw_data;
+        // the data points of the peak are kept in ascending m/z at the positions
+        // [first, last] of the scratch buffers. The peak is only extended at
+        // its ends, a data point with the m/z of the current end replaces it.
+        Size first(i), last(i);
+        auto add_left = [&scratch, &first](double mz, double intensity)
+        {
+          if (scratch.mz[first] != mz) --first;
+          scratch.mz[first] = mz;
+          scratch.intensity[first] = intensity;
+        };
+        auto add_right = [&scratch, &last](double mz, double intensity)
+        {
+          if (scratch.mz[last] != mz) ++last;
+          scratch.mz[last] = mz;
+          scratch.intensity[last] = intensity;
+        };
+        scratch.mz[i] = central_peak_mz;
+        scratch.intensity[i] = central_peak_int;
+        add_left(left_neighbor_mz, left_neighbor_int);
+        add_right(right_neighbor_mz, right_neighbor_int);
         double weighted_im = 0;
 
-        peak_raw_data[central_peak_mz] = central_peak_int;
-        peak_raw_data[left_neighbor_mz] = left_neighbor_int;
-        peak_raw_data[right_neighbor_mz] = right_neighbor_int;
-
         if (has_im)
         {
           weighted_im += input.getFloatDataArrays()[im_data_index][i] * input[i].getIntensity();
@@ -268,9 +310,9 @@ namespace OpenMS
           (i - k + 1 > 0) && 
           !previous_zero_left && 
           (missing_left <= missing_) && 
-          (input[i - k].getIntensity() <= peak_raw_data.begin()->second) &&
+          (input[i - k].getIntensity() <= scratch.intensity[first]) &&
           (!check_spacings || 
-          (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
+          (scratch.mz[first] - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
         {
           double act_snt_lk = 0.0;
 
@@ -281,9 +323,9 @@ namespace OpenMS
 
           if ((act_snt_lk >= signal_to_noise_) && 
             (!check_spacings ||
-            (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
+            (scratch.mz[first] - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+            add_left(input[i - k].getMZ(), input[i - k].getIntensity());
             if (has_im) weighted_im += input.getFloatDataArrays()[im_data_index][i - k] * input[i - k].getIntensity();
           }
           else
@@ -291,7 +333,7 @@ namespace OpenMS
             ++missing_left;
             if (missing_left <= missing_)
             {
-              peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+              add_left(input[i - k].getMZ(), input[i - k].getIntensity());
               if (has_im) weighted_im += input.getFloatDataArrays()[im_data_index][i - k] * input[i - k].getIntensity();
             }
           }
@@ -311,9 +353,9 @@ namespace OpenMS
         while ((i + k < input.size()) && 
           !previous_zero_right && 
           (missing_right <= missing_) && 
-          (input[i + k].getIntensity() <= peak_raw_data.rbegin()->second) &&
+          (input[i + k].getIntensity() <= scratch.intensity[last]) &&
           (!check_spacings ||
-          (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_gap_ * min_spacing)))
+          (input[i + k].getMZ() - scratch.mz[last] < spacing_difference_gap_ * min_spacing)))
         {
           double act_snt_rk = 0.0;
 
@@ -324,9 +366,9 @@ namespace OpenMS
 
           if ((act_snt_rk >= signal_to_noise_) && 
             (!check_spacings ||
-            (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_ * min_spacing)))
+            (input[i + k].getMZ() - scratch.mz[last] < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+            add_right(input[i + k].getMZ(), input[i + k].getIntensity());
             if (has_im) weighted_im += input.getFloatDataArrays()[im_data_index][i + k] * input[i + k].getIntensity();
           }
           else
@@ -334,7 +376,7 @@ namespace OpenMS
             ++missing_right;
             if (missing_right <= missing_)
             {
-              peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+              add_right(input[i + k].getMZ(), input[i + k].getIntensity());
               if (has_im) weighted_im += input.getFloatDataArrays()[im_data_index][i + k] * input[i + k].getIntensity();
             }
           }
@@ -345,11 +387,13 @@ namespace OpenMS
         }
 
         // skip if the minimal number of 3 points for fitting is not reached
-        if (peak_raw_data.size() < 3)
+        if (last - first + 1 < 3)
         {
           continue;
         }
-        CubicSpline2d peak_spline (peak_raw_data);
+        scratch.peak_mz.assign(scratch.mz.begin() + first, scratch.mz.begin() + last + 1);
+        scratch.peak_int.assign(scratch.intensity.begin() + first, scratch.intensity.begin() + last + 1);
+        CubicSpline2d peak_spline (scratch.peak_mz, scratch.peak_int);
 
         // calculate maximum by evaluating the spline's 1st derivative
         // (bisection method)
@@ -367,7 +411,7 @@ namespace OpenMS
           threshold = 0.01 * fwhm_int;
           double mz_mid, int_mid; 
           // left:
-          double mz_left = peak_raw_data.begin()->first;
+          double mz_left = scratch.peak_mz.front();
           double mz_center = max_peak_mz;
           if (peak_spline.eval(mz_left) > fwhm_int)
           { // the spline ends before half max is reached -- take the leftmost point (probably an underestimation)
@@ -392,7 +436,7 @@ namespace OpenMS
           const double fwhm_left_mz = mz_mid;
 
           // right ...
-          double mz_right = peak_raw_data.rbegin()->first;
+          double mz_right = scratch.peak_mz.back();
           mz_center = max_peak_mz;
           if (peak_spline.eval(mz_right) > fwhm_int)
           { // the spline ends before half max is reached -- take the rightmost point (probably an underestimation)
@@ -424,7 +468,7 @@ namespace OpenMS
         if (has_im)
         {
           double total_intensity(0);
-          for (const auto& t : peak_raw_data) {total_intensity += t.second;}
+          for (const double intensity : scratch.peak_int) {total_intensity += intensity;}
           output.getFloatDataArrays()[out_im_index].push_back(weighted_im / total_intensity);
         }
 
@@ -478,65 +522,114 @@ namespace OpenMS
     Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    // MSLevel -> stats
-    map<int, SpectraPickInfo> pick_info;
-
-    if (input.getNrSpectra() > 0)
+    // spectra and chromatograms are picked in parallel into their final
+    // position, errors and boundaries are collected per spectrum / chromatogram
+    const SignedSize nr_spectra = (SignedSize)input.size();
+    const SignedSize nr_chromatograms = (SignedSize)input.getChromatograms().size();
+    std::vector<char> was_picked(nr_spectra, false);
+    std::vector<std::vector<PeakBoundary> > boundaries_s(nr_spectra); // peak boundaries per spectrum
+    std::vector<std::vector<PeakBoundary> > boundaries_c(nr_chromatograms); // peak boundaries per chromatogram
+    std::vector<MSChromatogram> chromatograms(nr_chromatograms);
+    std::vector<std::exception_ptr> errors(nr_spectra + nr_chromatograms);
+
+#pragma omp parallel
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      PickScratch_ scratch;
+
+#pragma omp for schedule(dynamic, 10) nowait
+      for (SignedSize scan_idx = 0; scan_idx < nr_spectra; ++scan_idx)
       {
-        bool was_picked{false};
-        // auto mode
-        if (ms_levels_.empty()) 
+        try
         {
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID)
+          // auto mode
+          if (ms_levels_.empty()) 
+          {
+            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+            if (spectrum_type == SpectrumSettings::CENTROID)
+            {
+              output[scan_idx] = input[scan_idx];
+            }
+            else
+            {
+              pickSpectrum_(input[scan_idx], output[scan_idx], boundaries_s[scan_idx], true, scratch);
+              was_picked[scan_idx] = true;
+            }
+          }
+          // manual mode
+          else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
           {
             output[scan_idx] = input[scan_idx];
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
+            SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
+            if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+            {
+              throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            }
+
+            pickSpectrum_(input[scan_idx], output[scan_idx], boundaries_s[scan_idx], true, scratch);
+            was_picked[scan_idx] = true;
           }
         }
-        // manual mode
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
+        catch (...)
         {
-          output[scan_idx] = input[scan_idx];
+          errors[scan_idx] = std::current_exception();
         }
-        else
+
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
-          {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
-          }
+          setProgress(progress);
+        }
+      }
 
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
+#pragma omp for schedule(dynamic, 10)
+      for (SignedSize i = 0; i < nr_chromatograms; ++i)
+      {
+        try
+        {
+          pickChromatogram_(input.getChromatograms()[i], chromatograms[i], boundaries_c[i], false, scratch);
+        }
+        catch (...)
+        {
+          errors[nr_spectra + i] = std::current_exception();
+        }
+
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
+        {
+          setProgress(progress);
         }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
       }
     }
+    endProgress();
 
+    // re-throw the first error, as the serial picking would
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    // MSLevel -> stats
+    map<int, SpectraPickInfo> pick_info;
+    for (SignedSize scan_idx = 0; scan_idx < nr_spectra; ++scan_idx)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      if (was_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(boundaries_s[scan_idx]));
+      }
+      pick_info[input[scan_idx].getMSLevel()].picked += was_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
     }
-    endProgress();
+
+    output.setChromatograms(std::move(chromatograms));
+    boundaries_chrom.insert(boundaries_chrom.end(), std::make_move_iterator(boundaries_c.begin()), std::make_move_iterator(boundaries_c.end()));
 
     OPENMS_LOG_INFO << "Picked spectra by MS-level:\n";
     for (const auto& info : pick_info)
@@ -547,6 +640,44 @@ namespace OpenMS
     return;
   }
 
+  bool PeakPickerHiRes::pickOnDiscSpectrum_(/* const */ OnDiscMSExperiment& input, Size scan_idx, MSSpectrum& output, const bool check_spectrum_type, PickScratch_& scratch) const
+  {
+    MSSpectrum s = input[scan_idx];
+    std::vector<PeakBoundary> boundaries;
+
+    if (ms_levels_.empty()) //auto mode
+    {
+      // determine type of spectral data (profile or centroided)
+      SpectrumSettings::SpectrumType spectrum_type = s.getType();
+      if (spectrum_type == SpectrumSettings::CENTROID)
+      {
+        output = std::move(s);
+        return false;
+      }
+      s.sortByPosition();
+      pickSpectrum_(s, output, boundaries, true, scratch);
+      return true;
+    }
+    else if (!ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
+    {
+      output = std::move(s);
+      return false;
+    }
+
+    s.sortByPosition();
+
+    // determine type of spectral data (profile or centroided)
+    SpectrumSettings::SpectrumType spectrum_type = s.getType();
+
+    if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+    }
+
+    pickSpectrum_(s, output, boundaries, true, scratch);
+    return true;
+  }
+
   void PeakPickerHiRes::pickExperiment(/* const */ OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type) const
   {
     // make sure that output is clear
@@ -561,59 +692,143 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    if (input.getNrSpectra() > 0)
+    // concurrent reads are only safe if the file is memory-mapped
+    const bool parallel = input.isMemoryMapped();
+    const SignedSize nr_spectra = (SignedSize)input.size();
+    const SignedSize nr_chromatograms = (SignedSize)input.getNrChromatograms();
+    std::vector<MSChromatogram> chromatograms(nr_chromatograms);
+    std::vector<std::exception_ptr> errors(nr_spectra + nr_chromatograms);
+
+#pragma omp parallel if (parallel)
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      PickScratch_ scratch;
+      std::vector<PeakBoundary> boundaries;
+
+#pragma omp for schedule(dynamic, 10) nowait
+      for (SignedSize scan_idx = 0; scan_idx < nr_spectra; ++scan_idx)
       {
-        if (ms_levels_.empty()) //auto mode
+        try
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
+          pickOnDiscSpectrum_(input, scan_idx, output[scan_idx], check_spectrum_type, scratch);
+        }
+        catch (...)
+        {
+          errors[scan_idx] = std::current_exception();
+        }
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
-          {
-            output[scan_idx] = input[scan_idx];
-          }
-          else
-          {
-            pick(s, output[scan_idx]);
-          }
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
+        {
+          setProgress(progress);
         }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+      }
+
+#pragma omp for schedule(dynamic, 10)
+      for (SignedSize i = 0; i < nr_chromatograms; ++i)
+      {
+        try
+        {
+          boundaries.clear();
+          pickChromatogram_(input.getChromatogram(i), chromatograms[i], boundaries, false, scratch);
+        }
+        catch (...)
         {
-          output[scan_idx] = input[scan_idx];
+          errors[nr_spectra + i] = std::current_exception();
         }
-        else
+
+#pragma omp atomic
+        ++progress;
+        IF_MASTERTHREAD
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
+          setProgress(progress);
+        }
+      }
+    }
+    endProgress();
+
+    // re-throw the first error, as the serial picking would
+    for (const auto& error : errors)
+    {
+      if (error)
+      {
+        std::rethrow_exception(error);
+      }
+    }
+
+    output.setChromatograms(std::move(chromatograms));
+
+    return;
+  }
+
+  void PeakPickerHiRes::pickExperiment(/* const */ OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& consumer, const bool check_spectrum_type) const
+  {
+    consumer.setExperimentalSettings(*input.getExperimentalSettings());
+    consumer.setExpectedSize(input.getNrSpectra(), input.getNrChromatograms());
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
+    Size progress = 0;
+    startProgress(0, input.size() + input.getNrChromatograms(), "picking peaks");
 
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+    // concurrent reads are only safe if the file is memory-mapped
+    const bool parallel = input.isMemoryMapped();
+    Size block_size = 1;
+#ifdef _OPENMP
+    if (parallel)
+    {
+      // a few spectra per thread, so only a small part of the data is held in memory at a time
+      block_size = 16 * omp_get_max_threads();
+    }
+#endif
+
+    std::vector<MSSpectrum> spectra;
+    std::vector<std::exception_ptr> errors;
+    for (Size block_begin = 0; block_begin < input.getNrSpectra(); block_begin += block_size)
+    {
+      const SignedSize current_block_size = (SignedSize)std::min(block_size, input.getNrSpectra() - block_begin);
+      spectra.assign(current_block_size, MSSpectrum());
+      errors.assign(current_block_size, nullptr);
+
+#pragma omp parallel if (parallel)
+      {
+        PickScratch_ scratch;
+
+#pragma omp for schedule(dynamic, 1)
+        for (SignedSize k = 0; k < current_block_size; ++k)
+        {
+          try
+          {
+            pickOnDiscSpectrum_(input, block_begin + k, spectra[k], check_spectrum_type, scratch);
+          }
+          catch (...)
           {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            errors[k] = std::current_exception();
           }
+        }
+      }
 
-          pick(s, output[scan_idx]);
+      // hand the spectra to the consumer in input order
+      for (SignedSize k = 0; k < current_block_size; ++k)
+      {
+        if (errors[k])
+        {
+          std::rethrow_exception(errors[k]);
         }
+        consumer.consumeSpectrum(spectra[k]);
         setProgress(++progress);
       }
     }
 
+    PickScratch_ scratch;
+    std::vector<PeakBoundary> boundaries;
     for (Size i = 0; i < input.getNrChromatograms(); ++i)
     {
       MSChromatogram chromatogram;
-      pick(input.getChromatogram(i), chromatogram);
-      output.addChromatogram(chromatogram);
+      boundaries.clear();
+      pickChromatogram_(input.getChromatogram(i), chromatogram, boundaries, false, scratch);
+      consumer.consumeChromatogram(chromatogram);
       setProgress(++progress);
     }
     endProgress();
-
-    return;
   }
 
   void PeakPickerHiRes::updateMembers_()
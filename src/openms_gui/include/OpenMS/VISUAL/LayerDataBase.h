@@ -51,11 +51,15 @@
 #include <OpenMS/VISUAL/ANNOTATION/Annotations1DContainer.h>
 //#include <OpenMS/VISUAL/Painter1DBase.h>
 #include <OpenMS/VISUAL/LogWindow.h>
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
 #include <OpenMS/VISUAL/MultiGradient.h>
 
 #include <boost/shared_ptr.hpp>
 
+#include <atomic>
 #include <bitset>
+#include <future>
+#include <memory>
 #include <vector>
 
 class QWidget;
@@ -143,6 +147,9 @@ namespace OpenMS
     /// Label names
     static const std::string NamesOfLabelType[SIZE_OF_LABEL_TYPE];
 
+    /// Minimum number of peaks for which getPeakPyramid() builds a pyramid
+    static constexpr Size MIN_PYRAMID_PEAKS = 1000000;
+
     /// Features
     typedef FeatureMap FeatureMapType;
 
@@ -183,8 +190,8 @@ namespace OpenMS
     LayerDataBase(LayerDataBase&& ld) = default;
     /// move assignment
     LayerDataBase& operator=(LayerDataBase&& ld) = default;
-    /// D'tor
-    virtual ~LayerDataBase() = default;
+    /// D'tor (cancels a running build of the peak pyramid)
+    virtual ~LayerDataBase();
 
     virtual std::unique_ptr<Painter1DBase> getPainter1D() const = 0;
 
@@ -235,6 +242,7 @@ namespace OpenMS
     */
     const ExperimentSharedPtrType& getPeakDataMuteable()
     {
+      resetPeakPyramid_(); // the data may be changed
       return peak_map_;
     }
 
@@ -243,10 +251,23 @@ namespace OpenMS
     */
     void setPeakData(ExperimentSharedPtrType p)
     {
+      resetPeakPyramid_();
       peak_map_ = p;
       updateCache_();
     }
 
+    /**
+    @brief Returns the maximum intensity pyramid of the in-memory peak data (for painting zoomed-out 2D views)
+
+    The pyramid is built in a background thread, which is started by the first call
+    (and by the first call after the peak data was accessed via getPeakDataMuteable()
+    or replaced). Until the pyramid is ready, a null pointer is returned.
+
+    Maps with fewer than MIN_PYRAMID_PEAKS peaks are cheap to paint directly, so
+    no pyramid is built for them and a null pointer is returned as well.
+    */
+    const MaxIntensityPyramid* getPeakPyramid() const;
+
     /// Set the current on-disc data
     void setOnDiscPeakData(ODExperimentSharedPtrType p)
     {
@@ -499,6 +520,9 @@ namespace OpenMS
     /// Update current cached spectrum for easy retrieval
     void updateCache_();
 
+    /// Discards the maximum intensity pyramid (cancels a running build and waits until it has stopped)
+    void resetPeakPyramid_();
+
     /// updates the PeakAnnotations in the current PeptideHit with manually changed annotations
     void updatePeptideHitAnnotations_(PeptideHit& hit);
 
@@ -511,6 +535,12 @@ namespace OpenMS
     /// peak data
     ExperimentSharedPtrType peak_map_ = ExperimentSharedPtrType(new ExperimentType());
 
+    /// maximum intensity pyramid of peak_map_ (built on demand in the background, see getPeakPyramid())
+    mutable std::shared_future<std::shared_ptr<const MaxIntensityPyramid> > peak_pyramid_;
+
+    /// set to abort the background build of peak_pyramid_
+    mutable std::shared_ptr<std::atomic<bool> > peak_pyramid_cancel_;
+
     /// on disc peak data
     ODExperimentSharedPtrType on_disc_peaks = ODExperimentSharedPtrType(new OnDiscMSExperiment());
 
@@ -0,0 +1,141 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+// OpenMS_GUI config
+#include <OpenMS/VISUAL/OpenMS_GUIConfig.h>
+
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/KERNEL/StandardTypes.h>
+
+#include <atomic>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+      @brief Multi-resolution grid of the maximum MS1 peak intensities of a peak map
+
+      The finest level bins the RT x m/z range of all MS1 peaks into a grid of at
+      most @p max_bins x @p max_bins bins (fewer in RT if there are fewer MS1
+      spectra) and stores the highest intensity of each bin. Every following
+      level merges 2 x 2 bins of the previous one, until the grid is small.
+
+      The 2D view uses the pyramid to paint zoomed-out views of large maps
+      without visiting every peak: each pixel is colored by the maximum of the
+      bins whose centers fall inside of it. Only once the bins of the finest
+      level are larger than a pixel, the peaks are visited directly.
+
+      @ingroup Visual
+  */
+  class OPENMS_GUI_DLLAPI MaxIntensityPyramid
+  {
+public:
+    /// One level of the pyramid: a grid of RT (rows) x m/z (columns) bins
+    struct Level
+    {
+      Size rt_bins = 0;
+      Size mz_bins = 0;
+      double rt_bin_size = 0.0;
+      double mz_bin_size = 0.0;
+      /// maximum intensity of each bin (row-major), negative for bins without peaks
+      std::vector<float> intensities;
+
+      /// Returns the maximum intensity of a bin (negative if the bin has no peaks)
+      float getMaxIntensity(Size rt_bin, Size mz_bin) const
+      {
+        return intensities[rt_bin * mz_bins + mz_bin];
+      }
+    };
+
+    /// Default constructor (empty pyramid)
+    MaxIntensityPyramid() = default;
+
+    /**
+        @brief Builds the pyramid from the MS1 spectra of @p map
+
+        @param map The peak map
+        @param max_bins Maximum number of bins per dimension of the finest level
+        @param min_bins Levels are added until neither dimension has more bins than this
+        @param cancel If given, the build is aborted as soon as this flag is set (e.g. from another thread); the pyramid is empty then
+    */
+    explicit MaxIntensityPyramid(const PeakMap& map, Size max_bins = 2048, Size min_bins = 64, const std::atomic<bool>* cancel = nullptr);
+
+    /// Returns if the pyramid contains no levels (i.e. the map had no MS1 peaks)
+    bool empty() const
+    {
+      return levels_.empty();
+    }
+
+    /// Returns the number of levels
+    Size getNumberOfLevels() const
+    {
+      return levels_.size();
+    }
+
+    /// Returns a level (0 is the finest one)
+    const Level& getLevel(Size index) const
+    {
+      return levels_[index];
+    }
+
+    /// Returns the lower RT bound of the first bin
+    double getRTMin() const
+    {
+      return rt_min_;
+    }
+
+    /// Returns the lower m/z bound of the first bin
+    double getMZMin() const
+    {
+      return mz_min_;
+    }
+
+    /**
+        @brief Returns the coarsest level whose bins are not larger than @p rt_size x @p mz_size
+
+        Returns a null pointer if even the bins of the finest level are larger,
+        i.e. if the peaks have to be visited directly.
+    */
+    const Level* findLevel(double rt_size, double mz_size) const;
+
+private:
+    double rt_min_ = 0.0;
+    double mz_min_ = 0.0;
+    std::vector<Level> levels_;
+  };
+
+} // namespace OpenMS
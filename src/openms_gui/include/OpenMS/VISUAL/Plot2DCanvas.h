@@ -40,6 +40,7 @@
 // OpenMS
 #include <OpenMS/VISUAL/PlotCanvas.h>
 #include <OpenMS/VISUAL/Plot1DCanvas.h>
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
 #include <OpenMS/KERNEL/PeakIndex.h>
 
 // QT
@@ -185,6 +186,10 @@ protected:
       Paints the peaks as small ellipses. The peaks are colored according to the
       selected dot gradient.
 
+      If no data filters are active and the layer's maximum intensity pyramid is
+      available at a resolution of at least one bin per pixel, the pyramid is
+      painted instead of visiting every peak (see paintMaximumIntensityPyramid_()).
+
       @param layer_index The index of the layer.
       @param rt_pixel_count
       @param mz_pixel_count
@@ -192,6 +197,15 @@ protected:
     */
     void paintMaximumIntensities_(Size layer_index, Size rt_pixel_count, Size mz_pixel_count, QPainter& p);
 
+    /**
+      @brief Paints the maximum intensities of a level of a MaxIntensityPyramid.
+
+      Each pixel shows the maximum of the bins whose centers fall inside of it.
+      The bins of @p level must not be larger than a pixel.
+    */
+    void paintMaximumIntensityPyramid_(Size layer_index, const MaxIntensityPyramid& pyramid, const MaxIntensityPyramid::Level& level,
+                                       Size rt_pixel_count, Size mz_pixel_count);
+
     /**
       @brief Paints the precursor peaks.
 
@@ -26,6 +26,7 @@ LayerDataIdent.h
 LayerDataPeak.h
 ListEditor.h
 LogWindow.h
+MaxIntensityPyramid.h
 MetaDataBrowser.h
 MultiGradient.h
 MultiGradientSelector.h
@@ -70,6 +70,62 @@ namespace OpenMS
     return boost::static_pointer_cast<const ExperimentType>(peak_map_);
   }
 
+  LayerDataBase::~LayerDataBase()
+  {
+    // the future returned by std::async blocks on destruction until the build is done, so stop it early
+    if (peak_pyramid_cancel_)
+    {
+      *peak_pyramid_cancel_ = true;
+    }
+  }
+
+  const MaxIntensityPyramid* LayerDataBase::getPeakPyramid() const
+  {
+    if (!peak_pyramid_.valid())
+    {
+      if (peak_map_->getSize() < MIN_PYRAMID_PEAKS)
+      { // painting all peaks is fast enough
+        return nullptr;
+      }
+      // the copies of the shared pointers keep the data and the flag alive while building
+      ConstExperimentSharedPtrType data = getPeakData();
+      peak_pyramid_cancel_ = std::make_shared<std::atomic<bool> >(false);
+      std::shared_ptr<const std::atomic<bool> > cancel = peak_pyramid_cancel_;
+      peak_pyramid_ = std::async(std::launch::async, [data, cancel]()
+      {
+        try
+        {
+          auto pyramid = std::make_shared<const MaxIntensityPyramid>(*data, 2048, 64, cancel.get());
+          if (*cancel)
+          {
+            return std::shared_ptr<const MaxIntensityPyramid>();
+          }
+          return pyramid;
+        }
+        catch (std::bad_alloc&)
+        { // not fatal, peaks are painted directly then
+          return std::shared_ptr<const MaxIntensityPyramid>();
+        }
+      }).share();
+    }
+    if (peak_pyramid_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      return nullptr;
+    }
+    return peak_pyramid_.get().get();
+  }
+
+  void LayerDataBase::resetPeakPyramid_()
+  {
+    if (peak_pyramid_.valid())
+    {
+      *peak_pyramid_cancel_ = true;
+      peak_pyramid_.wait(); // the background thread must not read data which is about to be changed
+      peak_pyramid_ = std::shared_future<std::shared_ptr<const MaxIntensityPyramid> >();
+      peak_pyramid_cancel_.reset();
+    }
+  }
+
   /// get name augmented with attributes, e.g. [flipped], or '*' if modified
   String LayerDataBase::getDecoratedName() const
   {
@@ -0,0 +1,173 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
+
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    Size binIndex(double value, double first, double bin_size, Size bins)
+    {
+      double index = floor((value - first) / bin_size);
+      if (index < 0.0)
+      {
+        return 0;
+      }
+      return std::min((Size)index, bins - 1);
+    }
+  }
+
+  MaxIntensityPyramid::MaxIntensityPyramid(const PeakMap& map, Size max_bins, Size min_bins, const std::atomic<bool>* cancel)
+  {
+    auto cancelled = [cancel]() { return cancel != nullptr && cancel->load(std::memory_order_relaxed); };
+
+    max_bins = std::max(max_bins, Size(1));
+    min_bins = std::max(min_bins, Size(1));
+
+    // extent of all MS1 peaks
+    Size n_ms1 = 0;
+    double rt_max = -numeric_limits<double>::max();
+    double mz_max = -numeric_limits<double>::max();
+    rt_min_ = numeric_limits<double>::max();
+    mz_min_ = numeric_limits<double>::max();
+    for (const MSSpectrum& spec : map)
+    {
+      if (cancelled())
+      {
+        n_ms1 = 0;
+        break;
+      }
+      if (spec.getMSLevel() != 1 || spec.empty())
+      {
+        continue;
+      }
+      ++n_ms1;
+      rt_min_ = std::min(rt_min_, spec.getRT());
+      rt_max = std::max(rt_max, spec.getRT());
+      for (const Peak1D& p : spec)
+      {
+        mz_min_ = std::min(mz_min_, (double)p.getMZ());
+        mz_max = std::max(mz_max, (double)p.getMZ());
+      }
+    }
+    if (n_ms1 == 0)
+    {
+      rt_min_ = 0.0;
+      mz_min_ = 0.0;
+      return;
+    }
+
+    // finest level: bin the peaks directly
+    Level finest;
+    finest.rt_bins = std::min(n_ms1, max_bins);
+    finest.mz_bins = max_bins;
+    finest.rt_bin_size = (rt_max > rt_min_) ? (rt_max - rt_min_) / finest.rt_bins : 1.0;
+    finest.mz_bin_size = (mz_max > mz_min_) ? (mz_max - mz_min_) / finest.mz_bins : 1.0;
+    finest.intensities.assign(finest.rt_bins * finest.mz_bins, -1.0f);
+    for (const MSSpectrum& spec : map)
+    {
+      if (cancelled())
+      {
+        return;
+      }
+      if (spec.getMSLevel() != 1 || spec.empty())
+      {
+        continue;
+      }
+      float* row = &finest.intensities[binIndex(spec.getRT(), rt_min_, finest.rt_bin_size, finest.rt_bins) * finest.mz_bins];
+      for (const Peak1D& p : spec)
+      {
+        float& bin = row[binIndex(p.getMZ(), mz_min_, finest.mz_bin_size, finest.mz_bins)];
+        if (p.getIntensity() > bin)
+        {
+          bin = p.getIntensity();
+        }
+      }
+    }
+    levels_.push_back(std::move(finest));
+
+    // coarser levels: merge 2 x 2 bins of the previous level
+    while (levels_.back().rt_bins > min_bins || levels_.back().mz_bins > min_bins)
+    {
+      if (cancelled())
+      {
+        levels_.clear();
+        return;
+      }
+      const Level& fine = levels_.back();
+      Level coarse;
+      coarse.rt_bins = (fine.rt_bins + 1) / 2;
+      coarse.mz_bins = (fine.mz_bins + 1) / 2;
+      // a dimension with a single bin already covers the whole range
+      coarse.rt_bin_size = (fine.rt_bins > 1) ? 2.0 * fine.rt_bin_size : fine.rt_bin_size;
+      coarse.mz_bin_size = (fine.mz_bins > 1) ? 2.0 * fine.mz_bin_size : fine.mz_bin_size;
+      coarse.intensities.assign(coarse.rt_bins * coarse.mz_bins, -1.0f);
+      for (Size rt = 0; rt < fine.rt_bins; ++rt)
+      {
+        float* coarse_row = &coarse.intensities[(rt / 2) * coarse.mz_bins];
+        for (Size mz = 0; mz < fine.mz_bins; ++mz)
+        {
+          coarse_row[mz / 2] = std::max(coarse_row[mz / 2], fine.getMaxIntensity(rt, mz));
+        }
+      }
+      levels_.push_back(std::move(coarse));
+    }
+  }
+
+  const MaxIntensityPyramid::Level* MaxIntensityPyramid::findLevel(double rt_size, double mz_size) const
+  {
+    const Level* result = nullptr;
+    for (const Level& level : levels_)
+    {
+      // levels get coarser with the index, so the last fitting one is the coarsest
+      if (level.rt_bin_size > rt_size || level.mz_bin_size > mz_size)
+      {
+        break;
+      }
+      result = &level;
+    }
+    return result;
+  }
+
+} // namespace OpenMS
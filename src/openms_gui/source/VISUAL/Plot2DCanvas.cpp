@@ -632,6 +632,18 @@ namespace OpenMS
     double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
     double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
 
+    // use the precomputed maxima if they are fine enough (they do not know about filters)
+    const MaxIntensityPyramid* pyramid = layer.filters.isActive() ? nullptr : layer.getPeakPyramid();
+    if (pyramid != nullptr)
+    {
+      const MaxIntensityPyramid::Level* level = pyramid->findLevel(rt_step_size, mz_step_size);
+      if (level != nullptr)
+      {
+        paintMaximumIntensityPyramid_(layer_index, *pyramid, *level, rt_pixel_count, mz_pixel_count);
+        return;
+      }
+    }
+
     // start at first visible RT scan
     Size scan_index = std::distance(map.begin(), map.RTBegin(rt_min));
     //iterate over all pixels (RT dimension)
@@ -708,6 +720,73 @@ namespace OpenMS
     }
   }
 
+  void Plot2DCanvas::paintMaximumIntensityPyramid_(Size layer_index, const MaxIntensityPyramid& pyramid, const MaxIntensityPyramid::Level& level,
+                                                   Size rt_pixel_count, Size mz_pixel_count)
+  {
+    Int image_width = buffer_.width();
+    Int image_height = buffer_.height();
+
+    const LayerDataBase& layer = getLayer(layer_index);
+    const double rt_min = visible_area_.minPosition()[1];
+    const double rt_max = visible_area_.maxPosition()[1];
+    const double mz_min = visible_area_.minPosition()[0];
+    const double mz_max = visible_area_.maxPosition()[0];
+
+    double snap_factor = snap_factors_[layer_index];
+
+    //calculate pixel size in data coordinates
+    double rt_step_size = (rt_max - rt_min) / rt_pixel_count;
+    double mz_step_size = (mz_max - mz_min) / mz_pixel_count;
+
+    // index of the first bin whose center is not smaller than 'pos'
+    auto firstBin = [](double pos, double first, double bin_size, Size bins) -> Size
+    {
+      double index = ceil((pos - first) / bin_size - 0.5);
+      return (Size)std::min(std::max(index, 0.0), (double)bins);
+    };
+
+    // the m/z bins of each pixel are the same for all RT pixels
+    vector<Size> mz_bin_begin(mz_pixel_count + 1);
+    for (Size mz = 0; mz <= mz_pixel_count; ++mz)
+    {
+      mz_bin_begin[mz] = firstBin(mz_min + mz_step_size * mz, pyramid.getMZMin(), level.mz_bin_size, level.mz_bins);
+    }
+
+    for (Size rt = 0; rt < rt_pixel_count; ++rt)
+    {
+      double rt_start = rt_min + rt_step_size * rt;
+      Size rt_bin_begin = firstBin(rt_start, pyramid.getRTMin(), level.rt_bin_size, level.rt_bins);
+      Size rt_bin_end = firstBin(rt_start + rt_step_size, pyramid.getRTMin(), level.rt_bin_size, level.rt_bins);
+      if (rt_bin_begin == rt_bin_end)
+      {
+        continue;
+      }
+      for (Size mz = 0; mz < mz_pixel_count; ++mz)
+      {
+        float max = -1.0;
+        for (Size rt_bin = rt_bin_begin; rt_bin < rt_bin_end; ++rt_bin)
+        {
+          for (Size mz_bin = mz_bin_begin[mz]; mz_bin < mz_bin_begin[mz + 1]; ++mz_bin)
+          {
+            max = std::max(max, level.getMaxIntensity(rt_bin, mz_bin));
+          }
+        }
+
+        //draw to buffer
+        if (max >= 0.0)
+        {
+          double mz_start = mz_min + mz_step_size * mz;
+          QPoint pos;
+          dataToWidget_(mz_start + 0.5 * mz_step_size, rt_start + 0.5 * rt_step_size, pos);
+          if (pos.y() < image_height && pos.x() < image_width)
+          {
+            buffer_.setPixel(pos.x(), pos.y(), heightColor_(max, layer.gradient, snap_factor).rgb());
+          }
+        }
+      }
+    }
+  }
+
   void Plot2DCanvas::paintFeatureData_(Size layer_index, QPainter& painter)
   {
     const LayerDataBase& layer = getLayer(layer_index);
@@ -1224,6 +1303,10 @@ namespace OpenMS
       popIncompleteLayer_("Cannot add a dataset that contains no survey scans. Aborting!");
       return false;
     }
+    if (layer.type == LayerDataBase::DT_PEAK)
+    { // start building the maximum intensity pyramid of large maps in the background (used for zoomed-out views)
+      layer.getPeakPyramid();
+    }
     update_buffer_ = true;
 
     // overall values update
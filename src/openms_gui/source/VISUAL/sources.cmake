@@ -29,6 +29,7 @@ LayerDataIdent.cpp
 LayerDataPeak.cpp
 ListEditor.cpp
 LogWindow.cpp
+MaxIntensityPyramid.cpp
 MetaDataBrowser.cpp
 MultiGradient.cpp
 MultiGradientSelector.cpp
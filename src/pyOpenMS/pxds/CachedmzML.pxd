@@ -1,3 +1,4 @@
+from libcpp cimport bool
 from MSExperiment  cimport *
 from MSSpectrum  cimport *
 from ChromatogramPeak cimport *
@@ -25,6 +26,8 @@ cdef extern from "<OpenMS/FORMAT/CachedMzML.h>" namespace "OpenMS":
         # COMMENT: useful for filtering by attributes to then retrieve data
         MSExperiment getMetaData() nogil except +
 
+        bool isMemoryMapped() nogil except + # wrap-doc:Whether the data is read from a memory-mapped file (otherwise from a file stream)
+
 # COMMENT: wrap static methods
 cdef extern from "<OpenMS/FORMAT/CachedMzML.h>" namespace "OpenMS::CachedmzML":
     
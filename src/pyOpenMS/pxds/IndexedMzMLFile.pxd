@@ -17,6 +17,7 @@ cdef extern from "<OpenMS/FORMAT/HANDLERS/IndexedMzMLHandler.h>" namespace "Open
 
         void openFile(String filename) nogil except +
         bool getParsingSuccess() nogil except +
+        bool isMemoryMapped() nogil except +
 
         size_t getNrSpectra() nogil except +
         size_t getNrChromatograms() nogil except +
@@ -61,6 +61,17 @@ cdef extern from "<OpenMS/FORMAT/HANDLERS/MzMLSqliteHandler.h>" namespace "OpenM
                 #   :param deltaRT: Tolerance window around RT (if less or equal than zero, only the first spectrum *after* RT is returned)
                 #   :param indices: Spectra to consider (if empty, all spectra are considered)
                 #   :returns: The indices of the spectra within RT +/- deltaRT
+
+        libcpp_vector[int] getSpectraIndicesByRange(double rt_start, double rt_end, int ms_level, double precursor_mz_start, double precursor_mz_end) nogil except +
+            # wrap-doc:
+                #   Returns the indices of all spectra within a retention time range and/or precursor isolation window (evaluated on indexed columns by the database)
+                #   -----
+                #   :param rt_start: Start of the retention time range
+                #   :param rt_end: End of the retention time range (if smaller than rt_start, retention time is not restricted)
+                #   :param ms_level: Only consider spectra of this MS level (if zero, all spectra are considered)
+                #   :param precursor_mz_start: Lower bound for the precursor isolation target
+                #   :param precursor_mz_end: Upper bound for the precursor isolation target (if smaller than precursor_mz_start, the precursor is not restricted)
+                #   :returns: The indices of the matching spectra in ascending order
   
         void writeExperiment(MSExperiment exp) nogil except + # wrap-doc:Write an MSExperiment to disk
   
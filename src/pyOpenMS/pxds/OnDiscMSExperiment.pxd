@@ -24,6 +24,7 @@ cdef extern from "<OpenMS/KERNEL/OnDiscMSExperiment.h>" namespace "OpenMS":
 
         Size getNrSpectra() nogil except + # wrap-doc:Returns the total number of spectra available
         Size getNrChromatograms() nogil except + # wrap-doc:Returns the total number of chromatograms available
+        bool isMemoryMapped() nogil except + # wrap-doc:Returns whether the data is read from a memory-mapped file (concurrent access by index is then safe)
 
         # COMMENT: only retrieves experiment meta data (no actual data in spectra/chromatograms)
         # COMMENT: useful for filtering by attributes to then retrieve data
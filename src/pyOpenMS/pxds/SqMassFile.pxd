@@ -31,3 +31,4 @@ cdef extern from "<OpenMS/FORMAT/SqMassFile.h>" namespace "OpenMS::SqMassFile":
         bool write_full_meta
         bool use_lossy_numpress
         double linear_fp_mass_acc
+        bool durable_write
@@ -101,6 +101,13 @@ START_SECTION([EXTRA]AdductInfo)
     double neutral_mass_recon = ai.getNeutralMass(mz);
     TEST_REAL_SIMILAR(neutral_mass, neutral_mass_recon);
   }
+  { // testing M-H2O+H;+1: the compound must be able to lose the water
+    AdductInfo ai("TEST_LOSS", EmpiricalFormula("H-1O-1"), 1, 1);
+    TEST_EQUAL(ai.isCompatible(EmpiricalFormula("C6H12O6")), true)
+    TEST_EQUAL(ai.isCompatible(EmpiricalFormula("H2O")), true)
+    TEST_EQUAL(ai.isCompatible(EmpiricalFormula("C6H6")), false)
+    TEST_EQUAL(ai.isCompatible(EmpiricalFormula("CO2")), false)
+  }
 
 }
 END_SECTION
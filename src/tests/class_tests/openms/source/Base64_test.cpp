@@ -258,7 +258,109 @@ START_SECTION([EXTRA] zlib functionality)
 
   TEST_REAL_SIMILAR(data[0], 300.15f)
   TEST_REAL_SIMILAR(data[1], 303.998f)
-  TEST_REAL_SIMILAR(data[2], 304.6f)  
+  TEST_REAL_SIMILAR(data[2], 304.6f)
+}
+END_SECTION
+
+START_SECTION([EXTRA] long input (vectorized encoding / decoding))
+{
+  Base64 b64;
+  String str;
+
+  // 61 bytes: 60 bytes are encoded in blocks, the last byte needs padding
+  std::vector<String> in(1, String("The quick brown fox jumps over the lazy dog. 0123456789+/=!?#"));
+  b64.encodeStrings(in, str, false, false);
+  TEST_EQUAL(str, "VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4gMDEyMzQ1Njc4OSsvPSE/Iw==")
+  std::vector<String> out;
+  b64.decodeStrings(str, out, false);
+  TEST_EQUAL(out.size(), 1)
+  TEST_EQUAL(out[0], in[0])
+
+  // all possible byte values
+  in[0] = String();
+  for (Size i = 1; i < 256; ++i)
+  {
+    in[0] += char(i);
+  }
+  b64.encodeStrings(in, str, false, false);
+  b64.decodeStrings(str, out, false);
+  TEST_EQUAL(out.size(), 1)
+  TEST_EQUAL(out[0] == in[0], true)
+
+  // round trips of different lengths (all remainders of the vectorized blocks)
+  for (Size n = 0; n < 70; ++n)
+  {
+    std::vector<double> data, data_in, res;
+    std::vector<float> data_float, data_float_in, res_float;
+    for (Size i = 0; i < n; ++i)
+    {
+      data.push_back(i * 1.5 - 7.25);
+      data_float.push_back(i * 3.0f + 0.5f);
+    }
+    for (Base64::ByteOrder order : {Base64::BYTEORDER_LITTLEENDIAN, Base64::BYTEORDER_BIGENDIAN})
+    {
+      data_in = data;
+      b64.encode(data_in, order, str, false);
+      b64.decode(str, order, res, false);
+      TEST_EQUAL(res == data, true)
+
+      data_float_in = data_float;
+      b64.encode(data_float_in, order, str, false);
+      b64.decode(str, order, res_float, false);
+      TEST_EQUAL(res_float == data_float, true)
+
+      data_in = data;
+      b64.encode(data_in, order, str, true);
+      b64.decode(str, order, res, true);
+      TEST_EQUAL(res == data, true)
+    }
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] input with whitespace)
+{
+  Base64 b64;
+  String str;
+
+  // inserts a line break (CR LF) and two spaces after every 16 characters (keeps the length a multiple of 4)
+  auto wrap = [](const String& in)
+  {
+    String wrapped;
+    for (Size i = 0; i < in.size(); i += 16)
+    {
+      wrapped += in.substr(i, 16) + "\r\n  ";
+    }
+    return wrapped;
+  };
+
+  std::vector<double> data, data_in, res;
+  std::vector<Int32> data_int, data_int_in, res_int;
+  for (Size i = 0; i < 25; ++i)
+  {
+    data.push_back(i * 1.5 - 7.25);
+    data_int.push_back(Int32(i * 1000) - 3);
+  }
+  for (bool zlib : {false, true})
+  {
+    data_in = data;
+    b64.encode(data_in, Base64::BYTEORDER_BIGENDIAN, str, zlib);
+    TEST_EQUAL(wrap(str).size() % 4, 0)
+    b64.decode(wrap(str), Base64::BYTEORDER_BIGENDIAN, res, zlib);
+    TEST_EQUAL(res == data, true)
+
+    data_int_in = data_int;
+    b64.encodeIntegers(data_int_in, Base64::BYTEORDER_LITTLEENDIAN, str, zlib);
+    b64.decodeIntegers(wrap(str), Base64::BYTEORDER_LITTLEENDIAN, res_int, zlib);
+    TEST_EQUAL(res_int == data_int, true)
+  }
+
+  std::vector<String> in(1, String("The quick brown fox jumps over the lazy dog."));
+  std::vector<String> out;
+  b64.encodeStrings(in, str, true, false);
+  b64.decodeStrings(wrap(str), out, true);
+  TEST_EQUAL(out.size(), 1)
+  TEST_EQUAL(out[0], in[0])
 }
 END_SECTION
 
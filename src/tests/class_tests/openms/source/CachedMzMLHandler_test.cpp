@@ -412,6 +412,117 @@ START_SECTION( static inline void readChromatogramFast(OpenSwath::BinaryDataArra
 }
 END_SECTION
 
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readSpectrumFast(const char* data, Size data_size, int& ms_level, double& rt))
+{
+  // read the whole cached file into memory
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> spectra_index = cache_.getSpectraIndex();
+  TEST_EQUAL(spectra_index.size(), 4)
+
+  for (Size k = 0; k < spectra_index.size(); k++)
+  {
+    const Size offset = static_cast<Size>(spectra_index[k]);
+    int ms_level = -1;
+    double rt = -1.0;
+    std::vector<OpenSwath::BinaryDataArrayPtr> data =
+      CachedMzMLHandler::readSpectrumFast(buffer.data() + offset, buffer.size() - offset, ms_level, rt);
+
+    TEST_EQUAL(data.size(), 2 + exp.getSpectrum(k).getFloatDataArrays().size())
+    TEST_EQUAL(data[0]->data.size(), exp.getSpectrum(k).size())
+    TEST_EQUAL(data[1]->data.size(), exp.getSpectrum(k).size())
+    TEST_EQUAL(ms_level, exp.getSpectrum(k).getMSLevel())
+    TEST_REAL_SIMILAR(rt, exp.getSpectrum(k).getRT())
+    for (Size i = 0; i < data[0]->data.size(); i++)
+    {
+      TEST_REAL_SIMILAR(data[0]->data[i], exp.getSpectrum(k)[i].getMZ())
+      TEST_REAL_SIMILAR(data[1]->data[i], exp.getSpectrum(k)[i].getIntensity())
+    }
+    for (Size j = 2; j < data.size(); j++)
+    {
+      TEST_EQUAL(data[j]->description, exp.getSpectrum(k).getFloatDataArrays()[j - 2].getName())
+      TEST_EQUAL(data[j]->data.size(), exp.getSpectrum(k).getFloatDataArrays()[j - 2].size())
+    }
+
+    // identical to reading from the filestream
+    ifs_.clear();
+    ifs_.seekg(spectra_index[k]);
+    std::vector<OpenSwath::BinaryDataArrayPtr> data_stream = CachedMzMLHandler::readSpectrumFast(ifs_, ms_level, rt);
+    TEST_EQUAL(data_stream.size(), data.size())
+    for (Size j = 0; j < data.size(); j++)
+    {
+      TEST_EQUAL(data_stream[j]->data == data[j]->data, true)
+    }
+  }
+
+  // should not read after the end of the data
+  const Size offset = static_cast<Size>(spectra_index[1]);
+  int ms_level = -1;
+  double rt = -1.0;
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(buffer.data() + offset, 20, ms_level, rt))
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readSpectrumFast(buffer.data() + offset, 0, ms_level, rt))
+}
+END_SECTION
+
+START_SECTION(static std::vector<OpenSwath::BinaryDataArrayPtr> readChromatogramFast(const char* data, Size data_size))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  std::vector<std::streampos> chrom_index = cache_.getChromatogramIndex();
+  TEST_EQUAL(chrom_index.size(), 2)
+
+  for (Size k = 0; k < chrom_index.size(); k++)
+  {
+    const Size offset = static_cast<Size>(chrom_index[k]);
+    std::vector<OpenSwath::BinaryDataArrayPtr> data =
+      CachedMzMLHandler::readChromatogramFast(buffer.data() + offset, buffer.size() - offset);
+
+    TEST_EQUAL(data[0]->data.size(), exp.getChromatogram(k).size())
+    TEST_EQUAL(data[1]->data.size(), exp.getChromatogram(k).size())
+    for (Size i = 0; i < data[0]->data.size(); i++)
+    {
+      TEST_REAL_SIMILAR(data[0]->data[i], exp.getChromatogram(k)[i].getRT())
+      TEST_REAL_SIMILAR(data[1]->data[i], exp.getChromatogram(k)[i].getIntensity())
+    }
+  }
+
+  // should not read after the end of the data
+  const Size offset = static_cast<Size>(chrom_index[0]);
+  TEST_EXCEPTION(Exception::ParseError, CachedMzMLHandler::readChromatogramFast(buffer.data() + offset, 20))
+}
+END_SECTION
+
+START_SECTION(static void readSpectrum(SpectrumType& spectrum, const char* data, Size data_size))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const Size offset = static_cast<Size>(cache_.getSpectraIndex()[1]);
+
+  MSSpectrum s;
+  CachedMzMLHandler::readSpectrum(s, buffer.data() + offset, buffer.size() - offset);
+  TEST_EQUAL(s.size(), exp.getSpectrum(1).size())
+  TEST_REAL_SIMILAR(s.getRT(), exp.getSpectrum(1).getRT())
+  TEST_EQUAL(s.getFloatDataArrays().size(), 2)
+  TEST_EQUAL(s.getFloatDataArrays()[0].getName(), "signal to noise array")
+}
+END_SECTION
+
+START_SECTION(static void readChromatogram(ChromatogramType& chromatogram, const char* data, Size data_size))
+{
+  std::ifstream ifs_(tmp_filename.c_str(), std::ios::binary);
+  std::string buffer((std::istreambuf_iterator<char>(ifs_)), std::istreambuf_iterator<char>());
+  const Size offset = static_cast<Size>(cache_.getChromatogramIndex()[0]);
+
+  MSChromatogram c;
+  CachedMzMLHandler::readChromatogram(c, buffer.data() + offset, buffer.size() - offset);
+  TEST_EQUAL(c.size(), exp.getChromatogram(0).size())
+  for (Size i = 0; i < c.size(); i++)
+  {
+    TEST_REAL_SIMILAR(c[i].getRT(), exp.getChromatogram(0)[i].getRT())
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -180,6 +180,25 @@ START_SECTION(( [EXTRA] testCaching))
 }
 END_SECTION
 
+START_SECTION(( bool isMemoryMapped() const ))
+{
+  TEST_EQUAL(CachedmzML().isMemoryMapped(), false)
+  TEST_EQUAL(cache_example.isMemoryMapped(), true)
+
+  // copies share the mapping and read the same data
+  CachedmzML copy(cache_example);
+  TEST_EQUAL(copy.isMemoryMapped(), true)
+  for (Size i = 0; i < 4; i++)
+  {
+    TEST_EQUAL(copy.getSpectrum(i) == cache_example.getSpectrum(i), true)
+  }
+  for (Size i = 0; i < 2; i++)
+  {
+    TEST_EQUAL(copy.getChromatogram(i) == cache_example.getChromatogram(i), true)
+  }
+}
+END_SECTION
+
 START_SECTION(( size_t getNrSpectra() const ))
     TEST_EQUAL(cache_example.getNrSpectra(), 4)
 END_SECTION
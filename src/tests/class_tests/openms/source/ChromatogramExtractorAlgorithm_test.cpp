@@ -39,6 +39,10 @@
 #include <OpenMS/FORMAT/MzMLFile.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -257,6 +261,107 @@ START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessP
     TEST_REAL_SIMILAR(max_value, 313 + 314 + 315)
     TEST_REAL_SIMILAR(foundat, 3)
   }
+
+  // RT windows: only spectra inside [rt_start, rt_end] are extracted
+  {
+    std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > rt_coordinates = coordinates;
+    rt_coordinates[0].rt_start = 1.0; rt_coordinates[0].rt_end = 2.0;
+    rt_coordinates[1].rt_start = 2.5; rt_coordinates[1].rt_end = 10.0;
+
+    std::vector< OpenSwath::ChromatogramPtr > out_exp;
+    for (int i = 0; i < 2; i++)
+    {
+      OpenSwath::ChromatogramPtr s(new OpenSwath::Chromatogram);
+      out_exp.push_back(s);
+    }
+
+    extractor.extractChromatograms(expptr, out_exp, rt_coordinates, extract_window, false, -1, "tophat");
+
+    TEST_EQUAL(out_exp[0]->getTimeArray()->data.size(), 2);
+    TEST_EQUAL(out_exp[0]->getIntensityArray()->data.size(), 2);
+    TEST_REAL_SIMILAR(out_exp[0]->getTimeArray()->data[0], 1)
+    TEST_REAL_SIMILAR(out_exp[0]->getTimeArray()->data[1], 2)
+    TEST_REAL_SIMILAR(out_exp[0]->getIntensityArray()->data[0], 630)
+    TEST_REAL_SIMILAR(out_exp[0]->getIntensityArray()->data[1], 1230)
+
+    TEST_EQUAL(out_exp[1]->getTimeArray()->data.size(), 1);
+    TEST_EQUAL(out_exp[1]->getIntensityArray()->data.size(), 1);
+    TEST_REAL_SIMILAR(out_exp[1]->getTimeArray()->data[0], 3)
+    TEST_REAL_SIMILAR(out_exp[1]->getIntensityArray()->data[0], 2790)
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] void extractChromatograms(const OpenSwath::SpectrumAccessPtr input, std::vector< OpenSwath::ChromatogramPtr > &output, std::vector< ExtractionCoordinates >& extraction_coordinates, double mz_extraction_window, bool ppm, String filter))
+{
+  // enough spectra for three blocks of at least 50 spectra (min_spectra_per_thread_)
+  boost::shared_ptr<PeakMap > exp(new PeakMap);
+  for (Size i = 0; i < 157; ++i)
+  {
+    MSSpectrum spec;
+    spec.setRT(10.0 * i);
+    for (Size j = 0; j < 4; ++j)
+    {
+      spec.push_back(Peak1D(400.0 + 50.0 * j + 0.001 * (i % 5), 100.0 + (i * 7 + j * 3) % 13));
+    }
+    exp->addSpectrum(spec);
+  }
+  OpenSwath::SpectrumAccessPtr expptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+
+  // the blocks start at spectra 52 and 104 (RT 520 and 1040)
+  std::vector< ChromatogramExtractorAlgorithm::ExtractionCoordinates > coordinates;
+  {
+    ChromatogramExtractorAlgorithm::ExtractionCoordinates coord;
+    coord.mz = 400.0; coord.rt_start = 0; coord.rt_end = -1; coord.id = "all";
+    coordinates.push_back(coord);
+    coord.mz = 450.0; coord.rt_start = 400; coord.rt_end = 600; coord.id = "first_boundary";
+    coordinates.push_back(coord);
+    coord.mz = 500.0; coord.rt_start = 200; coord.rt_end = 1200; coord.id = "both_boundaries";
+    coordinates.push_back(coord);
+    coord.mz = 550.0; coord.rt_start = 1100; coord.rt_end = 1300; coord.id = "last_block";
+    coordinates.push_back(coord);
+  }
+
+  auto extract = [&](int threads)
+  {
+    std::vector< OpenSwath::ChromatogramPtr > out;
+    for (Size k = 0; k < coordinates.size(); ++k)
+    {
+      out.push_back(OpenSwath::ChromatogramPtr(new OpenSwath::Chromatogram));
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(threads);
+#else
+    (void)threads;
+#endif
+    ChromatogramExtractorAlgorithm().extractChromatograms(expptr, out, coordinates, 0.05, false, -1, "tophat");
+    return out;
+  };
+
+#ifdef _OPENMP
+  int max_threads = omp_get_max_threads();
+#endif
+  std::vector< OpenSwath::ChromatogramPtr > serial = extract(1);
+  std::vector< OpenSwath::ChromatogramPtr > parallel = extract(3);
+#ifdef _OPENMP
+  omp_set_num_threads(max_threads);
+#endif
+
+  TEST_EQUAL(serial[0]->getTimeArray()->data.size(), 157)
+  TEST_EQUAL(serial[1]->getTimeArray()->data.size(), 21)
+  TEST_EQUAL(serial[2]->getTimeArray()->data.size(), 101)
+  TEST_EQUAL(serial[3]->getTimeArray()->data.size(), 21)
+  for (Size k = 0; k < coordinates.size(); ++k)
+  {
+    TEST_EQUAL(parallel[k]->getTimeArray()->data.size(), serial[k]->getTimeArray()->data.size())
+    TEST_EQUAL(parallel[k]->getIntensityArray()->data.size(), serial[k]->getIntensityArray()->data.size())
+    ABORT_IF(parallel[k]->getTimeArray()->data.size() != serial[k]->getTimeArray()->data.size())
+    for (Size i = 0; i < serial[k]->getTimeArray()->data.size(); ++i)
+    {
+      TEST_EQUAL(parallel[k]->getTimeArray()->data[i], serial[k]->getTimeArray()->data[i])
+      TEST_EQUAL(parallel[k]->getIntensityArray()->data[i], serial[k]->getIntensityArray()->data[i])
+    }
+  }
 }
 END_SECTION
 
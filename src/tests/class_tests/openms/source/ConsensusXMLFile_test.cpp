@@ -46,6 +46,10 @@
 
 #include <OpenMS/DATASTRUCTURES/ListUtils.h>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -56,6 +60,17 @@ DRange<1> makeRange(double a, double b)
   return DRange<1>(pa, pb);
 }
 
+// splits even small documents into chunks which are parsed in parallel
+class SplittingConsensusXMLFile :
+  public ConsensusXMLFile
+{
+public:
+  SplittingConsensusXMLFile()
+  {
+    min_split_chunk_size_ = 1;
+  }
+};
+
 START_TEST(ConsensusXMLFile, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -246,6 +261,34 @@ START_SECTION([EXTRA](bool isValid(const String &filename)))
   TEST_EQUAL(f.isValid(tmp_filename, std::cerr), true);
 END_SECTION
 
+START_SECTION([EXTRA] load with document split into chunks)
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(2);
+#endif
+  ConsensusMap map, split_map;
+  ConsensusXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), map);
+  SplittingConsensusXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML"), split_map);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(split_map.getIdentifier(), map.getIdentifier())
+  TEST_EQUAL(split_map.getColumnHeaders().size(), map.getColumnHeaders().size())
+  TEST_EQUAL(split_map.getProteinIdentifications().size(), map.getProteinIdentifications().size())
+  TEST_EQUAL(split_map.getUnassignedPeptideIdentifications().size(), map.getUnassignedPeptideIdentifications().size())
+  TEST_EQUAL(split_map.size(), map.size())
+  ABORT_IF(split_map.size() != map.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(split_map[i].getUniqueId(), map[i].getUniqueId())
+    TEST_REAL_SIMILAR(split_map[i].getRT(), map[i].getRT())
+    TEST_REAL_SIMILAR(split_map[i].getMZ(), map[i].getMZ())
+    TEST_EQUAL(split_map[i].size(), map[i].size())
+    TEST_EQUAL(split_map[i].getPeptideIdentifications().size(), map[i].getPeptideIdentifications().size())
+  }
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
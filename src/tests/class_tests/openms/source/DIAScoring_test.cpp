@@ -360,6 +360,62 @@ START_SECTION ( void dia_isotope_scores(const std::vector< TransitionType > &tra
 }
 END_SECTION
 
+START_SECTION ( void prepareTransitionData(const std::vector<TransitionType>& transitions, TransitionData& transition_data) const )
+{
+  std::vector<OpenSwath::LightTransition> transitions;
+  transitions.push_back(mock_tr1);
+  transitions.push_back(mock_tr2);
+  transitions.back().fragment_charge = 0;
+
+  DIAScoring diascoring;
+  diascoring.setParameters(p_dia);
+  DIAScoring::TransitionData transition_data;
+  diascoring.prepareTransitionData(transitions, transition_data);
+
+  TEST_EQUAL(transition_data.nr_isotopes, 5)
+  TEST_EQUAL(transition_data.product_mz.size(), 2)
+  TEST_EQUAL(transition_data.fragment_charge.size(), 2)
+  TEST_EQUAL(transition_data.isotope_patterns.size(), 10)
+  TEST_REAL_SIMILAR(transition_data.product_mz[0], 500.0)
+  TEST_REAL_SIMILAR(transition_data.product_mz[1], 600.0)
+  TEST_EQUAL(transition_data.fragment_charge[0], 1)
+  TEST_EQUAL(transition_data.fragment_charge[1], 1) // no charge annotated
+
+  // theoretical pattern at 600 m/z, see above
+  TEST_REAL_SIMILAR(transition_data.isotope_patterns[5], 1.0)
+  TEST_REAL_SIMILAR(transition_data.isotope_patterns[6], 0.325757771553019)
+  TEST_REAL_SIMILAR(transition_data.isotope_patterns[7], 0.0678711748364005)
+}
+END_SECTION
+
+START_SECTION ( void dia_isotope_scores(const std::vector< TransitionType > &transitions, const TransitionData& transition_data, SpectrumType spectrum, OpenSwath::IMRMFeature *mrmfeature, double &isotope_corr, double &isotope_overlap) )
+{
+  OpenSwath::SpectrumPtr sptr = prepareSpectrum();
+
+  MockMRMFeature * imrmfeature_test = new MockMRMFeature();
+  getMRMFeatureTest(imrmfeature_test);
+
+  std::vector<OpenSwath::LightTransition> transitions;
+  transitions.push_back(mock_tr1);
+  transitions.push_back(mock_tr2);
+
+  DIAScoring diascoring;
+  diascoring.setParameters(p_dia);
+  DIAScoring::TransitionData transition_data;
+  diascoring.prepareTransitionData(transitions, transition_data);
+
+  // the precomputed data can be reused for several peak groups
+  for (Size i = 0; i < 2; ++i)
+  {
+    double isotope_corr = 0, isotope_overlap = 0;
+    diascoring.dia_isotope_scores(transitions, transition_data, sptr, imrmfeature_test, isotope_corr, isotope_overlap);
+    TEST_REAL_SIMILAR(isotope_corr, 0.995335798317618 * 0.7 + 0.959692139694113 * 0.3)
+    TEST_REAL_SIMILAR(isotope_overlap, 0.0 * 0.7 + 1.0 * 0.3)
+  }
+  delete imrmfeature_test;
+}
+END_SECTION
+
 START_SECTION(void dia_ms1_isotope_scores(double precursor_mz, SpectrumPtrType spectrum, size_t charge_state, 
                                 double& isotope_corr, double& isotope_overlap))
 {
@@ -44,6 +44,13 @@
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
+#include <fstream>
+#include <iterator>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -55,6 +62,24 @@ DRange<1> makeRange(double a, double b)
 
 ///////////////////////////
 
+// splits even small documents into chunks which are parsed in parallel
+class SplittingFeatureXMLFile :
+  public FeatureXMLFile
+{
+public:
+  SplittingFeatureXMLFile()
+  {
+    min_split_chunk_size_ = 1;
+  }
+
+  bool splitDocument(const String& filename, SplitDocument& document) const
+  {
+    return splitDocument_(filename, "feature", "featureList", document);
+  }
+};
+
+///////////////////////////
+
 START_TEST(FeatureXMLFile, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -389,6 +414,79 @@ END_SECTION
 
 
 
+START_SECTION([EXTRA] load with document split into chunks)
+{
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(2);
+#endif
+  FeatureMap map, split_map;
+  FeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), map);
+  SplittingFeatureXMLFile().load(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"), split_map);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(split_map.getIdentifier(), map.getIdentifier())
+  TEST_EQUAL(split_map.getProteinIdentifications().size(), map.getProteinIdentifications().size())
+  TEST_EQUAL(split_map.getUnassignedPeptideIdentifications().size(), map.getUnassignedPeptideIdentifications().size())
+  TEST_EQUAL(split_map.size(), map.size())
+  ABORT_IF(split_map.size() != map.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(split_map[i].getUniqueId(), map[i].getUniqueId())
+    TEST_REAL_SIMILAR(split_map[i].getRT(), map[i].getRT())
+    TEST_REAL_SIMILAR(split_map[i].getMZ(), map[i].getMZ())
+    TEST_EQUAL(split_map[i].getConvexHulls().size(), map[i].getConvexHulls().size())
+    TEST_EQUAL(split_map[i].getSubordinates().size(), map[i].getSubordinates().size())
+    TEST_EQUAL(split_map[i].getPeptideIdentifications().size(), map[i].getPeptideIdentifications().size())
+  }
+}
+END_SECTION
+
+START_SECTION([EXTRA] load split document with namespace prefixes in the entries)
+{
+  // an entry with an attribute in the namespace declared on the root element
+  std::ifstream is(OPENMS_GET_TEST_DATA_PATH("FeatureXMLFile_1.featureXML"));
+  String content((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+  content.substitute("<feature id=\"f_1001\">", "<feature id=\"f_1001\" xsi:nil=\"false\">");
+  String filename;
+  NEW_TMP_FILE(filename)
+  {
+    std::ofstream os(filename.c_str());
+    os << content;
+  }
+
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(2);
+#endif
+  SplittingFeatureXMLFile file;
+  FeatureMap map, split_map;
+  FeatureXMLFile().load(filename, map);
+  file.load(filename, split_map);
+#ifdef _OPENMP
+  Internal::XMLFile::SplitDocument document;
+  TEST_EQUAL(file.splitDocument(filename, document), true)
+  for (Size i = 0; i < document.chunks.size(); ++i)
+  {
+    TEST_EQUAL(String(document.getChunkDocument(i)).hasSubstring("<openms-split-chunk xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">"), true)
+  }
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(map.size(), 2)
+  TEST_EQUAL(split_map.size(), map.size())
+  ABORT_IF(split_map.size() != map.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(split_map[i].getUniqueId(), map[i].getUniqueId())
+    TEST_REAL_SIMILAR(split_map[i].getRT(), map[i].getRT())
+    TEST_EQUAL(split_map[i].getSubordinates().size(), map[i].getSubordinates().size())
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -559,6 +559,54 @@ START_SECTION((void annotate(ConsensusMap& map, const std::vector<PeptideIdentif
                peptide_ids.size());
   }
 
+  // mapping to several consensus features (by position and by native ID):
+  {
+    IDMapper mapper_multi;
+    Param p_multi = mapper_multi.getParameters();
+    p_multi.setValue("rt_tolerance", 5.0);
+    p_multi.setValue("mz_tolerance", 0.01);
+    p_multi.setValue("mz_measure", "Da");
+    p_multi.setValue("ignore_charge", "true");
+    mapper_multi.setParameters(p_multi);
+
+    ConsensusMap cm;
+    cm.resize(4);
+    cm[0].setRT(100.0);
+    cm[0].setMZ(500.0);
+    cm[1].setRT(103.0);
+    cm[1].setMZ(500.005);
+    cm[2].setRT(900.0); // far away, but identified by the same spectrum
+    cm[2].setMZ(700.0);
+    cm[2].setMetaValue("scan_id", "scan=42");
+    cm[3].setRT(200.0); // outside of the RT tolerance
+    cm[3].setMZ(500.0);
+
+    std::vector<PeptideIdentification> ids(3);
+    ids[0].setRT(101.0);
+    ids[0].setMZ(500.0);
+    ids[0].setMetaValue("spectrum_reference", "scan=42");
+    ids[0].insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDE")));
+    ids[1].setRT(300.0); // matches nothing
+    ids[1].setMZ(800.0);
+    ids[1].insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDER")));
+    ids[2].setRT(96.0); // outside of the RT tolerance of cm[1]
+    ids[2].setMZ(499.995);
+    ids[2].insertHit(PeptideHit(1.0, 1, 2, AASequence::fromString("PEPTIDEK")));
+
+    mapper_multi.annotate(cm, ids, std::vector<ProteinIdentification>());
+
+    TEST_EQUAL(cm[0].getPeptideIdentifications().size(), 2);
+    TEST_EQUAL(cm[0].getPeptideIdentifications()[0].getHits()[0].getSequence(), AASequence::fromString("PEPTIDE"));
+    TEST_EQUAL(cm[0].getPeptideIdentifications()[1].getHits()[0].getSequence(), AASequence::fromString("PEPTIDEK"));
+    TEST_EQUAL(cm[1].getPeptideIdentifications().size(), 1);
+    TEST_EQUAL(cm[1].getPeptideIdentifications()[0].getHits()[0].getSequence(), AASequence::fromString("PEPTIDE"));
+    TEST_EQUAL(cm[2].getPeptideIdentifications().size(), 1);
+    TEST_EQUAL(cm[2].getPeptideIdentifications()[0].getHits()[0].getSequence(), AASequence::fromString("PEPTIDE"));
+    TEST_EQUAL(cm[3].getPeptideIdentifications().size(), 0);
+    TEST_EQUAL(cm.getUnassignedPeptideIdentifications().size(), 1);
+    TEST_EQUAL(cm.getUnassignedPeptideIdentifications()[0].getHits()[0].getSequence(), AASequence::fromString("PEPTIDER"));
+  }
+
   // annotation of precursors without id
   IDMapper mapper6;
   p = mapper6.getParameters();
@@ -40,6 +40,23 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/CONCEPT/FuzzyStringComparator.h>
 
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace OpenMS;
+
+// splits even small documents into chunks which are parsed in parallel
+class SplittingIdXMLFile :
+  public IdXMLFile
+{
+public:
+  SplittingIdXMLFile()
+  {
+    min_split_chunk_size_ = 1;
+  }
+};
+
 ///////////////////////////
 
 START_TEST(IdXMLFile, "$Id$")
@@ -297,6 +314,45 @@ START_SECTION(([EXTRA] XLMS data labeled cross-linker))
   TEST_EQUAL(peptide_ids[0].getHits()[0].getPeakAnnotations()[25].annotation, "[alpha|xi$y8]")
 
 END_SECTION
+START_SECTION(([EXTRA] load with document split into chunks))
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(2);
+#endif
+  vector<ProteinIdentification> protein_ids, split_protein_ids;
+  vector<PeptideIdentification> peptide_ids, split_peptide_ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids);
+  SplittingIdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), split_protein_ids, split_peptide_ids);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(split_protein_ids.size(), protein_ids.size())
+  TEST_EQUAL(split_peptide_ids.size(), peptide_ids.size())
+  ABORT_IF(split_protein_ids.size() != protein_ids.size() || split_peptide_ids.size() != peptide_ids.size())
+  // identifiers contain a unique id, so compare which run each peptide identification refers to
+  auto run_index = [](const vector<ProteinIdentification>& runs, const PeptideIdentification& pep_id)
+  {
+    Size index = 0;
+    while (index < runs.size() && runs[index].getIdentifier() != pep_id.getIdentifier())
+    {
+      ++index;
+    }
+    return index;
+  };
+  for (Size i = 0; i < peptide_ids.size(); ++i)
+  {
+    TEST_EQUAL(run_index(split_protein_ids, split_peptide_ids[i]), run_index(protein_ids, peptide_ids[i]))
+    TEST_EQUAL(split_peptide_ids[i].getScoreType(), peptide_ids[i].getScoreType())
+    TEST_EQUAL(split_peptide_ids[i].getHits().size(), peptide_ids[i].getHits().size())
+    for (Size j = 0; j < min(peptide_ids[i].getHits().size(), split_peptide_ids[i].getHits().size()); ++j)
+    {
+      TEST_EQUAL(split_peptide_ids[i].getHits()[j].getSequence(), peptide_ids[i].getHits()[j].getSequence())
+      TEST_EQUAL(split_peptide_ids[i].getHits()[j].getPeptideEvidences().size(), peptide_ids[i].getHits()[j].getPeptideEvidences().size())
+    }
+  }
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -95,6 +95,14 @@ START_SECTION((IndexedMzMLHandler(const IndexedMzMLHandler &source)))
   TEST_EQUAL(file.getChromatogramById(0) == file2.getChromatogramById(0), true)
   TEST_EQUAL(file.getSpectrumById(1), file2.getSpectrumById(1))
   */
+
+  // the copy keeps the native id lookup
+  OpenMS::MSSpectrum s1, s2;
+  file.getMSSpectrumByNativeId("controllerType=0 controllerNumber=1 scan=1", s1);
+  file2.getMSSpectrumByNativeId("controllerType=0 controllerNumber=1 scan=1", s2);
+  TEST_EQUAL(s1.size(), s2.size())
+  TEST_EQUAL(s1.getNativeID(), s2.getNativeID())
+  TEST_EQUAL(file.isMemoryMapped(), file2.isMemoryMapped())
 }
 END_SECTION
 
@@ -280,6 +288,47 @@ START_SECTION(( void getMSChromatogramByNativeId(std::string id, OpenMS::MSChrom
 }
 END_SECTION
 
+START_SECTION(( bool isMemoryMapped() const ))
+{
+  IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(file.isMemoryMapped(), true)
+
+  IndexedMzMLHandler empty_file;
+  TEST_EQUAL(empty_file.isMemoryMapped(), false)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] concurrent access by index))
+{
+  IndexedMzMLHandler file(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  ABORT_IF(file.getNrSpectra() != 2)
+
+  std::vector<OpenMS::Interfaces::SpectrumPtr> serial;
+  for (int i = 0; i < (int)file.getNrSpectra(); ++i)
+  {
+    serial.push_back(file.getSpectrumById(i));
+  }
+
+  // read every spectrum many times from the same object in parallel
+  const int repeats = 50;
+  std::vector<OpenMS::Interfaces::SpectrumPtr> parallel(repeats * file.getNrSpectra());
+#pragma omp parallel for
+  for (SignedSize k = 0; k < (SignedSize)parallel.size(); ++k)
+  {
+    parallel[k] = file.getSpectrumById(int(k % file.getNrSpectra()));
+  }
+
+  bool all_equal = true;
+  for (Size k = 0; k < parallel.size(); ++k)
+  {
+    const OpenMS::Interfaces::SpectrumPtr& ref = serial[k % serial.size()];
+    all_equal &= parallel[k]->getMZArray()->data == ref->getMZArray()->data;
+    all_equal &= parallel[k]->getIntensityArray()->data == ref->getIntensityArray()->data;
+  }
+  TEST_EQUAL(all_equal, true)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] load broken file))
 {
 
@@ -261,6 +261,42 @@ mean(xcorr_max) # shape score
         }
     END_SECTION
 
+    BOOST_AUTO_TEST_CASE(initializeXCorrMatrix_data)
+        {
+          std::vector<std::vector<double>> data {
+            {5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765},
+            {15.8951349258423, 41.5446395874023, 76.0746307373047, 109.069435119629, 111.90364074707, 169.79216003418},
+            {0.0, 110.0, 200.0, 270.0, 320.0, 350.0},
+            {3.0, 3.0, 3.0, 3.0, 3.0, 3.0}};
+
+          MRMScoring mrmscore;
+          // a larger matrix first, re-initialization must not keep any of it
+          mrmscore.initializeXCorrMatrix(std::vector<std::vector<double>>(6, data[1]));
+          TEST_EQUAL(mrmscore.getXCorrMatrix().rows(), 6)
+          mrmscore.initializeXCorrMatrix(data);
+
+          TEST_EQUAL(mrmscore.getXCorrMatrix().rows(), 4)
+          TEST_EQUAL(mrmscore.getXCorrMatrix().cols(), 4)
+          for (std::size_t i = 0; i < data.size(); i++)
+          {
+            for (std::size_t j = i; j < data.size(); j++)
+            {
+              std::vector<double> d1 = data[i], d2 = data[j];
+              OpenSwath::Scoring::XCorrArrayType expected = OpenSwath::Scoring::normalizedCrossCorrelation(d1, d2, static_cast<int>(d1.size()), 1);
+              const OpenSwath::Scoring::XCorrArrayType& result = mrmscore.getXCorrMatrix().getValue(i, j);
+              TEST_EQUAL(result.data.size(), expected.data.size())
+              for (std::size_t k = 0; k < expected.data.size(); k++)
+              {
+                TEST_EQUAL(result.data[k].first, expected.data[k].first)
+                TEST_EQUAL(result.data[k].second, expected.data[k].second)
+              }
+            }
+          }
+          // only the upper triangle is filled
+          TEST_EQUAL(mrmscore.getXCorrMatrix().getValue(1, 0).data.size(), 0)
+        }
+    END_SECTION
+
     BOOST_AUTO_TEST_CASE(initializeXCorrPrecursorContrastMatrix)
         {
           MockMRMFeature * imrmfeature = new MockMRMFeature();
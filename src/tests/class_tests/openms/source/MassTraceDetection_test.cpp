@@ -175,6 +175,43 @@ START_SECTION((void run(const PeakMap &, std::vector< MassTrace > &)))
 }
 END_SECTION
 
+START_SECTION([EXTRA](void run(const PeakMap &, std::vector< MassTrace > &, const Size max_traces)))
+{
+    // the most intense traces are found first
+    std::vector<MassTrace> output_max;
+    test_mtd.run(input, output_max, 2);
+    TEST_EQUAL(output_max.size(), 2);
+    for (Size i = 0; i < output_max.size(); ++i)
+    {
+        TEST_EQUAL(output_max[i].getSize(), exp_mt_lengths[i]);
+        TEST_REAL_SIMILAR(output_max[i].getCentroidMZ(), exp_mt_mzs[i]);
+        TEST_EQUAL(output_max[i].getLabel(), output_mt[i].getLabel());
+    }
+
+    // FWHM meta data: the median over the peaks of a trace is reported
+    PeakMap input_fwhm = input;
+    for (MSSpectrum& spec : input_fwhm)
+    {
+      MSSpectrum::FloatDataArray fwhm;
+      fwhm.setName("FWHM_ppm");
+      fwhm.resize(spec.size(), 7.5f);
+      spec.getFloatDataArrays().push_back(fwhm);
+    }
+    output_max.clear();
+    test_mtd.run(input_fwhm, output_max);
+    TEST_EQUAL(output_max.size(), 3);
+    for (Size i = 0; i < output_max.size(); ++i)
+    {
+        TEST_EQUAL(output_max[i].getSize(), exp_mt_lengths[i]);
+        TEST_REAL_SIMILAR(output_max[i].fwhm_mz_avg, 7.5);
+    }
+
+    // FWHM meta data must be present for all spectra or for none
+    input_fwhm[0].getFloatDataArrays().clear();
+    TEST_EXCEPTION(Exception::Precondition, test_mtd.run(input_fwhm, output_max));
+}
+END_SECTION
+
 std::vector<MassTrace> filt;
 
 //START_SECTION((void filterByPeakWidth(std::vector< MassTrace > &, std::vector< MassTrace > &)))
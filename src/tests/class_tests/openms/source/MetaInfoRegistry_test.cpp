@@ -43,6 +43,8 @@
 
 #include <OpenMS/METADATA/MetaInfoRegistry.h>
 
+#include <set>
+
 ///////////////////////////
 
 START_TEST(MetaInfoRegistry, "$Id$")
@@ -234,6 +236,37 @@ START_SECTION([EXTRA] multithreaded example)
 }
 END_SECTION
 
+START_SECTION([EXTRA] concurrent registration and lookup of different names)
+{
+  MetaInfoRegistry registry;
+  const int nr_names = 2000;
+  std::vector<UInt> indices(4 * nr_names);
+  int mismatches = 0;
+#pragma omp parallel for reduction(+: mismatches)
+  for (int k = 0; k < 4 * nr_names; k++)
+  {
+    String name = "concurrent_" + String(k % nr_names);
+    UInt index = registry.registerName(name);
+    if (registry.getIndex(name) != index || registry.getName(index) != name) ++mismatches;
+    if (registry.getIndex("charge") != 13) ++mismatches;
+    indices[k] = index;
+  }
+  TEST_EQUAL(mismatches, 0)
+
+  // every name got exactly one index, all indices are distinct
+  std::set<UInt> distinct;
+  for (int k = 0; k < nr_names; k++)
+  {
+    TEST_EQUAL(indices[k], indices[k + nr_names])
+    TEST_EQUAL(indices[k], indices[k + 3 * nr_names])
+    distinct.insert(indices[k]);
+  }
+  TEST_EQUAL(distinct.size(), Size(nr_names))
+  TEST_EQUAL(*distinct.begin(), 1024)
+  TEST_EQUAL(*distinct.rbegin(), 1024 + nr_names - 1)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
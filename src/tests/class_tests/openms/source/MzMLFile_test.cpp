@@ -1233,6 +1233,36 @@ START_SECTION(void transform(const String& filename_in, Interfaces::IMSDataConsu
 }
 END_SECTION
 
+START_SECTION([EXTRA] load with small data pool (background decoding of batches))
+{
+  MzMLFile mzml;
+  PeakMap reference, map;
+  String in = OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML");
+  mzml.load(in, reference);
+
+  // batches of a single spectrum / chromatogram: every batch but the last one
+  // is decoded in the background while the next one is parsed
+  PeakFileOptions opt = mzml.getOptions();
+  opt.setMaxDataPoolSize(1);
+  mzml.setOptions(opt);
+  mzml.load(in, map);
+
+  TEST_EQUAL(map.size(), reference.size())
+  ABORT_IF(map.size() != reference.size())
+  for (Size i = 0; i < map.size(); ++i)
+  {
+    TEST_EQUAL(map[i].getNativeID(), reference[i].getNativeID())
+    TEST_EQUAL(map[i] == reference[i], true)
+  }
+  TEST_EQUAL(map.getChromatograms().size(), reference.getChromatograms().size())
+  ABORT_IF(map.getChromatograms().size() != reference.getChromatograms().size())
+  for (Size i = 0; i < map.getChromatograms().size(); ++i)
+  {
+    TEST_EQUAL(map.getChromatograms()[i] == reference.getChromatograms()[i], true)
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -456,6 +456,107 @@ START_SECTION(std::vector<size_t> getSpectraIndicesbyRT(double RT, double deltaR
 }
 END_SECTION
 
+START_SECTION(std::vector<int> getSpectraIndicesByRange(double rt_start, double rt_end, int ms_level = 0, double precursor_mz_start = 0.0, double precursor_mz_end = -1.0) const)
+{
+  {
+    MzMLSqliteHandler handler(OPENMS_GET_TEST_DATA_PATH("SqliteMassFile_1.sqMass"), 0);
+
+    auto res = handler.getSpectraIndicesByRange(0.0, -1.0);
+    TEST_EQUAL(res.size(), 2)
+
+    res = handler.getSpectraIndicesByRange(0.3, 1.0);
+    TEST_EQUAL(res.size(), 1)
+    TEST_EQUAL(res[0], 1)
+
+    res = handler.getSpectraIndicesByRange(0.0, 1.0, 1);
+    TEST_EQUAL(res.size(), 2)
+    res = handler.getSpectraIndicesByRange(0.0, 1.0, 2);
+    TEST_EQUAL(res.size(), 0)
+
+    // spectra without precursor never match a precursor window
+    res = handler.getSpectraIndicesByRange(0.0, -1.0, 0, 0.0, 2000.0);
+    TEST_EQUAL(res.size(), 0)
+  }
+
+  // a larger file with five SWATH windows (enough spectra to be read in parallel)
+  std::vector<MSSpectrum> spectra(250);
+  for (Size i = 0; i < spectra.size(); ++i)
+  {
+    spectra[i].setNativeID("scan=" + String(i));
+    spectra[i].setRT(i);
+    if (i % 5 == 0)
+    {
+      spectra[i].setMSLevel(1);
+    }
+    else
+    {
+      spectra[i].setMSLevel(2);
+      Precursor p;
+      p.setMZ(400.0 + 25.0 * (i % 5));
+      spectra[i].getPrecursors().push_back(p);
+    }
+    for (Size k = 0; k < 10; ++k)
+    {
+      spectra[i].push_back(Peak1D(100.0 + k, i * 10.0 + k));
+    }
+  }
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+  MzMLSqliteHandler handler(tmp_filename, 0);
+  handler.setConfig(false, false, 0.0001);
+  handler.createTables();
+  handler.writeSpectra(spectra);
+  handler.writeRunLevelInformation(MSExperiment(), false);
+
+  auto res = handler.getSpectraIndicesByRange(100.0, 149.5);
+  TEST_EQUAL(res.size(), 50)
+  TEST_EQUAL(res.front(), 100)
+  TEST_EQUAL(res.back(), 149)
+
+  res = handler.getSpectraIndicesByRange(0.0, -1.0, 2, 449.0, 451.0);
+  TEST_EQUAL(res.size(), 50)
+  TEST_EQUAL(res.front(), 2)
+  TEST_EQUAL(res.back(), 247)
+
+  res = handler.getSpectraIndicesByRange(100.0, 149.5, 2, 449.0, 451.0);
+  TEST_EQUAL(res.size(), 10)
+  TEST_EQUAL(res.front(), 102)
+
+  res = handler.getSpectraIndicesByRange(100.0, 149.5, 1);
+  TEST_EQUAL(res.size(), 10)
+  TEST_EQUAL(res.front(), 100)
+
+  // read only the selected SWATH window
+  res = handler.getSpectraIndicesByRange(0.0, -1.0, 2, 449.0, 451.0);
+  std::vector<MSSpectrum> window;
+  handler.readSpectra(window, res, false);
+  TEST_EQUAL(window.size(), 50)
+  ABORT_IF(window.size() != 50)
+  for (Size i = 0; i < window.size(); ++i)
+  {
+    Size orig = 5 * i + 2;
+    TEST_EQUAL(window[i].getNativeID(), "scan=" + String(orig))
+    TEST_REAL_SIMILAR(window[i].getRT(), orig)
+    TEST_EQUAL(window[i].size(), 10)
+    TEST_REAL_SIMILAR(window[i][3].getMZ(), 103.0)
+    TEST_REAL_SIMILAR(window[i][3].getIntensity(), orig * 10.0 + 3)
+  }
+
+  // read all spectra
+  MSExperiment exp;
+  handler.readExperiment(exp);
+  TEST_EQUAL(exp.size(), 250)
+  ABORT_IF(exp.size() != 250)
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    TEST_EQUAL(exp[i].getNativeID(), "scan=" + String(i))
+    TEST_EQUAL(exp[i].size(), 10)
+    TEST_REAL_SIMILAR(exp[i][9].getIntensity(), i * 10.0 + 9)
+  }
+}
+END_SECTION
+
 START_SECTION(void writeExperiment(const MSExperiment & exp))
 {
   const MSExperiment exp_orig = [](){
@@ -665,6 +766,53 @@ START_SECTION(void writeChromatograms(const std::vector<MSChromatogram>& chroms)
 }
 END_SECTION
 
+START_SECTION([EXTRA] void setConfig(bool write_full_meta, bool use_lossy_compression, double linear_abs_mass_acc, int sql_batch_size = 500, bool durable_write = true))
+{
+  MSExperiment exp_orig;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("MzMLSqliteHandler_1.mzML"), exp_orig);
+
+  // native ids are stored verbatim (no SQL escaping needed)
+  exp_orig.getSpectra()[1].setNativeID("spectrum='2'");
+  exp_orig.getChromatograms()[0].setNativeID("chrom 'a'");
+
+  std::string tmp_filename;
+  NEW_TMP_FILE(tmp_filename);
+
+  TOLERANCE_RELATIVE(1+1e-5)
+  {
+    MzMLSqliteHandler handler(tmp_filename, 12345);
+    // small batches, non-durable writes (meta data is read from the SQL tables)
+    handler.setConfig(false, false, 0.0001, 1, false);
+    handler.createTables();
+    handler.writeExperiment(exp_orig);
+    handler.writeSpectra(exp_orig.getSpectra());
+
+    TEST_EQUAL(handler.getNrSpectra(), 4)
+    TEST_EQUAL(handler.getNrChromatograms(), 1)
+
+    MSExperiment tmp;
+    handler.readExperiment(tmp, false);
+    TEST_EQUAL(tmp.getNrSpectra(), 4)
+    ABORT_IF(tmp.getNrSpectra() != 4)
+    TEST_EQUAL(tmp.getNrChromatograms(), 1)
+    ABORT_IF(tmp.getNrChromatograms() != 1)
+    for (Size i = 0; i < tmp.getNrSpectra(); ++i)
+    {
+      const MSSpectrum& orig = exp_orig.getSpectra()[i % 2];
+      TEST_EQUAL(tmp[i].getNativeID(), orig.getNativeID())
+      TEST_EQUAL(tmp[i].size(), orig.size())
+      TEST_REAL_SIMILAR(tmp[i].getRT(), orig.getRT())
+      TEST_REAL_SIMILAR(tmp[i][100].getMZ(), orig[100].getMZ())
+      TEST_REAL_SIMILAR(tmp[i][100].getIntensity(), orig[100].getIntensity())
+    }
+    TEST_EQUAL(tmp.getChromatograms()[0].getNativeID(), "chrom 'a'")
+    TEST_EQUAL(tmp.getChromatograms()[0].size(), 48)
+    TEST_REAL_SIMILAR(tmp.getChromatograms()[0][20].getRT(), 0.200695)
+    TEST_REAL_SIMILAR(tmp.getChromatograms()[0][20].getIntensity(), 147414.578125)
+  }
+}
+END_SECTION
+
 // reset error tolerances to default values
 TOLERANCE_ABSOLUTE(1e-5)
 TOLERANCE_RELATIVE(1+1e-5)
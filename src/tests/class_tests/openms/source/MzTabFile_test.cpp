@@ -52,6 +52,11 @@ class MzTabFile2 : public MzTabFile
       size_t n_columns = 0;
       return generateMzTabSectionRow_(row, optional_columns, meta, n_columns);
     }
+
+    static Size getRowBlockSize()
+    {
+      return row_block_size_;
+    }
 };
 
 START_TEST(MzTabFile, "$Id$")
@@ -122,6 +127,44 @@ START_SECTION(void store(const String& filename, MzTab& mzTab) )
 }
 END_SECTION
 
+START_SECTION([EXTRA] void store(const String& filename, MzTab& mzTab) with more rows than fit into one block)
+{
+  MzTab mzTab;
+  MzTabFile().load(OPENMS_GET_TEST_DATA_PATH("MzTabFile_labelfree.mzTab"), mzTab);
+  MzTabPSMSectionRows psm_rows = mzTab.getPSMSectionRows();
+  TEST_EQUAL(psm_rows.empty(), false)
+
+  // replicate the PSMs, so that the section is written in several blocks
+  const Size n_rows = 2 * MzTabFile2::getRowBlockSize() + 17;
+  MzTabPSMSectionRows many_rows;
+  many_rows.reserve(n_rows);
+  for (Size i = 0; i < n_rows; ++i)
+  {
+    many_rows.push_back(psm_rows[i % psm_rows.size()]);
+    many_rows.back().PSM_ID.set(int(i));
+  }
+  mzTab.setPSMSectionRows(many_rows);
+
+  String stored_mzTab;
+  NEW_TMP_FILE(stored_mzTab)
+  MzTabFile().store(stored_mzTab, mzTab);
+
+  // rows are written in their original order
+  MzTab reloaded;
+  MzTabFile().load(stored_mzTab, reloaded);
+  const MzTabPSMSectionRows& reloaded_rows = reloaded.getPSMSectionRows();
+  TEST_EQUAL(reloaded_rows.size(), n_rows)
+  bool same_order = true;
+  for (Size i = 0; i < reloaded_rows.size(); ++i)
+  {
+    same_order &= (reloaded_rows[i].PSM_ID.get() == int(i));
+  }
+  TEST_EQUAL(same_order, true)
+  TEST_EQUAL(reloaded.getPeptideSectionRows().size(), mzTab.getPeptideSectionRows().size())
+  TEST_EQUAL(reloaded.getProteinSectionRows().size(), mzTab.getProteinSectionRows().size())
+}
+END_SECTION
+
 START_SECTION(~MzTabFile())
 {
   delete ptr;
@@ -150,6 +150,41 @@ START_SECTION(static std::vector<OPXLDataStructs::XLPrecursor> enumerateCrossLin
 
 END_SECTION
 
+START_SECTION(static void enumerateCrossLinksAndMasses(const std::vector<OPXLDataStructs::AASeqWithMass>& peptides, double cross_link_mass_light, const DoubleList& cross_link_mass_mono_link, const StringList& cross_link_residue1, const StringList& cross_link_residue2, const std::vector< double >& spectrum_precursors, double precursor_mass_tolerance, bool precursor_mass_tolerance_unit_ppm, Size batch_size, const std::function<void(std::vector<OPXLDataStructs::XLPrecursor>&, std::vector< int >&)>& consumer))
+
+  std::vector< int > all_positions;
+  std::vector<OPXLDataStructs::XLPrecursor> all_precursors = OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, all_positions, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm);
+
+  std::vector<OPXLDataStructs::XLPrecursor> batched_precursors;
+  std::vector< int > batched_positions;
+  Size num_batches = 0;
+  Size max_batch_size = 0;
+  OPXLHelper::enumerateCrossLinksAndMasses(peptides, cross_link_mass, cross_link_mass_mono_link, cross_link_residue1, cross_link_residue2, spectrum_precursors, precursor_mass_tolerance, precursor_mass_tolerance_unit_ppm, 1000,
+    [&](std::vector<OPXLDataStructs::XLPrecursor>& batch, std::vector< int >& positions)
+    {
+      ++num_batches;
+      max_batch_size = std::max(max_batch_size, batch.size());
+      batched_precursors.insert(batched_precursors.end(), batch.begin(), batch.end());
+      batched_positions.insert(batched_positions.end(), positions.begin(), positions.end());
+    });
+
+  TEST_EQUAL(batched_precursors.size(), 9604)
+  TEST_EQUAL(batched_positions.size(), 9604)
+  TEST_EQUAL(num_batches >= 10, true)
+  TEST_EQUAL(max_batch_size <= 1000, true)
+
+  // same candidates in the same order
+  bool same_order = true;
+  for (Size i = 0; i < batched_precursors.size(); ++i)
+  {
+    same_order &= all_precursors[i].alpha_index == batched_precursors[i].alpha_index &&
+                  all_precursors[i].beta_index == batched_precursors[i].beta_index &&
+                  all_positions[i] == batched_positions[i];
+  }
+  TEST_EQUAL(same_order, true)
+
+END_SECTION
+
 // building more data structures required in the following test
 std::cout << std::endl;
 std::vector< int > spectrum_precursor_correction_positions;
@@ -137,6 +137,19 @@ START_SECTION(( bool openFile(const String& filename, bool skipMetaData = false)
 }
 END_SECTION
 
+START_SECTION((bool isMemoryMapped() const))
+{
+  OnDiscPeakMap tmp;
+  TEST_EQUAL(tmp.isMemoryMapped(), false)
+  tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
+  TEST_EQUAL(tmp.isMemoryMapped(), true)
+
+  OnDiscPeakMap tmp2(tmp);
+  TEST_EQUAL(tmp2.isMemoryMapped(), true)
+  TEST_EQUAL(tmp2.getSpectrum(0).size(), tmp.getSpectrum(0).size())
+}
+END_SECTION
+
 START_SECTION((bool isSortedByRT() const))
 {
   OnDiscPeakMap tmp; tmp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"));
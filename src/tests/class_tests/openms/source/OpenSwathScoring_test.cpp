@@ -119,7 +119,7 @@ START_SECTION((void getNormalized_library_intensities_(const std::vector<Transit
 }
 END_SECTION
 
-START_SECTION((OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::vector<OpenSwath::SwathMap> swath_maps,
+START_SECTION((OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(const std::vector<OpenSwath::SwathMap>& swath_maps,
                                                               double RT, int nr_spectra_to_add, double drift_lower, drift_upper)))
 {
   // test result for empty map
@@ -273,6 +273,97 @@ START_SECTION((OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::
 }
 END_SECTION
 
+START_SECTION((void setSpectrumCache(boost::shared_ptr<OpenSwathSpectrumCache> cache)))
+{
+  PeakMap* eptr = new PeakMap;
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum s;
+    s.emplace_back(20.0 + i * 0.001, 100.0 * (i + 1));
+    s.setRT(10.0 * (i + 1));
+    eptr->addSpectrum(s);
+  }
+  boost::shared_ptr<PeakMap > swath_map (eptr);
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+
+  OpenSwath_Scores_Usage su;
+  OpenSwathScoring sc_plain;
+  sc_plain.initialize(1.0, 1, 0.005, 0.0, su, "simple");
+  OpenSwathScoring sc;
+  sc.initialize(1.0, 1, 0.005, 0.0, su, "simple");
+  boost::shared_ptr<OpenSwathSpectrumCache> cache(new OpenSwathSpectrumCache());
+  sc.setSpectrumCache(cache);
+
+  OpenSwath::SpectrumPtr expected = sc_plain.fetchSpectrumSwath(swath_ptr, 31.0, 3, 0, 0);
+  OpenSwath::SpectrumPtr sp = sc.fetchSpectrumSwath(swath_ptr, 31.0, 3, 0, 0);
+  TEST_EQUAL(cache->size(), 1)
+  TEST_EQUAL(sp->getMZArray()->data == expected->getMZArray()->data, true)
+  TEST_EQUAL(sp->getIntensityArray()->data == expected->getIntensityArray()->data, true)
+
+  // a different RT with the same closest spectrum is served from the cache
+  OpenSwath::SpectrumPtr sp2 = sc.fetchSpectrumSwath(swath_ptr, 29.0, 3, 0, 0);
+  TEST_EQUAL(sp2 == sp, true)
+  TEST_EQUAL(cache->size(), 1)
+
+  // a different window is not
+  sp2 = sc.fetchSpectrumSwath(swath_ptr, 31.0, 5, 0, 0);
+  TEST_EQUAL(sp2 == sp, false)
+  TEST_EQUAL(sp2->getMZArray()->data.size(), 5)
+  TEST_EQUAL(cache->size(), 2)
+
+  // the cache can be shared between several scoring objects
+  OpenSwathScoring sc_other;
+  sc_other.initialize(1.0, 1, 0.005, 0.0, su, "simple");
+  sc_other.setSpectrumCache(cache);
+  TEST_EQUAL(sc_other.fetchSpectrumSwath(swath_ptr, 30.0, 3, 0, 0) == sp, true)
+
+  std::vector<OpenSwath::SwathMap> swath_maps(1);
+  swath_maps[0].sptr = swath_ptr;
+  TEST_EQUAL(sc.fetchSpectrumSwath(swath_maps, 30.0, 3, 0, 0) == sp, true)
+}
+END_SECTION
+
+START_SECTION((OpenSwathSpectrumCache))
+{
+  PeakMap* eptr = new PeakMap;
+  MSSpectrum s;
+  s.emplace_back(20.0, 200.0);
+  s.setRT(10.0);
+  eptr->addSpectrum(s);
+  boost::shared_ptr<PeakMap > swath_map (eptr);
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+
+  OpenSwathSpectrumCache cache(2);
+  TEST_EQUAL(cache.size(), 0)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 1, 0, 0) == nullptr, true)
+
+  OpenSwath::SpectrumPtr sp0(new OpenSwath::Spectrum);
+  OpenSwath::SpectrumPtr sp1(new OpenSwath::Spectrum);
+  OpenSwath::SpectrumPtr sp2(new OpenSwath::Spectrum);
+  cache.insert(swath_ptr, 0, 1, 0, 0, sp0);
+  cache.insert(swath_ptr, 1, 1, 0, 0, sp1);
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 1, 0, 0) == sp0, true)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 3, 0, 0) == nullptr, true)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 1, 1.0, 2.0) == nullptr, true)
+
+  // spectrum 1 is the least recently used one and gets evicted
+  cache.insert(swath_ptr, 2, 1, 0, 0, sp2);
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.get(swath_ptr, 1, 1, 0, 0) == nullptr, true)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 1, 0, 0) == sp0, true)
+  TEST_EQUAL(cache.get(swath_ptr, 2, 1, 0, 0) == sp2, true)
+
+  // entries of other maps are not returned
+  OpenSwath::SpectrumAccessPtr other_ptr = swath_ptr->lightClone();
+  TEST_EQUAL(cache.get(other_ptr, 0, 1, 0, 0) == nullptr, true)
+
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+  TEST_EQUAL(cache.get(swath_ptr, 0, 1, 0, 0) == nullptr, true)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
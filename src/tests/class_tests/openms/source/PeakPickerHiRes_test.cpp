@@ -35,6 +35,8 @@
 #include <OpenMS/CONCEPT/ClassTest.h>
 #include <OpenMS/test_config.h>
 #include <OpenMS/FORMAT/MzMLFile.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/KERNEL/OnDiscMSExperiment.h>
 
 ///////////////////////////
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
@@ -574,4 +576,63 @@ START_SECTION(void pick(const MSSpectrum& input, MSSpectrum& output, std::vector
 }
 END_SECTION
 
+/////////////////////////
+// on-disc input tests //
+/////////////////////////
+
+PeakMap on_disc_ref;
+{
+  PeakMap tmp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML"), tmp);
+  PeakPickerHiRes pp_on_disc;
+  pp_on_disc.pickExperiment(tmp, on_disc_ref, false);
+}
+
+START_SECTION(void pickExperiment(OnDiscMSExperiment& input, PeakMap& output, const bool check_spectrum_type = true) const)
+{
+  OnDiscPeakMap on_disc_exp;
+  TEST_EQUAL(on_disc_exp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML")), true)
+
+  PeakPickerHiRes pp_on_disc;
+  PeakMap tmp_exp;
+  pp_on_disc.pickExperiment(on_disc_exp, tmp_exp, false);
+
+  TEST_EQUAL(tmp_exp.size(), on_disc_ref.size())
+  TEST_EQUAL(tmp_exp.getChromatograms().size(), on_disc_ref.getChromatograms().size())
+  ABORT_IF(tmp_exp.size() != on_disc_ref.size())
+  for (Size scan_idx = 0; scan_idx < tmp_exp.size(); ++scan_idx)
+  {
+    TEST_EQUAL(tmp_exp[scan_idx].size(), on_disc_ref[scan_idx].size())
+    TEST_EQUAL(tmp_exp[scan_idx].getNativeID(), on_disc_ref[scan_idx].getNativeID())
+  }
+}
+END_SECTION
+
+START_SECTION(void pickExperiment(OnDiscMSExperiment& input, Interfaces::IMSDataConsumer& consumer, const bool check_spectrum_type = true) const)
+{
+  OnDiscPeakMap on_disc_exp;
+  TEST_EQUAL(on_disc_exp.openFile(OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML")), true)
+
+  PeakPickerHiRes pp_on_disc;
+  MSDataStoringConsumer consumer;
+  pp_on_disc.pickExperiment(on_disc_exp, consumer, false);
+  const PeakMap& tmp_exp = consumer.getData();
+
+  // spectra are consumed in their original order
+  TEST_EQUAL(tmp_exp.size(), on_disc_ref.size())
+  TEST_EQUAL(tmp_exp.getChromatograms().size(), on_disc_ref.getChromatograms().size())
+  ABORT_IF(tmp_exp.size() != on_disc_ref.size())
+  for (Size scan_idx = 0; scan_idx < tmp_exp.size(); ++scan_idx)
+  {
+    TEST_EQUAL(tmp_exp[scan_idx].getNativeID(), on_disc_ref[scan_idx].getNativeID())
+    TEST_EQUAL(tmp_exp[scan_idx].size(), on_disc_ref[scan_idx].size())
+    for (Size peak_idx = 0; peak_idx < tmp_exp[scan_idx].size(); ++peak_idx)
+    {
+      TEST_REAL_SIMILAR(tmp_exp[scan_idx][peak_idx].getMZ(), on_disc_ref[scan_idx][peak_idx].getMZ())
+      TEST_REAL_SIMILAR(tmp_exp[scan_idx][peak_idx].getIntensity(), on_disc_ref[scan_idx][peak_idx].getIntensity())
+    }
+  }
+}
+END_SECTION
+
 END_TEST
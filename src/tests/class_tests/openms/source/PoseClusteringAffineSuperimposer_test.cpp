@@ -181,6 +181,36 @@ START_SECTION((virtual void run(const std::vector<Peak2D> & map_model, const std
   TEST_EQUAL(parameters.size(), 2)
   TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
   TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+
+  // crowd the m/z windows of both partners with weak elements: without a cap
+  // on the pair candidates, windows of 10 or more elements are skipped and no
+  // pair votes at all; with a cap of 1 only the (intense) partners are paired
+  for (Size d = 0; d < 10; ++d)
+  {
+    Peak2D weak;
+    weak.setRT(1.5 + 0.35 * d);
+    weak.setIntensity(1.0f);
+    weak.setMZ(0.8 + 0.04 * d);
+    map_scene.push_back(weak);
+    weak.setMZ(4.8 + 0.04 * d);
+    map_scene.push_back(weak);
+  }
+  parameters = pcat.getParameters();
+  parameters.setValue("max_pair_candidates", 1);
+  pcat.setParameters(parameters);
+
+  pcat.run(map_model, map_scene, transformation);
+
+  TEST_STRING_EQUAL(transformation.getModelType(), "linear")
+  parameters = transformation.getModelParameters();
+  TEST_REAL_SIMILAR(parameters.getValue("slope"), 1.0)
+  TEST_REAL_SIMILAR(parameters.getValue("intercept"), -0.4)
+
+  // a cap of 0 is not allowed
+  parameters = pcat.getParameters();
+  parameters.setValue("max_pair_candidates", 0);
+  pcat.setParameters(parameters);
+  TEST_EXCEPTION(Exception::InvalidParameter, pcat.run(map_model, map_scene, transformation))
 }
 END_SECTION
 
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
 
 ///////////////////////////
 #include <OpenMS/ANALYSIS/ID/SimpleSearchEngineAlgorithm.h>
@@ -68,6 +69,47 @@ START_SECTION((ExitCodes search(const String &in_mzML, const String &in_db, std:
 }
 END_SECTION
 
+START_SECTION([EXTRA] search with fragment index)
+{
+  // same settings as the SimpleSearchEngine TOPP test
+  SimpleSearchEngineAlgorithm sse;
+  Param p = sse.getParameters();
+  p.setValue("precursor:mass_tolerance", 5.0);
+  p.setValue("fragment:mass_tolerance", 0.3);
+  p.setValue("fragment:mass_tolerance_unit", "Da");
+  p.setValue("modifications:fixed", std::vector<std::string>{});
+  sse.setParameters(p);
+
+  // input files of the TOPP test
+  const String mzml = OPENMS_GET_TEST_DATA_PATH("../../../topp/SimpleSearchEngine_1.mzML");
+  const String fasta = OPENMS_GET_TEST_DATA_PATH("../../../topp/SimpleSearchEngine_1.fasta");
+
+  vector<ProteinIdentification> prot_ids, index_prot_ids;
+  vector<PeptideIdentification> pep_ids, index_pep_ids;
+  sse.search(mzml, fasta, prot_ids, pep_ids);
+
+  p.setValue("fragment_index:enabled", "true");
+  sse.setParameters(p);
+  sse.search(mzml, fasta, index_prot_ids, index_pep_ids);
+
+  TEST_EQUAL(pep_ids.size(), 3)
+  TEST_EQUAL(index_pep_ids.size(), pep_ids.size())
+  ABORT_IF(index_pep_ids.size() != pep_ids.size())
+  for (Size i = 0; i < pep_ids.size(); ++i)
+  {
+    TEST_EQUAL(index_pep_ids[i].getMetaValue("scan_index"), pep_ids[i].getMetaValue("scan_index"))
+    TEST_EQUAL(index_pep_ids[i].getHits().size(), 1)
+    TEST_EQUAL(pep_ids[i].getHits().size(), 1)
+    ABORT_IF(index_pep_ids[i].getHits().empty() || pep_ids[i].getHits().empty())
+    TEST_EQUAL(index_pep_ids[i].getHits()[0].getSequence(), pep_ids[i].getHits()[0].getSequence())
+    TEST_REAL_SIMILAR(index_pep_ids[i].getHits()[0].getScore(), pep_ids[i].getHits()[0].getScore())
+  }
+  TEST_EQUAL(index_pep_ids[0].getHits()[0].getSequence().toString(), "DFASSGGYVLHLHR")
+  TEST_EQUAL(index_pep_ids[1].getHits()[0].getSequence().toString(), "IALSRPNVEVVALNDPFITNDYAAYM(Oxidation)FK")
+  TEST_EQUAL(index_pep_ids[2].getHits()[0].getSequence().toString(), "RPGADSDIGGFGGLFDLAQAGFR")
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
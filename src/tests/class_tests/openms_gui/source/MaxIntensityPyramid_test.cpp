@@ -0,0 +1,171 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2021.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// --------------------------------------------------------------------------
+// $Maintainer: Timo Sachsenberg $
+// $Authors: agent $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+
+///////////////////////////
+
+#include <OpenMS/VISUAL/MaxIntensityPyramid.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(MaxIntensityPyramid, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+// 8 MS1 spectra at RT 0..70 with peaks at m/z 100..170 and intensity rt_index * 10 + mz_index, one MS2 spectrum in between
+PeakMap exp;
+for (Size rt = 0; rt < 8; ++rt)
+{
+  MSSpectrum spec;
+  spec.setMSLevel(1);
+  spec.setRT(rt * 10.0);
+  for (Size mz = 0; mz < 8; ++mz)
+  {
+    spec.push_back(Peak1D(100.0 + mz * 10.0, rt * 10.0 + mz));
+  }
+  exp.addSpectrum(spec);
+  if (rt == 3)
+  {
+    MSSpectrum ms2;
+    ms2.setMSLevel(2);
+    ms2.setRT(rt * 10.0 + 5.0);
+    ms2.push_back(Peak1D(120.0, 1e6));
+    exp.addSpectrum(ms2);
+  }
+}
+
+MaxIntensityPyramid* ptr = nullptr;
+MaxIntensityPyramid* null_ptr = nullptr;
+START_SECTION(MaxIntensityPyramid())
+{
+  ptr = new MaxIntensityPyramid();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->getNumberOfLevels(), 0)
+}
+END_SECTION
+
+START_SECTION(~MaxIntensityPyramid())
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((MaxIntensityPyramid(const PeakMap& map, Size max_bins = 2048, Size min_bins = 64, const std::atomic<bool>* cancel = nullptr)))
+{
+  MaxIntensityPyramid empty_pyramid((PeakMap()));
+  TEST_EQUAL(empty_pyramid.empty(), true)
+
+  MaxIntensityPyramid pyramid(exp, 8, 2);
+  TEST_EQUAL(pyramid.empty(), false)
+  TEST_REAL_SIMILAR(pyramid.getRTMin(), 0.0)
+  TEST_REAL_SIMILAR(pyramid.getMZMin(), 100.0)
+  // 8 x 8, 4 x 4, 2 x 2 bins
+  TEST_EQUAL(pyramid.getNumberOfLevels(), 3)
+
+  const MaxIntensityPyramid::Level& finest = pyramid.getLevel(0);
+  TEST_EQUAL(finest.rt_bins, 8)
+  TEST_EQUAL(finest.mz_bins, 8)
+  TEST_REAL_SIMILAR(finest.rt_bin_size, 70.0 / 8)
+  TEST_REAL_SIMILAR(finest.mz_bin_size, 70.0 / 8)
+  // every bin contains exactly one peak; the MS2 peak is ignored
+  TEST_REAL_SIMILAR(finest.getMaxIntensity(0, 0), 0.0)
+  TEST_REAL_SIMILAR(finest.getMaxIntensity(3, 2), 32.0)
+  TEST_REAL_SIMILAR(finest.getMaxIntensity(7, 7), 77.0)
+
+  const MaxIntensityPyramid::Level& middle = pyramid.getLevel(1);
+  TEST_EQUAL(middle.rt_bins, 4)
+  TEST_EQUAL(middle.mz_bins, 4)
+  TEST_REAL_SIMILAR(middle.rt_bin_size, 70.0 / 4)
+  TEST_REAL_SIMILAR(middle.getMaxIntensity(0, 0), 11.0)
+  TEST_REAL_SIMILAR(middle.getMaxIntensity(1, 2), 35.0)
+
+  const MaxIntensityPyramid::Level& coarsest = pyramid.getLevel(2);
+  TEST_EQUAL(coarsest.rt_bins, 2)
+  TEST_EQUAL(coarsest.mz_bins, 2)
+  TEST_REAL_SIMILAR(coarsest.getMaxIntensity(1, 1), 77.0)
+  TEST_REAL_SIMILAR(coarsest.getMaxIntensity(0, 1), 37.0)
+
+  // fewer MS1 spectra than bins: one RT bin per spectrum at most; empty bins are negative
+  PeakMap sparse;
+  for (Size rt = 0; rt < 2; ++rt)
+  {
+    MSSpectrum spec;
+    spec.setMSLevel(1);
+    spec.setRT(rt * 10.0);
+    spec.push_back(Peak1D(100.0, 5.0));
+    spec.push_back(Peak1D(200.0, 7.0));
+    sparse.addSpectrum(spec);
+  }
+  MaxIntensityPyramid sparse_pyramid(sparse, 4, 1);
+  TEST_EQUAL(sparse_pyramid.getLevel(0).rt_bins, 2)
+  TEST_EQUAL(sparse_pyramid.getLevel(0).mz_bins, 4)
+  TEST_EQUAL(sparse_pyramid.getLevel(0).getMaxIntensity(0, 1) < 0.0, true)
+  TEST_REAL_SIMILAR(sparse_pyramid.getLevel(0).getMaxIntensity(1, 3), 7.0)
+  TEST_EQUAL(sparse_pyramid.getNumberOfLevels(), 3)
+  TEST_REAL_SIMILAR(sparse_pyramid.getLevel(2).getMaxIntensity(0, 0), 7.0)
+
+  // cancelled builds leave the pyramid empty
+  std::atomic<bool> cancel(false);
+  MaxIntensityPyramid not_cancelled(exp, 8, 2, &cancel);
+  TEST_EQUAL(not_cancelled.getNumberOfLevels(), 3)
+  cancel = true;
+  MaxIntensityPyramid cancelled(exp, 8, 2, &cancel);
+  TEST_EQUAL(cancelled.empty(), true)
+  TEST_EQUAL(cancelled.getNumberOfLevels(), 0)
+}
+END_SECTION
+
+START_SECTION((const Level* findLevel(double rt_size, double mz_size) const))
+{
+  MaxIntensityPyramid pyramid(exp, 8, 2);
+  TEST_EQUAL(pyramid.findLevel(1.0, 1.0) == nullptr, true)
+  TEST_EQUAL(pyramid.findLevel(10.0, 1.0) == nullptr, true)
+  TEST_EQUAL(pyramid.findLevel(10.0, 10.0) == &pyramid.getLevel(0), true)
+  TEST_EQUAL(pyramid.findLevel(20.0, 10.0) == &pyramid.getLevel(0), true)
+  TEST_EQUAL(pyramid.findLevel(20.0, 20.0) == &pyramid.getLevel(1), true)
+  TEST_EQUAL(pyramid.findLevel(1000.0, 1000.0) == &pyramid.getLevel(2), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST